@@ -0,0 +1,153 @@
+#include "../src/dataModel.h"
+#include "../src/pathFinding.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define GRID_SIZE    400
+#define NUM_SEARCHES 8
+
+static float frand(float max)
+{
+	return ((float)rand() / (float)RAND_MAX) * max;
+}
+
+/**
+ * @brief Builds the graph with current junction indexes and times Dijkstra searches
+ * from fixed starting points
+ * 
+ * @param name Name of the numbering
+ * @param roads Roads array
+ * @param numRoads Number of roads
+ * @param starts Starting points array
+ * @return double Total search time in seconds
+ */
+static double benchSearches(const char * name, line_t * const * roads, size_t numRoads, const point_t * const * starts)
+{
+	roadGraph_t g;
+	if (!pf_createGraph(roads, numRoads, starts, NUM_SEARCHES, &g))
+	{
+		fprintf(stderr, "Graph creation failed!\n");
+		exit(1);
+	}
+
+	prevDist_t * distances = NULL;
+	double checksum = 0.0;
+	const clock_t startTime = clock();
+	for (size_t i = 0; i < NUM_SEARCHES; ++i)
+	{
+		if (!pf_dijkstraSearch(&g, starts[i], &distances))
+		{
+			fprintf(stderr, "Search failed!\n");
+			exit(1);
+		}
+		for (size_t j = 0; j < g.numNodes; ++j)
+		{
+			checksum += (double)distances[j].dist;
+		}
+	}
+	const double elapsed = (double)(clock() - startTime) / (double)CLOCKS_PER_SEC;
+
+	printf("%-12s %zu nodes, %d searches: %.3f s (checksum %.0f)\n", name, g.numNodes, NUM_SEARCHES, elapsed, checksum);
+
+	free(distances);
+	pf_destroyGraph(&g);
+	return elapsed;
+}
+
+int main(void)
+{
+	srand(1);
+
+	// Juhuslikult nihutatud ruudustik, igal ristmikul on kuni 4 naabrit
+	const size_t numPoints = GRID_SIZE * GRID_SIZE;
+	point_t * points = malloc(sizeof(point_t) * numPoints);
+	line_t * lines   = malloc(sizeof(line_t) * 2 * numPoints);
+	line_t ** roads  = malloc(sizeof(line_t *) * 2 * numPoints);
+	if ((points == NULL) || (lines == NULL) || (roads == NULL))
+	{
+		return 1;
+	}
+
+	dataModel_t dm = { .junctions = NULL, .numJunctions = 0, .maxJunctions = 0 };
+	hashMapOA_zero(&dm.junctionMap);
+	if (!hashMapOA_init(&dm.junctionMap, numPoints))
+	{
+		return 1;
+	}
+	for (size_t i = 0; i < numPoints; ++i)
+	{
+		char id[32];
+		sprintf(id, "j%zu", i);
+		points[i] = (point_t){ .x = (float)(i % GRID_SIZE) * 10.0f + frand(6.0f), .y = (float)(i / GRID_SIZE) * 10.0f + frand(6.0f) };
+		if (!iniString_init(&points[i].id, id, -1) || !hashMapOA_insert(&dm.junctionMap, points[i].id.str, &points[i]))
+		{
+			return 1;
+		}
+	}
+	size_t numRoads = 0;
+	for (size_t i = 0; i < numPoints; ++i)
+	{
+		const size_t x = i % GRID_SIZE, y = i / GRID_SIZE;
+		if ((x + 1) < GRID_SIZE)
+		{
+			lines[numRoads] = (line_t){ .src = &points[i], .dst = &points[i + 1], .cost = 1.0f };
+			roads[numRoads] = &lines[numRoads];
+			++numRoads;
+		}
+		if ((y + 1) < GRID_SIZE)
+		{
+			lines[numRoads] = (line_t){ .src = &points[i], .dst = &points[i + GRID_SIZE], .cost = 1.0f };
+			roads[numRoads] = &lines[numRoads];
+			++numRoads;
+		}
+	}
+	const point_t * starts[NUM_SEARCHES];
+	for (size_t i = 0; i < NUM_SEARCHES; ++i)
+	{
+		starts[i] = &points[(size_t)rand() % numPoints];
+	}
+
+	// Vana nummerdus: räsitabeli pesade järjekord, ristmike massiiv on samas järjekorras
+	dm.junctions = malloc(sizeof(point_t *) * numPoints);
+	if (dm.junctions == NULL)
+	{
+		return 1;
+	}
+	size_t idx = 0;
+	for (size_t i = 0; i < dm.junctionMap.numSlots; ++i)
+	{
+		const hashEntryOA_t * entry = &dm.junctionMap.entries[i];
+		if (entry->dist != 0)
+		{
+			dm.junctions[idx] = entry->value;
+			dm.junctions[idx]->idx = idx;
+			++idx;
+		}
+	}
+	dm.numJunctions = idx;
+	dm.maxJunctions = numPoints;
+	const double hashTime = benchSearches("hash order", roads, numRoads, starts);
+
+	// Uus nummerdus: Hilberti kõvera järjekord
+	if (!dm_updateJunctionIndexes(&dm))
+	{
+		return 1;
+	}
+	const double hilbertTime = benchSearches("hilbert", roads, numRoads, starts);
+
+	printf("Speedup: %.2fx\n", hashTime / hilbertTime);
+
+	for (size_t i = 0; i < numPoints; ++i)
+	{
+		iniString_destroy(&points[i].id);
+	}
+	hashMapOA_destroy(&dm.junctionMap);
+	free(dm.junctions);
+	free(roads);
+	free(lines);
+	free(points);
+
+	return 0;
+}
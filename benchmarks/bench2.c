@@ -0,0 +1,57 @@
+#include "../src/mathHelper.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define NUM_NUMBERS 2000000
+#define NUM_ROUNDS  5
+
+int main(void)
+{
+	srand(1);
+
+	// Kaartide koordinaatide ja hindade sarnased arvud ühes puhvris
+	char * buf = malloc(NUM_NUMBERS * 24);
+	char ** strs = malloc(sizeof(char *) * NUM_NUMBERS);
+	if ((buf == NULL) || (strs == NULL))
+	{
+		return 1;
+	}
+	size_t len = 0;
+	for (size_t i = 0; i < NUM_NUMBERS; ++i)
+	{
+		strs[i] = buf + len;
+		const double value = ((double)rand() / (double)RAND_MAX) * 100000.0 - 50000.0;
+		len += (size_t)sprintf(buf + len, (i % 4) ? "%.3f" : "%.6g", value) + 1;
+	}
+
+	double checksum1 = 0.0, checksum2 = 0.0, time1 = 0.0, time2 = 0.0;
+	for (size_t r = 0; r < NUM_ROUNDS; ++r)
+	{
+		clock_t start = clock();
+		for (size_t i = 0; i < NUM_NUMBERS; ++i)
+		{
+			checksum1 += (double)strtof(strs[i], NULL);
+		}
+		time1 += (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+
+		start = clock();
+		for (size_t i = 0; i < NUM_NUMBERS; ++i)
+		{
+			checksum2 += (double)mh_strtof(strs[i], NULL);
+		}
+		time2 += (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+	}
+
+	const double mbytes = (double)len * NUM_ROUNDS / 1e6;
+	printf("strtof     %.3f s, %.1f MB/s, %.1f M numbers/s (checksum %.3f)\n", time1, mbytes / time1, NUM_NUMBERS * NUM_ROUNDS / time1 / 1e6, checksum1);
+	printf("mh_strtof  %.3f s, %.1f MB/s, %.1f M numbers/s (checksum %.3f)\n", time2, mbytes / time2, NUM_NUMBERS * NUM_ROUNDS / time2 / 1e6, checksum2);
+	printf("Speedup: %.2fx\n", time1 / time2);
+
+	free(strs);
+	free(buf);
+
+	return (checksum1 == checksum2) ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+#include "../src/iniFile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define GRID_SIZE  400
+#define NUM_ROUNDS 10
+
+static bool countEntries(void * userData, const iniString_t * section, const iniString_t * key, const iniString_t * value)
+{
+	(void)section;
+	size_t * num = userData;
+	*num += (key != NULL) ? key->len + value->len : 1;
+	return true;
+}
+
+int main(void)
+{
+	// Kaardifailiga sarnane ristmike ja teede võrk koos kommentaaride ja jutumärkidega
+	char * buf = malloc((size_t)GRID_SIZE * GRID_SIZE * 128);
+	if (buf == NULL)
+	{
+		return 1;
+	}
+	size_t len = (size_t)sprintf(buf, "; ruudustik\n[ristmikud]\n");
+	for (int y = 0; y < GRID_SIZE; ++y)
+	{
+		for (int x = 0; x < GRID_SIZE; ++x)
+		{
+			len += (size_t)sprintf(buf + len, "j%d_%d = %d.25, %d.75\n", y, x, x * 3, y * 3);
+		}
+	}
+	len += (size_t)sprintf(buf + len, "\n[teed]\n");
+	for (int y = 0; y < GRID_SIZE; ++y)
+	{
+		for (int x = 0; (x + 1) < GRID_SIZE; ++x)
+		{
+			len += (size_t)sprintf(buf + len, "h%d_%d = j%d_%d,j%d_%d ; horisontaalne\n", y, x, y, x, y, x + 1);
+			len += (size_t)sprintf(buf + len, "v%d_%d = \"j%d_%d,j%d_%d,%d.5\"\n", x, y, x, y, x + 1, y, 1 + (x % 4));
+		}
+	}
+
+	double time1 = 0.0, time2 = 0.0;
+	size_t checksum = 0;
+	iniErr_t code = inieOK;
+	for (size_t r = 0; r < NUM_ROUNDS; ++r)
+	{
+		clock_t start = clock();
+		code |= ini_checkData(buf, (intptr_t)len);
+		time1 += (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+
+		iniReader_t reader;
+		start = clock();
+		code |= iniReader_initData(&reader, buf, (intptr_t)len, &countEntries, &checksum);
+		time2 += (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+		iniReader_destroy(&reader);
+	}
+
+	const double mbytes = (double)len * NUM_ROUNDS / 1e6;
+	printf("ini_checkData      %.3f s, %.1f MB/s\n", time1, mbytes / time1);
+	printf("iniReader_initData %.3f s, %.1f MB/s (checksum %zu)\n", time2, mbytes / time2, checksum);
+
+	free(buf);
+
+	return (code == inieOK) ? 0 : 1;
+}
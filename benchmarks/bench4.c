@@ -0,0 +1,72 @@
+#include "../src/hashmap.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define NUM_KEYS 2000000
+#define KEY_SIZE 16
+
+static double now(void)
+{
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Inserts all keys to a chained hashmap growing from one slot and times the
+ * total and the slowest single insert
+ *
+ * @param name Name of the resizing mode
+ * @param keys Keys array
+ * @param incremental Whether to rehash incrementally
+ */
+static void benchInserts(const char * name, const char * keys, bool incremental)
+{
+	hashMapCK_t map;
+	if (!hashMapCK_init(&map, 1))
+	{
+		fprintf(stderr, "Map init failed!\n");
+		exit(1);
+	}
+	hashMapCK_setIncremental(&map, incremental);
+
+	double worst = 0.0;
+	const double startTime = now();
+	for (size_t i = 0; i < NUM_KEYS; ++i)
+	{
+		const double t = now();
+		if (!hashMapCK_insert(&map, &keys[i * KEY_SIZE], NULL))
+		{
+			fprintf(stderr, "Inserting failed!\n");
+			exit(1);
+		}
+		const double elapsed = now() - t;
+		worst = (elapsed > worst) ? elapsed : worst;
+	}
+	const double elapsed = now() - startTime;
+
+	printf("%-12s %d inserts: %.3f s, slowest insert %.3f ms\n", name, NUM_KEYS, elapsed, worst * 1e3);
+	hashMapCK_destroy(&map);
+}
+
+int main(void)
+{
+	char * keys = malloc((size_t)NUM_KEYS * KEY_SIZE);
+	if (keys == NULL)
+	{
+		return 1;
+	}
+	for (size_t i = 0; i < NUM_KEYS; ++i)
+	{
+		snprintf(&keys[i * KEY_SIZE], KEY_SIZE, "J%zu", i);
+	}
+
+	// Täielik ümberräsimine peatab lisamise korraga, inkrementaalne jaotab selle laiali
+	benchInserts("incremental", keys, true);
+	benchInserts("full", keys, false);
+
+	free(keys);
+	return 0;
+}
@@ -0,0 +1,85 @@
+#include "../src/hashmap.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define NUM_KEYS 200000
+#define KEY_SIZE 16
+#define NUM_PASSES 20
+
+static double now(void)
+{
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(void)
+{
+	char * keys = malloc((size_t)NUM_KEYS * KEY_SIZE);
+	const char ** keyps = malloc(sizeof(const char *) * NUM_KEYS);
+	if ((keys == NULL) || (keyps == NULL))
+	{
+		return 1;
+	}
+	for (size_t i = 0; i < NUM_KEYS; ++i)
+	{
+		snprintf(&keys[i * KEY_SIZE], KEY_SIZE, "J%zu", i);
+		keyps[i] = &keys[i * KEY_SIZE];
+	}
+
+	hashMapOA_t map;
+	hashMapPH_t perfect;
+	double t = now();
+	if (!hashMapOA_init(&map, NUM_KEYS))
+	{
+		return 1;
+	}
+	for (size_t i = 0; i < NUM_KEYS; ++i)
+	{
+		if (!hashMapOA_insert(&map, keyps[i], &keys[i * KEY_SIZE]))
+		{
+			return 1;
+		}
+	}
+	printf("open addressing build: %.3f s\n", now() - t);
+	t = now();
+	if (!hashMapPH_build(&perfect, keyps, NUM_KEYS))
+	{
+		fprintf(stderr, "Perfect hash building failed!\n");
+		return 1;
+	}
+	printf("perfect hash build:    %.3f s, %zu slots, %zu bytes\n", now() - t, perfect.numSlots,
+		sizeof(uint32_t) * (perfect.numBuckets + perfect.numSlots));
+
+	// Mõlemal juhul võrreldakse leitud võtit otsitavaga
+	size_t found = 0;
+	t = now();
+	for (size_t pass = 0; pass < NUM_PASSES; ++pass)
+	{
+		for (size_t i = 0; i < NUM_KEYS; ++i)
+		{
+			found += hashMapOA_get(&map, keyps[i]) != NULL;
+		}
+	}
+	printf("open addressing get:   %.3f s\n", now() - t);
+	t = now();
+	for (size_t pass = 0; pass < NUM_PASSES; ++pass)
+	{
+		for (size_t i = 0; i < NUM_KEYS; ++i)
+		{
+			const uint32_t idx = hashMapPH_get(&perfect, keyps[i], strlen(keyps[i]));
+			found += (idx != HASHMAPPH_EMPTY) && (strcmp(keyps[idx], keyps[i]) == 0);
+		}
+	}
+	printf("perfect hash get:      %.3f s\n", now() - t);
+	printf("found %zu of %d\n", found, 2 * NUM_PASSES * NUM_KEYS);
+
+	hashMapPH_destroy(&perfect);
+	hashMapOA_destroy(&map);
+	free(keyps);
+	free(keys);
+	return 0;
+}
@@ -0,0 +1,94 @@
+#include "arena.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+void arena_init(arena_t * restrict arena, size_t blockSize)
+{
+	assert(arena != NULL);
+
+	arena->head      = NULL;
+	arena->blockSize = (blockSize > ARENA_MIN_BLOCK) ? blockSize : ARENA_MIN_BLOCK;
+}
+void * arena_alloc(arena_t * restrict arena, size_t size)
+{
+	assert(arena != NULL);
+
+	// Suurus ümardatakse joonduse täisarvkordseks, nii on ka järgmine eraldus joondatud
+	const size_t align = _Alignof(max_align_t);
+	if (size > (SIZE_MAX - align))
+	{
+		return NULL;
+	}
+	size = (((size > 0) ? size : 1) + align - 1) / align * align;
+
+	arenaBlock_t * block = arena->head;
+	if ((block == NULL) || ((block->size - block->used) < size))
+	{
+		// Uus plokk on vähemalt kaks korda suurem eelmisest ning mahutab kindlasti soovitud eralduse
+		size_t blockSize = (block == NULL) ? arena->blockSize : block->size * 2;
+		if (blockSize < size)
+		{
+			blockSize = size;
+		}
+		if (blockSize > (SIZE_MAX - sizeof(arenaBlock_t)))
+		{
+			return NULL;
+		}
+
+		block = malloc(sizeof(arenaBlock_t) + blockSize);
+		if (block == NULL)
+		{
+			return NULL;
+		}
+		block->next = arena->head;
+		block->size = blockSize;
+		block->used = 0;
+		arena->head = block;
+	}
+
+	void * mem = (char *)block->data + block->used;
+	block->used += size;
+	return mem;
+}
+void arena_merge(arena_t * restrict arena, arena_t * restrict other)
+{
+	assert(arena != NULL);
+	assert(other != NULL);
+
+	if (other->head == NULL)
+	{
+		return;
+	}
+	else if (arena->head == NULL)
+	{
+		arena->head = other->head;
+		other->head = NULL;
+		return;
+	}
+
+	// Teise areeni plokid lisatakse kohe uusima ploki järele, nii jätkub eraldamine
+	// endiselt uusimast plokist
+	arenaBlock_t * tail = other->head;
+	while (tail->next != NULL)
+	{
+		tail = tail->next;
+	}
+	tail->next = arena->head->next;
+	arena->head->next = other->head;
+	other->head = NULL;
+}
+void arena_destroy(arena_t * restrict arena)
+{
+	assert(arena != NULL);
+
+	// Kõik plokid vabastatakse korraga, üksikuid eraldusi eraldi ei vabastata
+	for (arenaBlock_t * block = arena->head; block != NULL;)
+	{
+		arenaBlock_t * next = block->next;
+		free(block);
+		block = next;
+	}
+	arena->head = NULL;
+}
@@ -0,0 +1,73 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#define ARENA_MIN_BLOCK 4096
+
+/**
+ * @brief Single memory block of an arena, blocks form a singly linked list
+ * from the newest to the oldest
+ *
+ */
+typedef struct arenaBlock
+{
+	struct arenaBlock * next;
+	size_t size, used;
+
+	max_align_t data[];
+
+} arenaBlock_t;
+
+/**
+ * @brief Region allocator, allocation is a pointer bump in the newest block and
+ * all memory is released at once. Every new block is at least twice the size of
+ * the previous one, so n allocations need O(log n) calls to malloc.
+ *
+ */
+typedef struct arena
+{
+	arenaBlock_t * head;
+	size_t blockSize;
+
+} arena_t;
+
+
+/**
+ * @brief Initialises arena structure, no memory is allocated until the first
+ * allocation
+ *
+ * @param arena Pointer to arena structure
+ * @param blockSize Size of the first block in bytes, smaller sizes than ARENA_MIN_BLOCK
+ * are rounded up
+ */
+void arena_init(arena_t * restrict arena, size_t blockSize);
+/**
+ * @brief Allocates memory from the arena, memory is aligned for any object type
+ * and stays valid until the arena is destroyed. Complexity: O(1).
+ *
+ * @param arena Pointer to arena structure
+ * @param size Size of the allocation in bytes
+ * @return void* Pointer to allocated memory, NULL on failure
+ */
+void * arena_alloc(arena_t * restrict arena, size_t size);
+/**
+ * @brief Moves all memory of another arena to the arena, allocations from the other
+ * arena stay valid and are freed together with the arena. The other arena is left
+ * empty and usable. Complexity: O(number of blocks in the other arena).
+ *
+ * @param arena Pointer to arena structure receiving the memory
+ * @param other Pointer to arena structure giving away its memory
+ */
+void arena_merge(arena_t * restrict arena, arena_t * restrict other);
+/**
+ * @brief Destroys arena structure, frees all memory allocated from it at once,
+ * arena stays usable as if freshly initialised
+ *
+ * @param arena Pointer to arena structure
+ */
+void arena_destroy(arena_t * restrict arena);
+
+
+#endif
@@ -1,3 +1,9 @@
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+	// madvise fileHelper.c ja sysconf threadHelper.c jaoks, peab olema enne esimest süsteemi päist
+	#define _DEFAULT_SOURCE
+#endif
+
+#include "../arena.c"
 #include "../dataModel.c"
 #include "../fileHelper.c"
 #include "../hashmap.c"
@@ -7,4 +13,7 @@
 #include "../mathHelper.c"
 #include "../pathFinding.c"
 #include "../priorityQ.c"
+#include "../roadGrid.c"
 #include "../svgWriter.c"
+#include "../threadHelper.c"
+#include "../unionFind.c"
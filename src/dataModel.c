@@ -3,6 +3,10 @@
 #include "mathHelper.h"
 #include "pathFinding.h"
 #include "svgWriter.h"
+#include "roadGrid.h"
+#include "unionFind.h"
+#include "fileHelper.h"
+#include "threadHelper.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -13,29 +17,31 @@ void point_zero(point_t * restrict p)
 {
 	assert(p != NULL);
 	iniString_zero(&p->id);
+	p->internId = DM_NO_INTERN;
 }
-bool point_initStr(point_t * restrict p, const char * restrict idstr, const char * restrict valuestr)
+bool point_initStr(point_t * restrict p, const iniString_t * restrict id, const char * restrict valuestr)
 {
 	assert(p        != NULL);
+	assert(id       != NULL);
 	assert(valuestr != NULL);
 
-	if (!iniString_init(&p->id, idstr, -1))
-	{
-		return false;
-	}
+	// Id-d ei kopeerita, see viitab andmefaili sõnele
+	iniString_initView(&p->id, id);
+	p->internId = DM_NO_INTERN;
 
-	char * next = NULL;
-	p->x = strtof(valuestr, &next);
+	// Lokaadist sõltumatu teisendus, kümnendkoha eraldaja on alati punkt
+	const char * next = NULL;
+	p->x = mh_strtof(valuestr, &next);
 	// Toetab nii tühikutega kui ka komedega eraldatud ristkoordinaate
 	if (*next == ',')
 	{
 		++next;
 	}
-	p->y = strtof(next, NULL);
+	p->y = mh_strtof(next, NULL);
 
 	return true;
 }
-point_t * point_makeStr(const char * restrict idstr, const char * restrict valuestr)
+point_t * point_makeStr(const iniString_t * restrict id, const char * restrict valuestr)
 {
 	assert(valuestr != NULL);
 
@@ -44,7 +50,7 @@ point_t * point_makeStr(const char * restrict idstr, const char * restrict value
 	{
 		return NULL;
 	}
-	else if (!point_initStr(p, idstr, valuestr))
+	else if (!point_initStr(p, id, valuestr))
 	{
 		free(p);
 		return NULL;
@@ -78,86 +84,126 @@ void line_zero(line_t * restrict l)
 	l->length = 0.0f;
 	l->cost   = 1.0f;
 }
-bool line_initStr(
-	line_t * restrict l,
-	const hashMapCK_t * restrict pointmap,
-	const char * restrict idstr,
-	const char * restrict valuestr
-)
+/**
+ * @brief Road value string split in place to endpoint identifiers and cost, fields
+ * are views to the value string
+ * 
+ */
+typedef struct lineFields
 {
-	assert(l        != NULL);
-	assert(pointmap != NULL);
-	assert(valuestr != NULL);
+	const char * ids[2];
+	size_t lens[2];
+	float cost;
 
-	if (!iniString_init(&l->id, idstr, -1))
-	{
-		return false;
-	}
-	
+} lineFields_t;
+
+static inline bool s_line_tokenise(lineFields_t * restrict f, const char * restrict valuestr)
+{
 	// Toetab nii tavalisi ristmik->ristmik identifikaatoritega määratud teid, kui ka lisanduva "hinnaga" teid
 
-	char id1[MAX_ID], id2[MAX_ID], costStr[MAX_ID];
-	char * strs[] = { id1, id2, costStr };
-	bool found = false;
-	// prevStop tähistab eelmise sisseloetud väärtuse lõppu pärast koma ning vahetult enne järgmist "mitte-whitespace" märgnedit
-	size_t prevStop = 0, j = 0, len = strlen(valuestr);
-	for (size_t i = 0; (i < len) && (j < 3); ++i)
-	{
-		if (valuestr[i] == ',')
-		{
-			found = true;
-			memcpy(strs[j], &valuestr[prevStop], sizeof(char) * (i - prevStop));
-			strs[j][i - prevStop] = '\0';
-			++j;
-			++i;
-			while ((i < len) && ((valuestr[i] == ' ') || (valuestr[i] == '\t')))
-			{
-				++i;
-			}
-			prevStop = i;
+	// Väljad on vaated valuestr'i, koopiaid ei tehta ning välja pikkus pole piiratud
+	const char * fields[3] = { valuestr, NULL, NULL };
+	size_t lens[3] = { 0, 0, 0 };
+	// j tähistab praeguse välja indeksit, iga väli algab pärast koma ning
+	// vahetult enne järgmist "mitte-whitespace" märgendit
+	size_t j = 0;
+	const char * str = valuestr;
+	while ((*str != '\0') && (j < 3))
+	{
+		if (*str != ',')
+		{
+			++str;
+			continue;
+		}
+		lens[j] = (size_t)(str - fields[j]);
+		++j;
+		++str;
+		while ((*str == ' ') || (*str == '\t'))
+		{
+			++str;
+		}
+		if (j < 3)
+		{
+			fields[j] = str;
 		}
 	}
-	if (!found)
+	if (j == 0)
 	{
-		iniString_destroy(&l->id);
 		return false;
 	}
 	if (j < 3)
 	{
-		memcpy(strs[j], &valuestr[prevStop], sizeof(char) * (len - prevStop));
-		strs[j][len - prevStop] = '\0';
+		lens[j] = (size_t)(str - fields[j]);
 	}
-	l->cost = 1.0f;
+	f->cost = 1.0f;
 	if (j == 2)
 	{
-		l->cost = (float)atof(costStr);
-		if (l->cost == 0.0f)
+		// Arvu parsimine peatub hiljemalt välja lõpus oleval komal või null-terminaatoril
+		f->cost = mh_strtof(fields[2], NULL);
+		if (f->cost == 0.0f)
 		{
-			l->cost = 1.0f;
+			f->cost = 1.0f;
 		}
 	}
-
-	writeLogger("prevStop: %zu, id1: \"%s\", id2: \"%s\", cost: %f", prevStop, id1, id2, (double)l->cost);
-
-	const hashNodeCK_t * n1, * n2;
-	n1 = hashMapCK_get(pointmap, id1);
-	n2 = hashMapCK_get(pointmap, id2);
+	for (size_t i = 0; i < 2; ++i)
+	{
+		f->ids[i]  = fields[i];
+		f->lens[i] = lens[i];
+	}
+	return true;
+}
+static inline bool s_line_initFields(
+	line_t * restrict l,
+	const hashMapOA_t * restrict pointmap,
+	const iniString_t * restrict id,
+	const lineFields_t * restrict f
+)
+{
+	const hashEntryOA_t * n1, * n2;
+	n1 = hashMapOA_getLen(pointmap, f->ids[0], f->lens[0]);
+	n2 = hashMapOA_getLen(pointmap, f->ids[1], f->lens[1]);
 	if ((n1 == NULL) || (n2 == NULL))
 	{
-		iniString_destroy(&l->id);
 		return false;
 	}
 
-	l->src = n1->value;
-	l->dst = n2->value;
+	iniString_initView(&l->id, id);
+	l->src  = n1->value;
+	l->dst  = n2->value;
+	l->cost = f->cost;
 
 	line_calc(l);
 
 	return true;
 }
+bool line_initStr(
+	line_t * restrict l,
+	const hashMapOA_t * restrict pointmap,
+	const iniString_t * restrict id,
+	const char * restrict valuestr
+)
+{
+	assert(l        != NULL);
+	assert(pointmap != NULL);
+	assert(id       != NULL);
+	assert(valuestr != NULL);
+
+	lineFields_t f;
+	if (!s_line_tokenise(&f, valuestr))
+	{
+		return false;
+	}
+
+	writeLogger(
+		"id1: \"%.*s\", id2: \"%.*s\", cost: %f",
+		(int)f.lens[0], f.ids[0], (int)f.lens[1], f.ids[1], (double)f.cost
+	);
+
+	return s_line_initFields(l, pointmap, id, &f);
+}
 line_t * line_makeStr(
-	const hashMapCK_t * restrict pointmap,
-	const char * restrict idstr,
+	const hashMapOA_t * restrict pointmap,
+	const iniString_t * restrict id,
 	const char * restrict valuestr
 )
 {
@@ -169,7 +215,7 @@ line_t * line_makeStr(
 	{
 		return false;
 	}
-	else if (!line_initStr(mem, pointmap, idstr, valuestr))
+	else if (!line_initStr(mem, pointmap, id, valuestr))
 	{
 		free(mem);
 		return false;
@@ -179,22 +225,20 @@ line_t * line_makeStr(
 }
 bool line_init(
 	line_t * restrict l,
-	const char * restrict idstr,
+	const iniString_t * restrict id,
 	const point_t * restrict src,
 	const point_t * restrict dst,
 	float cost
 )
 {
 	assert(l    != NULL);
+	assert(id   != NULL);
 	assert(src  != NULL);
 	assert(dst  != NULL);
 	assert(src  != dst);
 	assert(cost != 0.0f);
 
-	if (!iniString_init(&l->id, idstr, -1))
-	{
-		return false;
-	}
+	iniString_initView(&l->id, id);
 	l->src  = src;
 	l->dst  = dst;
 	l->cost = cost;
@@ -203,7 +247,7 @@ bool line_init(
 	return true;
 }
 line_t * line_make(
-	const char * restrict idstr,
+	const iniString_t * restrict id,
 	const point_t * restrict src,
 	const point_t * restrict dst,
 	float cost
@@ -218,7 +262,7 @@ line_t * line_make(
 	{
 		return false;
 	}
-	else if (!line_init(mem, idstr, src, dst, cost))
+	else if (!line_init(mem, id, src, dst, cost))
 	{
 		free(mem);
 		return false;
@@ -301,204 +345,1365 @@ void line_setDest(line_t * restrict l, const point_t * restrict dst)
 	line_calc(l);
 }
 
-void line_destroy(line_t * restrict l)
+void line_destroy(line_t * restrict l)
+{
+	assert(l != NULL);
+	iniString_destroy(&l->id);
+}
+void line_free(line_t * restrict l)
+{
+	assert(l != NULL);
+	line_destroy(l);
+	free(l);
+}
+
+
+/**
+ * @brief Spatial hash of junctions, cell side is equal to the merging tolerance,
+ * so all candidates for merging are in the 3x3 cell neighbourhood
+ * 
+ */
+typedef struct dmCellHash
+{
+	float cellSize;
+	size_t * heads, mask;
+	size_t * next;
+	int64_t * cells;
+	point_t ** points;
+	size_t numPoints, maxPoints;
+
+} dmCellHash_t;
+
+static inline bool s_dm_cellHash_init(dmCellHash_t * restrict ch, size_t maxPoints, float cellSize)
+{
+	assert(ch != NULL);
+	assert(cellSize > 0.0f);
+
+	size_t numHeads = 16;
+	while (numHeads < (maxPoints * 2))
+	{
+		numHeads *= 2;
+	}
+	*ch = (dmCellHash_t){
+		.cellSize  = cellSize,
+		.heads     = malloc(sizeof(size_t) * numHeads),
+		.mask      = numHeads - 1,
+		.next      = malloc(sizeof(size_t) * mh_zmax(maxPoints, 1)),
+		.cells     = malloc(sizeof(int64_t) * 2 * mh_zmax(maxPoints, 1)),
+		.points    = malloc(sizeof(point_t *) * mh_zmax(maxPoints, 1)),
+		.numPoints = 0,
+		.maxPoints = mh_zmax(maxPoints, 1)
+	};
+	if ((ch->heads == NULL) || (ch->next == NULL) || (ch->cells == NULL) || (ch->points == NULL))
+	{
+		free(ch->heads);
+		free(ch->next);
+		free(ch->cells);
+		free(ch->points);
+		return false;
+	}
+	for (size_t i = 0; i < numHeads; ++i)
+	{
+		ch->heads[i] = SIZE_MAX;
+	}
+	return true;
+}
+static inline int64_t s_dm_cellHash_coord(const dmCellHash_t * restrict ch, float v)
+{
+	const float c = floorf(v / ch->cellSize);
+	// Lõpmatud ja liiga suured koordinaadid satuvad äärmuslahtritesse
+	if (!(c > -4.0e18f))
+	{
+		return -(int64_t)4e18;
+	}
+	else if (!(c < 4.0e18f))
+	{
+		return (int64_t)4e18;
+	}
+	return (int64_t)c;
+}
+static inline size_t s_dm_cellHash_bucket(const dmCellHash_t * restrict ch, int64_t cx, int64_t cy)
+{
+	uint64_t h = ((uint64_t)cx * UINT64_C(0x9E3779B97F4A7C15)) ^ ((uint64_t)cy * UINT64_C(0xC2B2AE3D27D4EB4F));
+	h ^= h >> 32;
+	return (size_t)h & ch->mask;
+}
+/**
+ * @brief Finds the nearest junction in the spatial hash within cell size distance
+ * 
+ * @param ch Pointer to dmCellHash structure
+ * @param p Pointer to point structure
+ * @return point_t* Nearest junction, NULL if none is close enough
+ */
+static inline point_t * s_dm_cellHash_find(const dmCellHash_t * restrict ch, const point_t * restrict p)
+{
+	const int64_t cx = s_dm_cellHash_coord(ch, p->x), cy = s_dm_cellHash_coord(ch, p->y);
+	const float tol2 = ch->cellSize * ch->cellSize;
+
+	point_t * best = NULL;
+	float bestDist2 = INFINITY;
+	for (int64_t dy = -1; dy <= 1; ++dy)
+	{
+		for (int64_t dx = -1; dx <= 1; ++dx)
+		{
+			const int64_t nx = cx + dx, ny = cy + dy;
+			for (size_t j = ch->heads[s_dm_cellHash_bucket(ch, nx, ny)]; j != SIZE_MAX; j = ch->next[j])
+			{
+				if ((ch->cells[2 * j] != nx) || (ch->cells[2 * j + 1] != ny))
+				{
+					continue;
+				}
+				const float ex = ch->points[j]->x - p->x, ey = ch->points[j]->y - p->y;
+				const float dist2 = (ex * ex) + (ey * ey);
+				// Võrdsete kauguste korral jääb failis eespool olnud ristmik
+				if ((dist2 <= tol2) && ((dist2 < bestDist2) || ((dist2 == bestDist2) && (ch->points[j]->idx < best->idx))))
+				{
+					best = ch->points[j];
+					bestDist2 = dist2;
+				}
+			}
+		}
+	}
+	return best;
+}
+static inline void s_dm_cellHash_link(dmCellHash_t * restrict ch, size_t j)
+{
+	const size_t bucket = s_dm_cellHash_bucket(ch, ch->cells[2 * j], ch->cells[2 * j + 1]);
+	ch->next[j] = ch->heads[bucket];
+	ch->heads[bucket] = j;
+}
+static inline bool s_dm_cellHash_grow(dmCellHash_t * restrict ch)
+{
+	// Ristmike arv pole lugemisel ette teada, massiivid kasvavad kahekordselt
+	const size_t newcap = ch->maxPoints * 2;
+	size_t * newnext = realloc(ch->next, sizeof(size_t) * newcap);
+	if (newnext == NULL)
+	{
+		return false;
+	}
+	ch->next = newnext;
+	int64_t * newcells = realloc(ch->cells, sizeof(int64_t) * 2 * newcap);
+	if (newcells == NULL)
+	{
+		return false;
+	}
+	ch->cells = newcells;
+	point_t ** newpoints = realloc(ch->points, sizeof(point_t *) * newcap);
+	if (newpoints == NULL)
+	{
+		return false;
+	}
+	ch->points    = newpoints;
+	ch->maxPoints = newcap;
+
+	// Ämbrite arv hoitakse vähemalt kaks korda suuremana punktide arvust,
+	// ahelad ehitatakse salvestatud lahtritest uuesti üles
+	if ((ch->mask + 1) < (newcap * 2))
+	{
+		const size_t numHeads = (ch->mask + 1) * 2;
+		size_t * newheads = malloc(sizeof(size_t) * numHeads);
+		if (newheads == NULL)
+		{
+			return false;
+		}
+		free(ch->heads);
+		ch->heads = newheads;
+		ch->mask  = numHeads - 1;
+		for (size_t i = 0; i < numHeads; ++i)
+		{
+			ch->heads[i] = SIZE_MAX;
+		}
+		for (size_t j = 0; j < ch->numPoints; ++j)
+		{
+			s_dm_cellHash_link(ch, j);
+		}
+	}
+	return true;
+}
+static inline bool s_dm_cellHash_insert(dmCellHash_t * restrict ch, point_t * restrict p)
+{
+	if ((ch->numPoints >= ch->maxPoints) && !s_dm_cellHash_grow(ch))
+	{
+		return false;
+	}
+
+	// Indeks on ajutiselt faili järjekorranumber
+	p->idx = ch->numPoints;
+	ch->cells[2 * ch->numPoints]     = s_dm_cellHash_coord(ch, p->x);
+	ch->cells[2 * ch->numPoints + 1] = s_dm_cellHash_coord(ch, p->y);
+	ch->points[ch->numPoints] = p;
+	s_dm_cellHash_link(ch, ch->numPoints);
+	++ch->numPoints;
+	return true;
+}
+static inline void s_dm_cellHash_destroy(dmCellHash_t * restrict ch)
+{
+	free(ch->heads);
+	free(ch->next);
+	free(ch->cells);
+	free(ch->points);
+	ch->heads  = NULL;
+	ch->next   = NULL;
+	ch->cells  = NULL;
+	ch->points = NULL;
+}
+
+/**
+ * @brief Assigns the next interned identifier to a point, whose id is new to the data
+ * model. Uniqueness of the id is checked by the caller's hashmap, so the id string
+ * isn't hashed again
+ * 
+ */
+static inline bool s_dm_internId(dataModel_t * restrict dm, point_t * restrict p)
+{
+	if (dm->numInternIds == DM_NO_INTERN)
+	{
+		return false;
+	}
+	p->internId = dm->numInternIds;
+	++dm->numInternIds;
+	return true;
+}
+static inline bool s_dm_addJunction(dataModel_t * restrict dm, point_t * restrict p)
+{
+	// Ristmikud hoitakse lisamise järjekorras, indeksid nummerdatakse hiljem ümber
+	if (dm->numJunctions >= dm->maxJunctions)
+	{
+		size_t newcap = (dm->numJunctions + 1) * 2;
+		point_t ** newmem = realloc(dm->junctions, sizeof(point_t *) * newcap);
+		if (newmem == NULL)
+		{
+			return false;
+		}
+		dm->junctions    = newmem;
+		dm->maxJunctions = newcap;
+	}
+	dm->junctions[dm->numJunctions] = p;
+	++dm->numJunctions;
+	return true;
+}
+
+/**
+ * @brief Sections of the data file known to the loader
+ * 
+ */
+typedef enum dmSection
+{
+	dmsOTHER,
+	dmsJUNCTIONS,
+	dmsROADS,
+	dmsSTOPS,
+
+	dmsNUM_SECTIONS
+
+} dmSection_t;
+
+/**
+ * @brief Road whose endpoints weren't loaded yet when it was read
+ * 
+ */
+typedef struct dmPendingRoad
+{
+	iniString_t id;
+	const char * value;
+
+} dmPendingRoad_t;
+
+/**
+ * @brief Road read by a worker thread, endpoints are resolved when all junctions are known
+ * 
+ */
+typedef struct dmRoadToken
+{
+	iniString_t id;
+	lineFields_t fields;
+
+} dmRoadToken_t;
+
+/**
+ * @brief Part of a large junction or road section body, parsed by a worker thread
+ * into thread-local buffers and merged into the data model in file order afterwards
+ * 
+ */
+typedef struct dmChunk
+{
+	iniReader_t * reader;
+	size_t offset, length;
+	dmSection_t section;
+	arena_t arena;
+	bool ok;
+
+	point_t * points;
+	dmRoadToken_t * roads;
+	size_t num, max;
+
+	const hashMapOA_t * pointmap;
+	line_t * lines;
+
+} dmChunk_t;
+
+/**
+ * @brief State of the streaming data file loader
+ * 
+ */
+typedef struct dmLoader
+{
+	dataModel_t * dm;
+	dmErr_t err;
+	bool network, stops;
+
+	dmSection_t section;
+	size_t counts[dmsNUM_SECTIONS];
+	bool seen[dmsNUM_SECTIONS], junctionsDone;
+
+	bool merge;
+	dmCellHash_t cellHash;
+	hashMapOA_t idMap;
+	size_t numMerged;
+
+	dmPendingRoad_t * pending;
+	size_t numPending, maxPending;
+
+	dmChunk_t * roadChunks;
+	size_t numRoadChunks;
+
+	point_t lastStop;
+
+} dmLoader_t;
+
+static inline bool s_dm_storeJunction(dmLoader_t * restrict ld, const point_t * restrict temp)
+{
+	dataModel_t * dm = ld->dm;
+
+	// Valikuliselt ühendatakse tolerantsist lähemal olevad ristmikud, duplikaatide id-d
+	// jäävad aliastena idMap räsitabelisse, et teede otspunkte ümber suunata
+	point_t * rep = ld->merge ? s_dm_cellHash_find(&ld->cellHash, temp) : NULL, * p = NULL;
+	if (rep != NULL)
+	{
+		// Duplikaadi võti on andmefailis olemas kuni andmemudeli hävitamiseni
+		++ld->numMerged;
+		return hashMapOA_insert(&ld->idMap, temp->id.str, rep);
+	}
+	else if ((p = arena_alloc(&dm->arena, sizeof(point_t))) == NULL)
+	{
+		return false;
+	}
+	*p = *temp;
+	// Punkti p id räsitabelisse lisamine, uus id saab järgmise internId
+	if (!hashMapOA_insert(&dm->junctionMap, p->id.str, p) || !s_dm_internId(dm, p) || !s_dm_addJunction(dm, p))
+	{
+		return false;
+	}
+	else if (ld->merge)
+	{
+		return hashMapOA_insert(&ld->idMap, p->id.str, p) && s_dm_cellHash_insert(&ld->cellHash, p);
+	}
+	return true;
+}
+static inline bool s_dm_loadJunction(dmLoader_t * restrict ld, const iniString_t * restrict key, const char * restrict value)
+{
+	// Punkt loetakse esmalt pinusse, areenist võetakse mälu ainult säilitatavatele punktidele
+	point_t temp;
+	return point_initStr(&temp, key, value) && s_dm_storeJunction(ld, &temp);
+}
+static inline bool s_dm_storeRoad(dmLoader_t * restrict ld, const line_t * restrict temp)
+{
+	dataModel_t * dm = ld->dm;
+
+	// Üheks punktiks kokku kukkunud teed, nii ühendamise tõttu kui ka juba failis
+	// sama ristmikku ühendavad, jäetakse välja, teekondadele ei lisa need midagi
+	line_t * line = NULL;
+	if (temp->src == temp->dst)
+	{
+		return true;
+	}
+	else if ((line = arena_alloc(&dm->arena, sizeof(line_t))) == NULL)
+	{
+		return false;
+	}
+	*line = *temp;
+	return dm_addLine(dm, line);
+}
+static inline bool s_dm_loadRoad(dmLoader_t * restrict ld, const iniString_t * restrict key, const char * restrict value)
+{
+	dataModel_t * dm = ld->dm;
+
+	if (!ld->junctionsDone)
+	{
+		// Otspunktid võivad olla failis hiljem, tee jäetakse ootele
+		if (ld->numPending >= ld->maxPending)
+		{
+			size_t newcap = (ld->numPending + 1) * 2;
+			dmPendingRoad_t * newmem = realloc(ld->pending, sizeof(dmPendingRoad_t) * newcap);
+			if (newmem == NULL)
+			{
+				return false;
+			}
+			ld->pending    = newmem;
+			ld->maxPending = newcap;
+		}
+		iniString_initView(&ld->pending[ld->numPending].id, key);
+		ld->pending[ld->numPending].value = value;
+		++ld->numPending;
+		return true;
+	}
+
+	line_t temp;
+	return line_initStr(&temp, ld->merge ? &ld->idMap : &dm->junctionMap, key, value) && s_dm_storeRoad(ld, &temp);
+}
+static inline bool s_dm_loadStop(dmLoader_t * restrict ld, const iniString_t * restrict key, const char * restrict value)
+{
+	dataModel_t * dm = ld->dm;
+
+	point_t p;
+	if (!point_initStr(&p, key, value) || !s_dm_internId(dm, &p))
+	{
+		return false;
+	}
+
+	// Esimene peatus on algus, viimane lõpp. Peatuste koguarv pole ette teada,
+	// seega hoitakse viimast loetud peatust ootel, kuni tuleb järgmine
+	if (ld->counts[dmsSTOPS] == 0)
+	{
+		dm->points[0] = p;
+	}
+	else
+	{
+		if ((ld->counts[dmsSTOPS] > 1) && (dm->numMidPoints < MAX_MID_POINTS))
+		{
+			dm->mid[dm->numMidPoints] = ld->lastStop;
+			++dm->numMidPoints;
+		}
+		ld->lastStop = p;
+	}
+	return true;
+}
+static bool s_dm_loaderCallback(void * userData, const iniString_t * section, const iniString_t * key, const iniString_t * value)
+{
+	dmLoader_t * ld = userData;
+	assert(ld != NULL);
+
+	if (key == NULL)
+	{
+		// Ristmikud on kõik loetud, kui nende sektsioon lõpeb
+		ld->junctionsDone |= (ld->section == dmsJUNCTIONS);
+		ld->section = (strcmp(section->str, "ristmikud") == 0) ? dmsJUNCTIONS :
+			(strcmp(section->str, "teed") == 0)     ? dmsROADS :
+			(strcmp(section->str, "peatused") == 0) ? dmsSTOPS : dmsOTHER;
+		// Soovimata sektsioonid jäetakse vahele
+		if (((ld->section == dmsSTOPS) && !ld->stops) || ((ld->section != dmsSTOPS) && !ld->network))
+		{
+			ld->section = dmsOTHER;
+		}
+		if ((ld->section != dmsOTHER) && ld->seen[ld->section])
+		{
+			ld->err = dmeSECTIONS;
+			return false;
+		}
+		ld->seen[ld->section] = true;
+		return true;
+	}
+
+	bool success = true;
+	switch (ld->section)
+	{
+	case dmsJUNCTIONS:
+		success = s_dm_loadJunction(ld, key, value->str);
+		break;
+	case dmsROADS:
+		success = s_dm_loadRoad(ld, key, value->str);
+		break;
+	case dmsSTOPS:
+		success = s_dm_loadStop(ld, key, value->str);
+		break;
+	default:
+		return true;
+	}
+	++ld->counts[ld->section];
+	if (!success)
+	{
+		ld->err = dmeMEM;
+	}
+	return success;
+}
+static inline void s_dm_chunk_destroy(dmChunk_t * restrict ch)
+{
+	arena_destroy(&ch->arena);
+	free(ch->points);
+	free(ch->roads);
+	free(ch->lines);
+	ch->points = NULL;
+	ch->roads  = NULL;
+	ch->lines  = NULL;
+	ch->num    = 0;
+	ch->max    = 0;
+}
+static inline void s_dm_loader_destroy(dmLoader_t * restrict ld)
+{
+	s_dm_cellHash_destroy(&ld->cellHash);
+	hashMapOA_destroy(&ld->idMap);
+	hashMapOA_zero(&ld->idMap);
+	free(ld->pending);
+	ld->pending    = NULL;
+	ld->numPending = 0;
+	ld->maxPending = 0;
+	for (size_t i = 0; i < ld->numRoadChunks; ++i)
+	{
+		s_dm_chunk_destroy(&ld->roadChunks[i]);
+	}
+	free(ld->roadChunks);
+	ld->roadChunks    = NULL;
+	ld->numRoadChunks = 0;
+}
+
+static bool s_dm_chunkCallback(void * userData, const iniString_t * section, const iniString_t * key, const iniString_t * value)
+{
+	dmChunk_t * ch = userData;
+	assert(ch != NULL);
+	(void)section;
+
+	// Sektsiooni päis tüki sees tähendab, et faili ei saanud ridade kaupa õigesti jagada
+	if (key == NULL)
+	{
+		return false;
+	}
+
+	if (ch->num >= ch->max)
+	{
+		size_t newcap = (ch->num + 1) * 2;
+		if (ch->section == dmsJUNCTIONS)
+		{
+			point_t * newmem = realloc(ch->points, sizeof(point_t) * newcap);
+			if (newmem == NULL)
+			{
+				return false;
+			}
+			ch->points = newmem;
+		}
+		else
+		{
+			dmRoadToken_t * newmem = realloc(ch->roads, sizeof(dmRoadToken_t) * newcap);
+			if (newmem == NULL)
+			{
+				return false;
+			}
+			ch->roads = newmem;
+		}
+		ch->max = newcap;
+	}
+
+	if (ch->section == dmsJUNCTIONS)
+	{
+		if (!point_initStr(&ch->points[ch->num], key, value->str))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		// Teed ainult tükeldatakse, otspunkte veel ei otsita
+		iniString_initView(&ch->roads[ch->num].id, key);
+		if (!s_line_tokenise(&ch->roads[ch->num].fields, value->str))
+		{
+			return false;
+		}
+	}
+	++ch->num;
+	return true;
+}
+static void s_dm_chunkParse(void * task)
+{
+	dmChunk_t * ch = task;
+	ch->ok = (iniReader_parse(ch->reader, ch->offset, ch->length, &ch->arena, &s_dm_chunkCallback, ch) == inieOK);
+}
+static void s_dm_chunkResolve(void * task)
+{
+	dmChunk_t * ch = task;
+
+	// Ristmike räsitabelist ainult loetakse, seega saavad kõik lõimed seda korraga kasutada
+	ch->lines = malloc(sizeof(line_t) * mh_zmax(ch->num, 1));
+	ch->ok = (ch->lines != NULL);
+	for (size_t i = 0; ch->ok && (i < ch->num); ++i)
+	{
+		ch->ok = s_line_initFields(&ch->lines[i], ch->pointmap, &ch->roads[i].id, &ch->roads[i].fields);
+	}
+}
+/**
+ * @brief Loads the body of the current section, large junction and road sections are
+ * split at line starts into chunks, which are parsed concurrently
+ * 
+ */
+static inline iniErr_t s_dm_loadBody(dmLoader_t * restrict ld, size_t offset, size_t length, size_t numThreads)
+{
+	iniReader_t * reader = &ld->dm->dataFile;
+
+	size_t numChunks = mh_zmin(numThreads, length / DM_LOAD_CHUNK_MIN);
+	if (((ld->section != dmsJUNCTIONS) && (ld->section != dmsROADS)) || (numChunks < 2))
+	{
+		return iniReader_parse(reader, offset, length, NULL, &s_dm_loaderCallback, ld);
+	}
+	dmChunk_t * chunks = malloc(sizeof(dmChunk_t) * numChunks);
+	if (chunks == NULL)
+	{
+		return inieMEM;
+	}
+	const size_t end = offset + length;
+	for (size_t i = 0, start = offset; i < numChunks; ++i)
+	{
+		// Tükk lõpeb rea alguses, nii on igas tükis terve arv kirjeid
+		size_t stop = ((i + 1) == numChunks) ? end : iniReader_nextLine(reader, offset + (length / numChunks) * (i + 1));
+		stop = mh_zmax(mh_zmin(stop, end), start);
+		chunks[i] = (dmChunk_t){
+			.reader   = reader,
+			.offset   = start,
+			.length   = stop - start,
+			.section  = ld->section,
+			.ok       = false,
+			.points   = NULL,
+			.roads    = NULL,
+			.num      = 0,
+			.max      = 0,
+			.pointmap = NULL,
+			.lines    = NULL
+		};
+		arena_init(&chunks[i].arena, 0);
+		start = stop;
+	}
+
+	thelper_run(&s_dm_chunkParse, chunks, numChunks, sizeof(dmChunk_t));
+
+	// Lugeja areen võtab tükkide sõned üle, need peavad elama sama kaua kui failist loetud sõned
+	bool success = true;
+	for (size_t i = 0; i < numChunks; ++i)
+	{
+		success &= chunks[i].ok;
+		arena_merge(&reader->arena, &chunks[i].arena);
+		ld->counts[ld->section] += chunks[i].num;
+	}
+	if (success && (ld->section == dmsROADS))
+	{
+		// Teede otspunktid lahendatakse, kui kõik ristmikud on teada
+		ld->roadChunks    = chunks;
+		ld->numRoadChunks = numChunks;
+		return inieOK;
+	}
+	// Ristmikud lisatakse faili järjekorras, nagu järjestikusel lugemisel
+	for (size_t i = 0; success && (i < numChunks); ++i)
+	{
+		for (size_t j = 0; success && (j < chunks[i].num); ++j)
+		{
+			success = s_dm_storeJunction(ld, &chunks[i].points[j]);
+		}
+	}
+	for (size_t i = 0; i < numChunks; ++i)
+	{
+		s_dm_chunk_destroy(&chunks[i]);
+	}
+	free(chunks);
+	return success ? inieOK : inieABORT;
+}
+/**
+ * @brief Loads the data file section by section, section headers are found by scanning
+ * lines, so that section bodies can be split into chunks
+ * 
+ */
+static inline iniErr_t s_dm_loadSections(dmLoader_t * restrict ld, size_t numThreads)
+{
+	iniReader_t * reader = &ld->dm->dataFile;
+
+	// Võtmed enne esimest päist kuuluvad sektsiooni "", mille laadija jätab vahele
+	size_t header = iniReader_nextSection(reader, 0);
+	iniErr_t code = iniReader_parse(reader, 0, header, NULL, &s_dm_loaderCallback, ld);
+	while ((code == inieOK) && (header < reader->length))
+	{
+		// Päise rida loetakse järjest, see valib sektsiooni, mille sisu võib tükeldada
+		size_t body = iniReader_nextLine(reader, header + 1);
+		size_t next = iniReader_nextSection(reader, body);
+		code = iniReader_parse(reader, header, body - header, NULL, &s_dm_loaderCallback, ld);
+		if (code == inieOK)
+		{
+			code = s_dm_loadBody(ld, body, next - body, numThreads);
+		}
+		header = next;
+	}
+	if ((code != inieOK) || (ld->numRoadChunks == 0))
+	{
+		return code;
+	}
+
+	// Teede otspunktid lahendatakse paralleelselt, teed lisatakse faili järjekorras
+	for (size_t i = 0; i < ld->numRoadChunks; ++i)
+	{
+		ld->roadChunks[i].pointmap = ld->merge ? &ld->idMap : &ld->dm->junctionMap;
+	}
+	thelper_run(&s_dm_chunkResolve, ld->roadChunks, ld->numRoadChunks, sizeof(dmChunk_t));
+	for (size_t i = 0; i < ld->numRoadChunks; ++i)
+	{
+		const dmChunk_t * ch = &ld->roadChunks[i];
+		for (size_t j = 0; ch->ok && (j < ch->num); ++j)
+		{
+			if (!s_dm_storeRoad(ld, &ch->lines[j]))
+			{
+				return inieMEM;
+			}
+		}
+		if (!ch->ok)
+		{
+			return inieABORT;
+		}
+	}
+	return inieOK;
+}
+
+static inline dmErr_t s_dm_init(dataModel_t * restrict dm)
+{
+	*dm = (dataModel_t){
+		.numMidPoints = 0,
+		.roads        = NULL,
+		.numRoads     = 0,
+		.maxRoads     = 0,
+
+		.origRoads    = NULL,
+		.numOrigRoads = 0,
+
+		.numInternIds = 0,
+		.junctions    = NULL,
+		.numJunctions = 0,
+		.maxJunctions = 0,
+
+
+		.stopsDistMatrix = NULL,
+		
+		.bestStopsIndices = NULL,
+		
+		.shortestPath    = NULL,
+		.shortestPathLen = 0,
+
+		.compiledMap = {
+			.data   = NULL,
+			.length = 0,
+			.view   = NULL
+		},
+		.mapJunctions    = NULL,
+		.numMapJunctions = 0
+	};
+
+	pf_zeroGraph(&dm->graph);
+	iniReader_zero(&dm->dataFile);
+	arena_init(&dm->arena, 0);
+	for (size_t i = 0; i < TOTAL_POINTS; ++i)
+	{
+		point_zero(&dm->points[i]);
+		dm->pointsp[i] = NULL;
+	}
+	hashMapOA_zero(&dm->junctionMap);
+	hashMapOA_zero(&dm->stopsMap);
+	hashMapPH_zero(&dm->junctionHash);
+
+	// Räsitabeli koostamine punktidest
+	if (!hashMapOA_init(&dm->junctionMap, 1) || !hashMapOA_init(&dm->stopsMap, TOTAL_POINTS))
+	{
+		return dmeMEM;
+	}
+	return dmeOK;
+}
+/**
+ * @brief Reserves the junction map, junction array and merge aliases for the junctions
+ * section of the opened data file, so that they are built in one pass without
+ * resizing. Line count of the section is an upper bound for the number of junctions.
+ * 
+ */
+static inline bool s_dm_reserveJunctions(dmLoader_t * restrict ld)
+{
+	dataModel_t * dm = ld->dm;
+
+	size_t length = 0;
+	const size_t body = iniReader_findSection(&dm->dataFile, "ristmikud", &length);
+	if (body >= dm->dataFile.length)
+	{
+		// Sektsiooni puudumisest annab teada laadija
+		return true;
+	}
+	// Peatuste projektsioonid lisatakse hiljem samasse räsitabelisse
+	const size_t maxJunctions = iniReader_countLines(&dm->dataFile, body, length) + TOTAL_POINTS;
+	if (!hashMapOA_resize(&dm->junctionMap, maxJunctions) || (ld->merge && !hashMapOA_resize(&ld->idMap, maxJunctions)))
+	{
+		return false;
+	}
+	point_t ** newmem = realloc(dm->junctions, sizeof(point_t *) * maxJunctions);
+	if (newmem == NULL)
+	{
+		return false;
+	}
+	dm->junctions    = newmem;
+	dm->maxJunctions = maxJunctions;
+	return true;
+}
+/**
+ * @brief Streams the data file into the data model, network selects junctions and
+ * roads, stops selects stops, unselected sections are skipped. With more than one
+ * thread retry is set, if the file couldn't be split into chunks, then the data
+ * model is left partially loaded.
+ * 
+ */
+static inline dmErr_t s_dm_streamIni(
+	dataModel_t * restrict dm,
+	const char * restrict filename,
+	bool network,
+	bool stops,
+	const dmLoadOptions_t * restrict opts,
+	size_t numThreads,
+	bool * restrict retry
+)
+{
+	dmLoader_t ld = {
+		.dm            = dm,
+		.err           = dmeOK,
+		.network       = network,
+		.stops         = stops,
+		.section       = dmsOTHER,
+		.junctionsDone = false,
+		.merge         = network && (opts->mergeTolerance > 0.0f),
+		.cellHash      = { .heads = NULL },
+		.numMerged     = 0,
+		.pending       = NULL,
+		.numPending    = 0,
+		.maxPending    = 0,
+		.roadChunks    = NULL,
+		.numRoadChunks = 0
+	};
+	for (size_t i = 0; i < dmsNUM_SECTIONS; ++i)
+	{
+		ld.counts[i] = 0;
+		ld.seen[i]   = false;
+	}
+	point_zero(&ld.lastStop);
+	hashMapOA_zero(&ld.idMap);
+	if (ld.merge && (!s_dm_cellHash_init(&ld.cellHash, 16, opts->mergeTolerance) || !hashMapOA_init(&ld.idMap, 16)))
+	{
+		s_dm_loader_destroy(&ld);
+		return dmeMEM;
+	}
+
+	// Andmefail loetakse ühe läbimisega otse andmemudelisse, vahepealset puud ei ehitata.
+	// Lugeja jääb andmemudelile, punktide ja teede id-d viitavad selle sõnedele
+	iniErr_t code = iniReader_openFile(&dm->dataFile, filename);
+	if ((code == inieOK) && network && !s_dm_reserveJunctions(&ld))
+	{
+		code = inieMEM;
+	}
+	if (code == inieOK)
+	{
+		code = (numThreads > 1) ? s_dm_loadSections(&ld, numThreads) :
+			iniReader_parse(&dm->dataFile, 0, dm->dataFile.length, NULL, &s_dm_loaderCallback, &ld);
+	}
+	if ((code != inieOK) && (numThreads > 1))
+	{
+		// Vea põhjuseks võib olla vale jagamine, täpse vea annab järjestikune lugemine
+		*retry = true;
+		s_dm_loader_destroy(&ld);
+		return dmeMEM;
+	}
+	else if (code != inieOK)
+	{
+		if (code != inieABORT)
+		{
+			writeLogger("File error!");
+			ld.err = dmeMEM;
+		}
+		s_dm_loader_destroy(&ld);
+		return ld.err;
+	}
+	if ((network && (!ld.seen[dmsJUNCTIONS] || !ld.seen[dmsROADS] || (ld.counts[dmsJUNCTIONS] < 2) || (ld.counts[dmsROADS] < 1))) ||
+		(stops && (!ld.seen[dmsSTOPS] || (ld.counts[dmsSTOPS] < 2))) )
+	{
+		s_dm_loader_destroy(&ld);
+		return dmeSECTIONS;
+	}
+
+	// Ootel teed, mis olid failis enne ristmikke
+	ld.junctionsDone = true;
+	for (size_t i = 0; i < ld.numPending; ++i)
+	{
+		if (!s_dm_loadRoad(&ld, &ld.pending[i].id, ld.pending[i].value))
+		{
+			s_dm_loader_destroy(&ld);
+			return dmeMEM;
+		}
+	}
+	if (ld.merge)
+	{
+		writeLogger("Merged %zu duplicate junctions", ld.numMerged);
+	}
+	s_dm_loader_destroy(&ld);
+
+	// Peatuste lisamine
+	if (ld.counts[dmsSTOPS] > TOTAL_POINTS)
+	{
+		return dmeSTOPS_LIMIT;
+	}
+	else if (stops)
+	{
+		dm->points[1] = ld.lastStop;
+	}
+	return dmeOK;
+}
+/**
+ * @brief Streams the data file into the data model, large network sections are loaded
+ * in parallel. Network loads expect a freshly initialised data model, which is
+ * reinitialised and loaded serially, if the file couldn't be split into chunks.
+ * 
+ */
+static inline dmErr_t s_dm_loadIni(
+	dataModel_t * restrict dm,
+	const char * restrict filename,
+	bool network,
+	bool stops,
+	const dmLoadOptions_t * restrict opts
+)
+{
+	// Nullitud valikud on vaikimisi valikud
+	static const dmLoadOptions_t defaults = { .mergeTolerance = 0.0f, .numThreads = 0 };
+	opts = (opts != NULL) ? opts : &defaults;
+
+	size_t numThreads = (opts->numThreads > 0) ? opts->numThreads : thelper_numCores();
+	if (network && (numThreads > 1))
+	{
+		bool retry = false;
+		dmErr_t code = s_dm_streamIni(dm, filename, network, stops, opts, numThreads, &retry);
+		if (!retry)
+		{
+			return code;
+		}
+		writeLogger("Data file couldn't be split, reading serially");
+		dm_destroy(dm);
+		if ((code = s_dm_init(dm)) != dmeOK)
+		{
+			return code;
+		}
+	}
+	return s_dm_streamIni(dm, filename, network, stops, opts, 1, NULL);
+}
+/**
+ * @brief Keeps a copy of the loaded roads for drawing, snaps stops to roads and
+ * numbers the junctions
+ * 
+ */
+static inline dmErr_t s_dm_finishLoad(dataModel_t * restrict dm)
+{
+	dm->numOrigRoads = dm->numRoads;
+	dm->origRoads = malloc(sizeof(line_t *) * dm->numOrigRoads);
+	if (dm->origRoads == NULL)
+	{
+		return dmeMEM;
+	}
+	for (size_t i = 0; i < dm->numOrigRoads; ++i)
+	{
+		const line_t * road = dm->roads[i];
+		dm->origRoads[i] = arena_alloc(&dm->arena, sizeof(line_t));
+		if ((dm->origRoads[i] == NULL) || !line_init(dm->origRoads[i], &road->id, road->src, road->dst, road->cost))
+		{
+			dm->numOrigRoads = i;
+			return dmeMEM;
+		}
+	}
+
+	if (!dm_addStops(dm) || !dm_updateJunctionIndexes(dm))
+	{
+		return dmeMEM;
+	}
+	return dmeOK;
+}
+
+dmErr_t dm_initDataFile(dataModel_t * restrict dm, const char * restrict filename, const dmLoadOptions_t * restrict opts)
+{
+	assert(dm       != NULL);
+	assert(filename != NULL);
+
+	dmErr_t code = s_dm_init(dm);
+	if (code == dmeOK)
+	{
+		code = s_dm_loadIni(dm, filename, true, true, opts);
+	}
+	if (code == dmeOK)
+	{
+		code = s_dm_finishLoad(dm);
+	}
+	if (code != dmeOK)
+	{
+		dm_destroy(dm);
+	}
+	return code;
+}
+
+/**
+ * @brief Header of the compiled map image, sections follow in the order of
+ * dmMapLayout_t, each aligned to DM_MAP_ALIGN bytes. Numbers are in the native
+ * byte order, image with a different byte order fails the version check. The
+ * junction id hash has hashMapPH_numBuckets(numJunctions) buckets or is missing (0).
+ * 
+ */
+typedef struct dmMapHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t numJunctions, numRoads;
+	uint32_t stringsSize, numHashBuckets;
+
+} dmMapHeader_t;
+
+/**
+ * @brief Byte offsets of the compiled map sections: junction coordinates (x, y),
+ * road endpoint junction indexes (src, dst), road costs, id string offsets (junctions
+ * first, then roads, one extra for the end), pilots and slots of the junction id hash
+ * and null-terminated id strings
+ * 
+ */
+typedef struct dmMapLayout
+{
+	size_t coords, ends, costs, ids, pilots, slots, numSlots, strings, size;
+
+} dmMapLayout_t;
+
+static inline size_t s_dm_mapAlign(size_t offset)
 {
-	assert(l != NULL);
-	iniString_destroy(&l->id);
+	return (offset + DM_MAP_ALIGN - 1) / DM_MAP_ALIGN * DM_MAP_ALIGN;
 }
-void line_free(line_t * restrict l)
+static inline dmMapLayout_t s_dm_mapLayout(const dmMapHeader_t * restrict hdr)
 {
-	assert(l != NULL);
-	line_destroy(l);
-	free(l);
+	dmMapLayout_t l;
+	l.numSlots = (hdr->numHashBuckets != 0) ? hashMapPH_numSlots(hdr->numJunctions) : 0;
+	l.coords   = s_dm_mapAlign(sizeof(dmMapHeader_t));
+	l.ends     = s_dm_mapAlign(l.coords + (sizeof(float) * 2 * hdr->numJunctions));
+	l.costs    = s_dm_mapAlign(l.ends   + (sizeof(uint32_t) * 2 * hdr->numRoads));
+	l.ids      = s_dm_mapAlign(l.costs  + (sizeof(float) * hdr->numRoads));
+	l.pilots   = s_dm_mapAlign(l.ids    + (sizeof(uint32_t) * ((size_t)hdr->numJunctions + hdr->numRoads + 1)));
+	l.slots    = s_dm_mapAlign(l.pilots + (sizeof(uint32_t) * hdr->numHashBuckets));
+	l.strings  = s_dm_mapAlign(l.slots  + (sizeof(uint32_t) * l.numSlots));
+	l.size     = l.strings + hdr->stringsSize;
+	return l;
 }
 
-
-dmErr_t dm_initDataFile(dataModel_t * restrict dm, const char * restrict filename)
+dmErr_t dm_compileDataFile(const char * restrict filename, const char * restrict outname, const dmLoadOptions_t * restrict opts)
 {
-	assert(dm       != NULL);
 	assert(filename != NULL);
+	assert(outname  != NULL);
 
-	*dm = (dataModel_t){
-		.numMidPoints = 0,
-		.roads        = NULL,
-		.numRoads     = 0,
-		.maxRoads     = 0,
-
-		.origRoads    = NULL,
-		.numOrigRoads = 0,
-
-		.relations    = NULL,
-		.costs        = NULL,
-		.juncPoints   = NULL,
-		.numJunctions = 0,
-
-		.stopsDistMatrix = NULL,
-		
-		.bestStopsIndices = NULL,
-		
-		.shortestPath    = NULL,
-		.shortestPathLen = 0
-	};
+	// Loetakse ainult teedevõrk, peatused antakse hiljem eraldi
+	dataModel_t dm;
+	dmErr_t code = s_dm_init(&dm);
+	if (code == dmeOK)
+	{
+		code = s_dm_loadIni(&dm, filename, true, false, opts);
+	}
+	if (code != dmeOK)
+	{
+		dm_destroy(&dm);
+		return code;
+	}
 
-	for (size_t i = 0; i < TOTAL_POINTS; ++i)
+	size_t stringsSize = 0;
+	for (size_t i = 0; i < dm.numJunctions; ++i)
 	{
-		point_zero(&dm->points[i]);
-		dm->pointsp[i] = NULL;
+		stringsSize += dm.junctions[i]->id.len + 1;
+	}
+	for (size_t i = 0; i < dm.numRoads; ++i)
+	{
+		stringsSize += dm.roads[i]->id.len + 1;
+		// Kuvandi laadija lükkab mittepositiivse hinnaga teed tagasi
+		if (!(dm.roads[i]->cost > 0.0f))
+		{
+			writeLogger("Road %s has a non-positive cost, can't compile", dm.roads[i]->id.str);
+			dm_destroy(&dm);
+			return dmeFORMAT;
+		}
+	}
+	if ((dm.numJunctions >= UINT32_MAX) || (dm.numRoads > UINT32_MAX) || (stringsSize > UINT32_MAX))
+	{
+		dm_destroy(&dm);
+		return dmeFORMAT;
 	}
-	hashMapCK_zero(&dm->junctionMap);
-	hashMapCK_zero(&dm->stopsMap);
 
-	// Räsitabeli koostamine punktidest
-	if (!hashMapCK_init(&dm->junctionMap, 1))
+	// Ristmike id-de täiuslik räsi, ilma selleta on kaart siiski kasutatav
+	hashMapPH_t hash;
+	const char ** keys = malloc(sizeof(const char *) * (dm.numJunctions + 1));
+	if (keys == NULL)
 	{
+		dm_destroy(&dm);
 		return dmeMEM;
 	}
-	if (!hashMapCK_init(&dm->stopsMap, TOTAL_POINTS))
+	for (size_t i = 0; i < dm.numJunctions; ++i)
 	{
-		dm_destroy(dm);
+		keys[i] = dm.junctions[i]->id.str;
+	}
+	if (!hashMapPH_build(&hash, keys, dm.numJunctions))
+	{
+		writeLogger("Junction id hash couldn't be built, compiling without it");
+	}
+	free(keys);
+
+	const dmMapHeader_t hdr = {
+		.magic          = DM_MAP_MAGIC,
+		.version        = DM_MAP_VERSION,
+		.numJunctions   = (uint32_t)dm.numJunctions,
+		.numRoads       = (uint32_t)dm.numRoads,
+		.stringsSize    = (uint32_t)stringsSize,
+		.numHashBuckets = (uint32_t)hash.numBuckets
+	};
+	const dmMapLayout_t l = s_dm_mapLayout(&hdr);
+	// Täidised jäävad nulliks, et sama võrgu kuvand oleks alati baidi haaval sama
+	char * image = calloc(l.size, sizeof(char));
+	if (image == NULL)
+	{
+		hashMapPH_destroy(&hash);
+		dm_destroy(&dm);
 		return dmeMEM;
 	}
+	memcpy(image, &hdr, sizeof(dmMapHeader_t));
+	if (hash.numBuckets != 0)
+	{
+		memcpy(image + l.pilots, hash.pilots, sizeof(uint32_t) * hash.numBuckets);
+		memcpy(image + l.slots,  hash.slots,  sizeof(uint32_t) * hash.numSlots);
+	}
+	hashMapPH_destroy(&hash);
 
-	ini_t inifile;
-	if (ini_initFile(&inifile, filename) != inieOK)
+	float * coords    = (float *)(image + l.coords);
+	uint32_t * ends   = (uint32_t *)(image + l.ends);
+	float * costs     = (float *)(image + l.costs);
+	uint32_t * ids    = (uint32_t *)(image + l.ids);
+	char * strings    = image + l.strings;
+
+	// Ristmikud on laadimise järjekorras, indeks on ajutiselt järjekorranumber
+	uint32_t numIds = 0, offset = 0;
+	for (size_t i = 0; i < dm.numJunctions; ++i)
 	{
-		writeLogger("File error!");
-		dm_destroy(dm);
-		return dmeMEM;
+		point_t * p = dm.junctions[i];
+		p->idx = i;
+		coords[2 * i]     = p->x;
+		coords[2 * i + 1] = p->y;
+		ids[numIds] = offset;
+		++numIds;
+		memcpy(strings + offset, p->id.str, p->id.len + 1);
+		offset += (uint32_t)p->id.len + 1;
+	}
+	for (size_t i = 0; i < dm.numRoads; ++i)
+	{
+		const line_t * road = dm.roads[i];
+		ends[2 * i]     = (uint32_t)road->src->idx;
+		ends[2 * i + 1] = (uint32_t)road->dst->idx;
+		costs[i] = road->cost;
+		ids[numIds] = offset;
+		++numIds;
+		memcpy(strings + offset, road->id.str, road->id.len + 1);
+		offset += (uint32_t)road->id.len + 1;
 	}
+	ids[numIds] = offset;
 
-	const iniSection_t * ristmikud, * teed, * peatused;
-	ristmikud = ini_getSection(&inifile, "ristmikud");
-	teed      = ini_getSection(&inifile, "teed");
-	peatused  = ini_getSection(&inifile, "peatused");
+	const intptr_t written = fhelper_writeBin(outname, image, l.size);
+	free(image);
+	writeLogger("Compiled %zu junctions and %zu roads to %zu bytes", dm.numJunctions, dm.numRoads, l.size);
+	dm_destroy(&dm);
 
-	if ((ristmikud == NULL) || (teed == NULL) || (peatused == NULL) ||
-		(ristmikud->numValues < 2) || (teed->numValues < 1) || (peatused->numValues < 2) )
+	return (written == (intptr_t)l.size) ? dmeOK : dmeMEM;
+}
+/**
+ * @brief Maps the compiled road network in place, checks the image and creates
+ * junctions and roads from its arrays, ids are views to the mapping
+ * 
+ */
+static inline dmErr_t s_dm_loadCompiled(dataModel_t * restrict dm, const char * restrict filename)
+{
+	// Kopeeri-kirjutamisel kuvand, sest sõnede vaated ei ole konstantsed. Kuvandisse
+	// ei kirjutata, seega lehti ei kopeerita
+	if (!fhelper_mapCopy(&dm->compiledMap, filename))
+	{
+		return dmeMEM;
+	}
+	char * image = dm->compiledMap.view;
+	const size_t length = dm->compiledMap.length;
+
+	dmMapHeader_t hdr;
+	if (length < sizeof(dmMapHeader_t))
+	{
+		return dmeFORMAT;
+	}
+	memcpy(&hdr, image, sizeof(dmMapHeader_t));
+	if ((memcmp(hdr.magic, DM_MAP_MAGIC, sizeof hdr.magic) != 0) || (hdr.version != DM_MAP_VERSION) ||
+		((hdr.numHashBuckets != 0) && (hdr.numHashBuckets != hashMapPH_numBuckets(hdr.numJunctions))))
+	{
+		return dmeFORMAT;
+	}
+	const dmMapLayout_t l = s_dm_mapLayout(&hdr);
+	if (l.size != length)
+	{
+		return dmeFORMAT;
+	}
+	else if ((hdr.numJunctions < 2) || (hdr.numRoads < 1))
 	{
-		ini_destroy(&inifile);
-		dm_destroy(dm);
 		return dmeSECTIONS;
 	}
 
-	// Ristmikud
-	for (size_t i = 0; i < ristmikud->numValues; ++i)
+	const float * coords    = (const float *)(image + l.coords);
+	const uint32_t * ends   = (const uint32_t *)(image + l.ends);
+	const float * costs     = (const float *)(image + l.costs);
+	const uint32_t * ids    = (const uint32_t *)(image + l.ids);
+	uint32_t * pilots       = (uint32_t *)(image + l.pilots);
+	uint32_t * slots        = (uint32_t *)(image + l.slots);
+	char * strings          = image + l.strings;
+
+	// Iga id lõpeb null-terminaatoriga järgmise id alguse ees
+	const size_t numIds = (size_t)hdr.numJunctions + hdr.numRoads;
+	if ((ids[0] != 0) || (ids[numIds] != hdr.stringsSize))
+	{
+		return dmeFORMAT;
+	}
+	for (size_t i = 0; i < numIds; ++i)
 	{
-		iniValue_t * val = ristmikud->values[i];
-		if (val != NULL)
+		if ((ids[i] >= ids[i + 1]) || (strings[ids[i + 1] - 1] != '\0'))
 		{
-			point_t * p = point_makeStr(val->key.str, val->value.str);
-			// Punkti p id räsitabelisse lisamine
-			if ((p == NULL) || !hashMapCK_insert(&dm->junctionMap, p->id.str, p))
-			{
-				if (p != NULL)
-				{
-					point_free(p);
-				}
-				ini_destroy(&inifile);
-				dm_destroy(dm);
-				return dmeMEM;
-			}
+			return dmeFORMAT;
 		}
 	}
-
-	// Teed
-
-	for (size_t i = 0; i < teed->numValues; ++i)
+	// Teede otspunktid peavad olema erinevad ristmikud ja hinnad positiivsed, nagu
+	// kompileerimisel, muidu kukuks line_init'i eeldus
+	for (size_t i = 0; i < hdr.numRoads; ++i)
 	{
-		iniValue_t * val = teed->values[i];
-		if (val != NULL)
+		if ((ends[2 * i] >= hdr.numJunctions) || (ends[2 * i + 1] >= hdr.numJunctions) ||
+			(ends[2 * i] == ends[2 * i + 1]) || !(costs[i] > 0.0f))
 		{
-			line_t * line = line_makeStr(&dm->junctionMap, val->key.str, val->value.str);
-			if ((line == NULL) || !dm_addLine(dm, line))
-			{
-				if (line != NULL)
-				{
-					free(line);
-				}
-				ini_destroy(&inifile);
-				dm_destroy(dm);
-				return dmeMEM;
-			}
+			return dmeFORMAT;
 		}
 	}
-	dm->numOrigRoads = dm->numRoads;
-	dm->origRoads = malloc(sizeof(line_t *) * dm->numOrigRoads);
-	if (dm->origRoads == NULL)
+	// Räsi pilootide väärtus ei ole piiratud, pesad peavad viitama ristmikele
+	for (size_t i = 0; i < l.numSlots; ++i)
+	{
+		if ((slots[i] >= hdr.numJunctions) && (slots[i] != HASHMAPPH_EMPTY))
+		{
+			return dmeFORMAT;
+		}
+	}
+
+	// Kõik ristmikud ja teed võetakse ühe eraldusega, massiivides on ruumi ka peatustele
+	// Päise arvud liidetakse size_t-s, et võõras kuvand ei saaks uint32_t-d ületäita
+	const size_t maxJunctions = (size_t)hdr.numJunctions + TOTAL_POINTS;
+	const size_t maxRoads     = (size_t)hdr.numRoads + TOTAL_POINTS;
+	point_t * points = arena_alloc(&dm->arena, sizeof(point_t) * hdr.numJunctions);
+	line_t * lines   = arena_alloc(&dm->arena, sizeof(line_t) * hdr.numRoads);
+	dm->junctions    = malloc(sizeof(point_t *) * maxJunctions);
+	dm->roads        = malloc(sizeof(line_t *) * maxRoads);
+	if ((points == NULL) || (lines == NULL) || (dm->junctions == NULL) || (dm->roads == NULL))
 	{
-		ini_destroy(&inifile);
-		dm_destroy(dm);
 		return dmeMEM;
 	}
-	for (size_t i = 0; i < dm->numOrigRoads; ++i)
+	dm->maxJunctions = maxJunctions;
+	dm->maxRoads     = maxRoads;
+
+	for (size_t i = 0; i < hdr.numJunctions; ++i)
 	{
-		const line_t * road = dm->roads[i];
-		dm->origRoads[i] = line_make(road->id.str, road->src, road->dst, road->cost);
-		if (dm->origRoads[i] == NULL)
+		point_t * p = &points[i];
+		p->id = (iniString_t){
+			.str   = strings + ids[i],
+			.len   = ids[i + 1] - ids[i] - 1,
+			.owned = false
+		};
+		p->x   = coords[2 * i];
+		p->y   = coords[2 * i + 1];
+		p->idx = i;
+		// Kompileeritud kaardi id-d on unikaalsed, internId on sõnetabeli järjekord
+		p->internId = (uint32_t)i;
+		dm->junctions[i] = p;
+	}
+	dm->numJunctions = hdr.numJunctions;
+	dm->numInternIds = hdr.numJunctions;
+	// Räsi pesad on kuvandi järjekorras ristmike indeksid
+	dm->mapJunctions    = points;
+	dm->numMapJunctions = hdr.numJunctions;
+	if (hdr.numHashBuckets != 0)
+	{
+		hashMapPH_initView(&dm->junctionHash, pilots, hdr.numHashBuckets, slots, l.numSlots);
+	}
+	for (size_t i = 0; i < hdr.numRoads; ++i)
+	{
+		const size_t id = hdr.numJunctions + i;
+		const iniString_t roadId = {
+			.str   = strings + ids[id],
+			.len   = ids[id + 1] - ids[id] - 1,
+			.owned = false
+		};
+		if (!line_init(&lines[i], &roadId, &points[ends[2 * i]], &points[ends[2 * i + 1]], costs[i]))
 		{
-			dm->numOrigRoads = i;
-			ini_destroy(&inifile);
-			dm_destroy(dm);
 			return dmeMEM;
 		}
+		dm->roads[i] = &lines[i];
 	}
+	dm->numRoads = hdr.numRoads;
 
-	// Peatused
+	return dmeOK;
+}
+dmErr_t dm_initCompiled(dataModel_t * restrict dm, const char * restrict mapname, const char * restrict stopsname)
+{
+	assert(dm        != NULL);
+	assert(mapname   != NULL);
+	assert(stopsname != NULL);
 
-	size_t numStops = 0;
-	for (size_t i = 0; i < peatused->numValues; ++i)
+	dmErr_t code = s_dm_init(dm);
+	if (code == dmeOK)
 	{
-		numStops += (peatused->values[i] != NULL);
+		code = s_dm_loadCompiled(dm, mapname);
 	}
-	// Peatuste lisamine
-	if (numStops > TOTAL_POINTS)
+	if (code == dmeOK)
+	{
+		code = s_dm_loadIni(dm, stopsname, false, true, NULL);
+	}
+	if (code == dmeOK)
+	{
+		code = s_dm_finishLoad(dm);
+	}
+	if (code != dmeOK)
 	{
-		ini_destroy(&inifile);
 		dm_destroy(dm);
-		return dmeSTOPS_LIMIT;
 	}
-
-
-	for (size_t i = 0, realStops = 0; i < peatused->numValues; ++i)
+	return code;
+}
+/**
+ * @brief Finds a junction of the compiled map by its id, NULL if the data model
+ * isn't loaded from a compiled map
+ * 
+ */
+static inline point_t * s_dm_findMapJunction(const dataModel_t * restrict dm, const char * restrict id)
+{
+	if (dm->mapJunctions == NULL)
+	{
+		return NULL;
+	}
+	else if (dm->junctionHash.numSlots == 0)
 	{
-		iniValue_t * val = peatused->values[i];
-		if (val != NULL)
+		// Räsita kuvand, otsitakse järjest
+		for (size_t i = 0; i < dm->numMapJunctions; ++i)
 		{
-			point_t p;
-			if (!point_initStr(&p, val->key.str, val->value.str))
-			{
-				ini_destroy(&inifile);
-				dm_destroy(dm);
-				return dmeMEM;
-			}
-
-			if ((realStops > 0) && ((realStops + 1) < numStops))
+			if (strcmp(dm->mapJunctions[i].id.str, id) == 0)
 			{
-				dm->mid[dm->numMidPoints] = p;
-				++dm->numMidPoints;
+				return &dm->mapJunctions[i];
 			}
-			else
-			{
-				dm->points[(realStops > 0)] = p;
-			}
-
-			++realStops;
 		}
+		return NULL;
 	}
-	
-	if (!dm_addStops(dm))
+	const uint32_t idx = hashMapPH_get(&dm->junctionHash, id, strlen(id));
+	// Võõras võti annab mõne teise ristmiku indeksi
+	return ((idx != HASHMAPPH_EMPTY) && (strcmp(dm->mapJunctions[idx].id.str, id) == 0)) ? &dm->mapJunctions[idx] : NULL;
+}
+point_t * dm_findJunction(const dataModel_t * restrict dm, const char * restrict id)
+{
+	assert(dm != NULL);
+	assert(id != NULL);
+
+	point_t * p = s_dm_findMapJunction(dm, id);
+	if (p == NULL)
 	{
-		ini_destroy(&inifile);
-		dm_destroy(dm);
-		return dmeMEM;
+		const hashEntryOA_t * entry = hashMapOA_get(&dm->junctionMap, id);
+		p = (entry != NULL) ? entry->value : NULL;
 	}
-
-	dm_updateJunctionIndexes(dm);
-
-	// Mälu vabastamine, kui kõik on õnnestunud siiamaani
-	ini_destroy(&inifile);
-
-	return dmeOK;
+	return p;
 }
 bool dm_addStops(dataModel_t * restrict dm)
 {
@@ -506,78 +1711,86 @@ bool dm_addStops(dataModel_t * restrict dm)
 
 	size_t totPoints = 2 + dm->numMidPoints;
 
+	// Teede ruudustik, et ei peaks iga peatuse jaoks kõiki teid läbi käima
+	roadGrid_t grid;
+	if (!roadGrid_init(&grid, dm->roads, dm->numRoads))
+	{
+		return false;
+	}
+	// Väikseim tee "hind" piirab, kui kaugel võib asuda parim kaalutud tee
+	float minCost = INFINITY;
+	for (size_t j = 0; j < dm->numRoads; ++j)
+	{
+		minCost = mh_fminf(minCost, dm->roads[j]->cost);
+	}
+
 	for (size_t i = 0; i < totPoints; ++i)
 	{
 		point_t * p = &dm->points[i];
 		// Otsib lähima tee konkreetsele punktile
-		float shortestLen2;
 		point_t bestPoint;
-		line_t * tee = NULL;
-		bool pointSet = false;
-
-		for (size_t j = 0; j < dm->numRoads; ++j)
-		{
-			point_t tempPoint;
-			line_intersect(&tempPoint, p, dm->roads[j]);
-
-			const float dx = tempPoint.x - p->x;
-			const float dy = tempPoint.y - p->y;
-			float len2 = (dx * dx) + (dy * dy);
-			// Tee "hinda" võetakse ka arvesse, eelistatakse "kiiremaid" teid
-			len2 *= dm->roads[j]->cost;
-
-			if (!pointSet || (len2 < shortestLen2))
-			{
-				pointSet = true;
+		size_t teeIdx;
+		bool pointSet = roadGrid_snap(&grid, dm->roads, p, minCost, &teeIdx, &bestPoint);
+		line_t * tee = pointSet ? dm->roads[teeIdx] : NULL;
 
-				shortestLen2 = len2;
-				bestPoint = tempPoint;
-				tee = dm->roads[j];
-			}
-		}
-
-		if (!pointSet || !iniString_initCopy(&bestPoint.id, &p->id))
+		if (!pointSet)
 		{
+			roadGrid_destroy(&grid);
 			return false;
 		}
+		iniString_initView(&bestPoint.id, &p->id);
 
 		// Tee "poolitamine"
 		
 		// Saadud "ideaalne" punkt lisatakse uue ristmikuna, mille id = peatuse id
-		point_t * pointmem = malloc(sizeof(point_t));
+		point_t * pointmem = arena_alloc(&dm->arena, sizeof(point_t));
 		if (pointmem == NULL)
 		{
-			point_destroy(&bestPoint);
+			roadGrid_destroy(&grid);
 			return false;
 		}
 		*pointmem = bestPoint;
+		// Projektsioon on sama id-ga nagu peatus, seega ka sama internId-ga
+		pointmem->internId = p->internId;
 		// Lisa punkti projektsiooni viit õigesse kohta
 		dm->pointsp[i] = pointmem;
-		if (!hashMapCK_insert(&dm->junctionMap, pointmem->id.str, pointmem))
+		// Sama id-ga ristmik võib olla ka kompileeritud kaardil, mille ristmikke räsitabelis
+		// ei ole, peatus lükatakse siis tagasi nagu andmefailist laadides
+		if ((dm_findJunction(dm, pointmem->id.str) != NULL) ||
+			!hashMapOA_insert(&dm->junctionMap, pointmem->id.str, pointmem) || !s_dm_addJunction(dm, pointmem))
 		{
-			point_free(pointmem);
+			roadGrid_destroy(&grid);
 			return false;
 		}
 
-		line_t * linemem = line_make(pointmem->id.str, pointmem, tee->dst, tee->cost);
-		if (linemem == NULL)
+		line_t * linemem = arena_alloc(&dm->arena, sizeof(line_t));
+		if ((linemem == NULL) || !line_init(linemem, &pointmem->id, pointmem, tee->dst, tee->cost))
 		{
+			roadGrid_destroy(&grid);
 			return false;
 		}
 
 		// Lisatakse uus tee, mille id = peatuse id
 		if (!dm_addLine(dm, linemem))
 		{
-			line_free(linemem);
+			roadGrid_destroy(&grid);
 			return false;
 		}
 		line_setDest(tee, pointmem);
+
+		// Poolitatud teed jäävad vana tee lahtritesse, uus tee lisatakse ka ruudustikku
+		if (!roadGrid_insert(&grid, linemem, dm->numRoads - 1))
+		{
+			roadGrid_destroy(&grid);
+			return false;
+		}
 	}
+	roadGrid_destroy(&grid);
 
 	// Add stops to hashmap
 	for (size_t i = 0; i < totPoints; ++i)
 	{
-		if (!hashMapCK_insert(&dm->stopsMap, dm->pointsp[i]->id.str, &dm->pointsp[i]))
+		if (!hashMapOA_insert(&dm->stopsMap, dm->pointsp[i]->id.str, &dm->pointsp[i]))
 		{
 			return false;
 		}
@@ -613,36 +1826,180 @@ bool dm_addLine(dataModel_t * restrict dm, line_t * restrict pline)
 
 	return true;
 }
-void dm_updateJunctionIndexes(dataModel_t * restrict dm)
+/**
+ * @brief Data structure for sorting junctions along the Hilbert curve
+ * 
+ */
+typedef struct dmHilbertKey
+{
+	uint64_t key;
+	size_t pos;
+	point_t * p;
+
+} dmHilbertKey_t;
+
+static int s_dm_hilbertKey_cmp(const void * a, const void * b)
+{
+	const dmHilbertKey_t * k1 = a, * k2 = b;
+	if (k1->key != k2->key)
+	{
+		return (k1->key > k2->key) - (k1->key < k2->key);
+	}
+	return (k1->pos > k2->pos) - (k1->pos < k2->pos);
+}
+static inline uint32_t s_dm_hilbertCoord(float value, float min, float scale)
+{
+	const float c = (value - min) * scale;
+	return (c >= 0.0f) ? ((c <= (float)DM_HILBERT_MAX) ? (uint32_t)c : DM_HILBERT_MAX) : 0;
+}
+
+bool dm_updateJunctionIndexes(dataModel_t * restrict dm)
+{
+	assert(dm != NULL);
+
+	// Leitakse ristmike, sh peatuste projektsioonide, koordinaatide piirid
+	point_t ** junctions = dm->junctions;
+	const size_t numJunctions = dm->numJunctions;
+	float minx = INFINITY, miny = INFINITY, maxx = -INFINITY, maxy = -INFINITY;
+	for (size_t i = 0; i < numJunctions; ++i)
+	{
+		const point_t * p = junctions[i];
+		minx = mh_fminf(minx, p->x);
+		miny = mh_fminf(miny, p->y);
+		maxx = mh_fmaxf(maxx, p->x);
+		maxy = mh_fmaxf(maxy, p->y);
+	}
+
+	dmHilbertKey_t * keys = malloc(sizeof(dmHilbertKey_t) * mh_zmax(numJunctions, 1));
+	if (keys == NULL)
+	{
+		return false;
+	}
+
+	// Koordinaadid viiakse Hilberti kõvera ruudustikule, mõlemal teljel sama mõõtkava
+	const float extent = mh_fmaxf(maxx - minx, maxy - miny);
+	const float scale  = (extent > 0.0f) ? ((float)DM_HILBERT_MAX / extent) : 0.0f;
+	for (size_t i = 0; i < numJunctions; ++i)
+	{
+		point_t * p = junctions[i];
+		keys[i] = (dmHilbertKey_t){
+			.key = mh_hilbertIdx(
+				s_dm_hilbertCoord(p->x, minx, scale),
+				s_dm_hilbertCoord(p->y, miny, scale),
+				DM_HILBERT_ORDER
+			),
+			.pos = i,
+			.p   = p
+		};
+	}
+	qsort(keys, numJunctions, sizeof(dmHilbertKey_t), &s_dm_hilbertKey_cmp);
+
+	for (size_t i = 0; i < numJunctions; ++i)
+	{
+		junctions[i] = keys[i].p;
+		junctions[i]->idx = i;
+	}
+	free(keys);
+
+	return true;
+}
+
+dmErr_t dm_checkConnectivity(dataModel_t * restrict dm)
 {
 	assert(dm != NULL);
 
-	size_t idx = 0;
-	for (size_t i = 0; i < dm->junctionMap.numNodes; ++i)
+	const size_t totPoints = dm->numMidPoints + 2, numJunctions = dm->numJunctions;
+
+	// Ühendatud komponendid leitakse teede otspunktide ühendamisel
+	unionFind_t uf;
+	if (!uf_init(&uf, numJunctions))
+	{
+		return dmeMEM;
+	}
+	for (size_t i = 0; i < dm->numRoads; ++i)
 	{
-		hashNodeCK_t * node = dm->junctionMap.nodes[i];
-		while (node != NULL)
+		const line_t * road = dm->roads[i];
+		if (road != NULL)
 		{
-			if (node->value != NULL)
-			{
-				((point_t *)node->value)->idx = idx;
-				++idx;
-			}
+			uf_union(&uf, road->src->idx, road->dst->idx);
+		}
+	}
+
+	// Peatus on kättesaadav, kui ta on alguspunktiga samas komponendis
+	const size_t root = uf_find(&uf, dm->begp->idx);
+	bool allReachable = true;
+	for (size_t i = 0; i < totPoints; ++i)
+	{
+		dm->reachable[i] = uf_find(&uf, dm->pointsp[i]->idx) == root;
+		allReachable &= dm->reachable[i];
+	}
+	if (!allReachable)
+	{
+		uf_destroy(&uf);
+		return dmeUNREACHABLE;
+	}
+
+	// Kui kõik ristmikud on peatustega samas komponendis, siis pole midagi välja jätta
+	if (uf.size[root] == numJunctions)
+	{
+		uf_destroy(&uf);
+		return dmeOK;
+	}
+
+	// Teised komponendid jäetakse teedest välja
+	size_t numRoads = 0;
+	for (size_t i = 0; i < dm->numRoads; ++i)
+	{
+		line_t * road = dm->roads[i];
+		// Tee mälu kuulub areenile, see vabastatakse koos andmemudeliga
+		if ((road != NULL) && (uf_find(&uf, road->src->idx) != root))
+		{
+			road = NULL;
+		}
+		if (road != NULL)
+		{
+			dm->roads[numRoads] = road;
+			++numRoads;
+		}
+	}
+	for (size_t i = numRoads; i < dm->numRoads; ++i)
+	{
+		dm->roads[i] = NULL;
+	}
+	dm->numRoads = numRoads;
 
-			node = node->next;
+	// Indeksid nummerdatakse ümber samas järjekorras, et tulemused ei muutuks
+	size_t idx = 0;
+	for (size_t i = 0; i < numJunctions; ++i)
+	{
+		point_t * p = dm->junctions[i];
+		if (uf_find(&uf, p->idx) == root)
+		{
+			p->idx = idx;
+			dm->junctions[idx] = p;
+			++idx;
+		}
+		else
+		{
+			p->idx = SIZE_MAX;
 		}
 	}
+	dm->numJunctions = idx;
+	uf_destroy(&uf);
+
+	writeLogger("Kept %zu of %zu junctions in stops' component", idx, numJunctions);
+
+	return dmeOK;
 }
 
 bool dm_createMatrices(dataModel_t * restrict dm)
 {
-	bool result = pf_createRelationsCosts(
+	bool result = pf_createGraph(
 		dm->roads,
 		dm->numRoads,
-		&dm->juncPoints,
-		&dm->relations,
-		&dm->costs,
-		&dm->numJunctions
+		dm->pointsp,
+		dm->numMidPoints + 2,
+		&dm->graph
 	);
 	if (!result)
 	{
@@ -652,9 +2009,7 @@ bool dm_createMatrices(dataModel_t * restrict dm)
 	result = pf_makeDistMatrix(
 		dm->pointsp,
 		dm->numMidPoints + 2,
-		&dm->stopsMap,
-		dm->roads,
-		dm->numRoads,
+		&dm->graph,
 		&dm->stopsDistMatrix
 	);
 	if (!result)
@@ -681,10 +2036,7 @@ bool dm_findShortestPath(dataModel_t * restrict dm)
 		dm->bestStopsIndices,
 		dm->pointsp,
 		dm->numMidPoints + 2,
-		dm->juncPoints,
-		dm->relations,
-		dm->costs,
-		dm->numJunctions,
+		&dm->graph,
 		&dm->shortestPath,
 		&dm->shortestPathLen
 	);
@@ -701,13 +2053,18 @@ bool dm_writeSvg(dataModel_t * restrict dm, FILE * restrict fsvg)
 
 
 	float maxw = -INFINITY, minw = INFINITY, maxh = -INFINITY, minh = INFINITY;
-	for (size_t i = 0; i < dm->numJunctions; ++i)
+	// Piirid arvutatakse algsete teede järgi, sest otsingust välja jäetud teed joonestatakse samuti
+	for (size_t i = 0; i < dm->numOrigRoads; ++i)
 	{
-		const float px = dm->juncPoints[i]->x, py = dm->juncPoints[i]->y;
-		maxw = mh_fmaxf(maxw, px);
-		minw = mh_fminf(minw, px);
-		maxh = mh_fmaxf(maxh, py);
-		minh = mh_fminf(minh, py);
+		const point_t * ends[2] = { dm->origRoads[i]->src, dm->origRoads[i]->dst };
+		for (size_t j = 0; j < 2; ++j)
+		{
+			const float px = ends[j]->x, py = ends[j]->y;
+			maxw = mh_fmaxf(maxw, px);
+			minw = mh_fminf(minw, px);
+			maxh = mh_fmaxf(maxh, py);
+			minh = mh_fminf(minh, py);
+		}
 	}
 	for (size_t i = 0, n = dm->numMidPoints + 2; i < n; ++i)
 	{
@@ -725,31 +2082,38 @@ bool dm_writeSvg(dataModel_t * restrict dm, FILE * restrict fsvg)
 	svgRGB_t svgGray = svg_rgba32(0xC0C0C0FF);
 
 
-	// Peab järge selle üle, millised ristmikud on juba joonestatud
-	hashMapCK_t drawnMap;
-	if (!hashMapCK_init(&drawnMap, dm->numJunctions))
+	// Peab järge selle üle, millised ristmikud on juba joonestatud ja millised on
+	// peatused, lipud on internId järgi
+	enum
+	{
+		dmDRAWN = 0x01,
+		dmSTOP  = 0x02
+	};
+	uint8_t * flags = calloc(mh_zmax(dm->numInternIds, 1), sizeof(uint8_t));
+	if (flags == NULL)
 	{
 		return false;
 	}
+	for (size_t i = 0, n = dm->numMidPoints + 2; i < n; ++i)
+	{
+		flags[dm->pointsp[i]->internId] |= dmSTOP;
+	}
 
 	svg_setPointRadius((SVG_LINE_STROKE * 3) / 4);
 
 	for (size_t i = 0; i < dm->numOrigRoads && result; ++i)
 	{
 		const line_t * road = dm->origRoads[i];
+		uint8_t * srcFlags = &flags[road->src->internId], * dstFlags = &flags[road->dst->internId];
+		const bool drawSrc = (*srcFlags & dmDRAWN) == 0;
+		*srcFlags |= dmDRAWN;
+		const bool drawDst = (*dstFlags & dmDRAWN) == 0;
+		*dstFlags |= dmDRAWN;
 
-		result &= svg_linePoint(
-			fsvg, road, svgGray,
-			hashMapCK_insert(&drawnMap, road->src->id.str, NULL) != false,
-			hashMapCK_insert(&drawnMap, road->dst->id.str, NULL) != false,
-			false
-		);
+		result &= svg_linePoint(fsvg, road, svgGray, drawSrc, drawDst, false);
 	}
 	svg_setPointRadius(SVG_POINT_RADIUS);
 
-	// Enam pole vaja järge pidada joonestatud ristmike üle
-	hashMapCK_destroy(&drawnMap);
-
 	// Joonistab lühima teekonna
 	svgRGB_t svgRed = svg_rgba32(0xFF1111FF);
 	
@@ -760,7 +2124,7 @@ bool dm_writeSvg(dataModel_t * restrict dm, FILE * restrict fsvg)
 			.dst = dm->shortestPath[i + 1]
 		};
 
-		if (hashMapCK_get(&dm->stopsMap, line.dst->id.str) == NULL)
+		if ((flags[line.dst->internId] & dmSTOP) == 0)
 		{
 			result &= svg_linePoint(fsvg, &line, svgRed, false, true, false);
 		}
@@ -770,6 +2134,9 @@ bool dm_writeSvg(dataModel_t * restrict dm, FILE * restrict fsvg)
 		}
 	}
 
+	// Enam pole vaja järge pidada joonestatud ristmike üle
+	free(flags);
+
 	// Kirjutab teenimed
 	svg_setTextFill("rgb(127, 127, 127)");
 	svg_setFontSize(14);
@@ -842,58 +2209,32 @@ void dm_destroy(dataModel_t * restrict dm)
 		point_destroy(&dm->mid[i]);
 	}
 
-	for (size_t i = 0; i < dm->junctionMap.numNodes; ++i)
-	{
-		hashNodeCK_t * node = dm->junctionMap.nodes[i];
-		if (node != NULL)
-		{
-			point_free(node->value);
-			node->value = NULL;
-		}
-	}
-	hashMapCK_destroy(&dm->junctionMap);
-	hashMapCK_destroy(&dm->stopsMap);
+	// Ristmikud ja teed asuvad areenis, massiivid ja räsitabelid hoiavad ainult viitasid
+	hashMapOA_destroy(&dm->junctionMap);
+	hashMapOA_destroy(&dm->stopsMap);
+	hashMapPH_destroy(&dm->junctionHash);
+	dm->mapJunctions    = NULL;
+	dm->numMapJunctions = 0;
 
 	if (dm->roads != NULL)
 	{
-		for (size_t i = 0; i < dm->numRoads; ++i)
-		{
-			if (dm->roads[i] != NULL)
-			{
-				line_free(dm->roads[i]);
-			}
-		}
 		free(dm->roads);
 		dm->roads = NULL;
 	}
 	if (dm->origRoads != NULL)
 	{
-		for (size_t i = 0; i < dm->numOrigRoads; ++i)
-		{
-			if (dm->origRoads[i] != NULL)
-			{
-				line_free(dm->origRoads[i]);
-			}
-		}
 		free(dm->origRoads);
 		dm->origRoads = NULL;
 	}
 
-	if (dm->relations != NULL)
-	{
-		free(dm->relations);
-		dm->relations = NULL;
-	}
-	if (dm->costs != NULL)
-	{
-		free(dm->costs);
-		dm->costs = NULL;
-	}
-	if (dm->juncPoints != NULL)
+	if (dm->junctions != NULL)
 	{
-		free(dm->juncPoints);
-		dm->juncPoints = NULL;
+		free(dm->junctions);
+		dm->junctions = NULL;
 	}
+	dm->numJunctions = 0;
+	dm->maxJunctions = 0;
+	pf_destroyGraph(&dm->graph);
 	if (dm->stopsDistMatrix != NULL)
 	{
 		free(dm->stopsDistMatrix);
@@ -909,5 +2250,12 @@ void dm_destroy(dataModel_t * restrict dm)
 		free(dm->shortestPath);
 		dm->shortestPath = NULL;
 	}
+
+	// Kõik ristmikud ja teed vabastatakse korraga
+	arena_destroy(&dm->arena);
+	// Id-d viitavad andmefaili ja kompileeritud kaardi sõnedele, seetõttu vabastatakse
+	// need viimasena
+	iniReader_destroy(&dm->dataFile);
+	fhelper_unmap(&dm->compiledMap);
 }
 
@@ -3,6 +3,7 @@
 
 #include "iniFile.h"
 #include "hashmap.h"
+#include "arena.h"
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -10,10 +11,19 @@
 
 #define MAX_ID 256
 #define DM_SVG_FONT "Calibri"
+#define DM_HILBERT_ORDER 16
+#define DM_HILBERT_MAX   ((1U << DM_HILBERT_ORDER) - 1U)
+#define DM_MAP_MAGIC     "DMAP"
+#define DM_MAP_VERSION   2U
+#define DM_MAP_ALIGN     8U
+
+#define DM_LOAD_CHUNK_MIN 65536U
+#define DM_NO_INTERN      UINT32_MAX
 
 /**
  * @brief Data structure that holds junction point's identifier string and it's coordinates.
- * Also holds identifying index to handling by Dijkstra's search algorithm.
+ * Also holds identifying index to handling by Dijkstra's search algorithm and the interned
+ * identifier, that stays the same for the lifetime of the data model.
  * 
  */
 typedef struct point
@@ -22,6 +32,9 @@ typedef struct point
 	float x, y;
 
 	size_t idx;
+	// Id sõne tihe täisarvuline tähis, määratakse laadimisel üks kord, võrdsete id-dega
+	// punktidel on sama internId. DM_NO_INTERN, kui punkt pole andmemudelis
+	uint32_t internId;
 
 } point_t;
 
@@ -36,21 +49,21 @@ void point_zero(point_t * restrict p);
  * from value string.
  * 
  * @param p Pointer to point structure
- * @param idstr Identifier string
+ * @param id Identifier string, point's id will be a view to it, so it must outlive the point
  * @param valuestr Value string with equivalent scanf format of "%f,%f"
  * @return true Success in initialization
  * @return false Failure
  */
-bool point_initStr(point_t * restrict p, const char * restrict idstr, const char * restrict valuestr);
+bool point_initStr(point_t * restrict p, const iniString_t * restrict id, const char * restrict valuestr);
 /**
  * @brief Equivalent of point_initStr, except the memory is allocated on the heap, initialises
  * point structure with string identifier and values from value string.
  * 
- * @param idstr Identifier string
+ * @param id Identifier string, point's id will be a view to it, so it must outlive the point
  * @param valuestr Value string with equivalent scanf format of "%f,%f"
  * @return point_t* Pointer to newly allocated & initialized point structure, NULL on failure
  */
-point_t * point_makeStr(const char * restrict idstr, const char * restrict valuestr);
+point_t * point_makeStr(const iniString_t * restrict id, const char * restrict valuestr);
 
 /**
  * @brief Destroys/frees resources of user-allocated point structure.
@@ -91,7 +104,7 @@ void line_zero(line_t * restrict l);
  * 
  * @param l Pointer to line structure
  * @param pointmap Pointer to constant-keyed hashmap of points/junctions
- * @param idstr Identifier string
+ * @param id Identifier string, line's id will be a view to it, so it must outlive the line
  * @param valuestr Value string, denotes 2 endpoint/junction identifiers with a pseudo-format of "%s,%s".
  * Can also include a cost of the road, then the pseudo-format is "%s,%s,%f".
  * @return true Success
@@ -99,8 +112,8 @@ void line_zero(line_t * restrict l);
  */
 bool line_initStr(
 	line_t * restrict l,
-	const hashMapCK_t * restrict pointmap,
-	const char * restrict idstr,
+	const hashMapOA_t * restrict pointmap,
+	const iniString_t * restrict id,
 	const char * restrict valuestr
 );
 /**
@@ -108,20 +121,20 @@ bool line_initStr(
  * and point identifiers.
  * 
  * @param pointmap Pointer to constant-keyed hashmap of points/junctions
- * @param idstr Identifier string
+ * @param id Identifier string, line's id will be a view to it, so it must outlive the line
  * @param valuestr Value string, denotes 2 endpoint/junction identifiers with a pseudo-format of "%s,%s"
  * @return line_t* Pointer to heap-allocated line structure, NULL on failure
  */
 line_t * line_makeStr(
-	const hashMapCK_t * restrict pointmap,
-	const char * restrict idstr,
+	const hashMapOA_t * restrict pointmap,
+	const iniString_t * restrict id,
 	const char * restrict valuestr
 );
 /**
  * @brief Initialises line structure with corresponding road identifier string and endpoints.
  * 
  * @param l Pointer to line structure
- * @param idstr Identifier string
+ * @param id Identifier string, line's id will be a view to it, so it must outlive the line
  * @param src Source point
  * @param dst Destination point
  * @param cost The cost of that particular road
@@ -130,7 +143,7 @@ line_t * line_makeStr(
  */
 bool line_init(
 	line_t * restrict l,
-	const char * restrict idstr,
+	const iniString_t * restrict id,
 	const point_t * restrict src,
 	const point_t * restrict dst,
 	float cost
@@ -139,14 +152,14 @@ bool line_init(
  * @brief Initialises & heap-allocated memory for line structure with corresponding
  * road identifier string and endpoints.
  * 
- * @param idstr Identifier string
+ * @param id Identifier string, line's id will be a view to it, so it must outlive the line
  * @param src Source point
  * @param dst Destination point
  * @param cost The cost of that particular road
  * @return line_t* Pointer to heap-allocated line structure, NULL on failure
  */
 line_t * line_make(
-	const char * restrict idstr,
+	const iniString_t * restrict id,
 	const point_t * restrict src,
 	const point_t * restrict dst,
 	float cost
@@ -209,6 +222,34 @@ typedef struct distActual
 
 } distActual_t;
 
+/**
+ * @brief Compressed road graph in CSR (compressed sparse row) form. Chains of junctions
+ * with exactly two neighbours are collapsed into single edges, intermediate junctions
+ * of every edge are kept in order from the source to the target for path unpacking.
+ * Weights and lengths are kept per road segment, so that summing them in path order
+ * gives exactly the same distances as the uncompressed graph.
+ * 
+ */
+typedef struct roadGraph
+{
+	size_t numJunctions, numNodes, numEdges;
+
+	// Sõlme indeks -> punkt, ristmiku indeks -> sõlme indeks (SIZE_MAX ahela sees)
+	const point_t ** nodes;
+	size_t * nodeIdx;
+
+	// Sõlme u servad on vahemikus [offsets[u], offsets[u + 1])
+	size_t * offsets;
+	size_t * targets;
+
+	// Serva e vahepunktid on vahemikus [chainOffsets[e], chainOffsets[e + 1]),
+	// lõigud vahemikus [chainOffsets[e] + e, chainOffsets[e + 1] + e + 1)
+	size_t * chainOffsets;
+	const point_t ** chainPoints;
+	float * segWeights, * segLengths;
+
+} roadGraph_t;
+
 #define MAX_MID_POINTS 14
 #define TOTAL_POINTS   (MAX_MID_POINTS + 2)
 #define START_IDX      0
@@ -240,8 +281,13 @@ typedef struct dataModel
 		const point_t * pointsp[TOTAL_POINTS];
 	};
 	size_t numMidPoints;
+	bool reachable[TOTAL_POINTS];
 
-	hashMapCK_t junctionMap, stopsMap;
+	hashMapOA_t junctionMap, stopsMap;
+	// Ristmike ja peatuste internId-d on vahemikus [0, numInternIds)
+	uint32_t numInternIds;
+	point_t ** junctions;
+	size_t numJunctions, maxJunctions;
 	
 	line_t ** roads;
 	size_t numRoads, maxRoads;
@@ -249,10 +295,7 @@ typedef struct dataModel
 	line_t ** origRoads;
 	size_t numOrigRoads;
 
-	uint8_t * relations;
-	float * costs;
-	const point_t ** juncPoints;
-	size_t numJunctions;
+	roadGraph_t graph;
 
 	distActual_t * stopsDistMatrix;
 
@@ -261,6 +304,16 @@ typedef struct dataModel
 	const point_t ** shortestPath;
 	size_t shortestPathLen;
 
+	// Andmefaili lugeja ja kompileeritud kaart, mille sõnedele punktide ja teede id-d viitavad
+	iniReader_t dataFile;
+	fhelperMap_t compiledMap;
+	// Kompileeritud kaardi ristmike täiuslik räsi, annab ristmiku indeksi mapJunctions massiivis
+	hashMapPH_t junctionHash;
+	point_t * mapJunctions;
+	size_t numMapJunctions;
+	// Ristmike ja teede mälu, vabastatakse korraga
+	arena_t arena;
+
 } dataModel_t;
 
 /**
@@ -273,19 +326,77 @@ typedef enum dmErr
 	dmeOK,
 	dmeMEM,
 	dmeSECTIONS,
-	dmeSTOPS_LIMIT
+	dmeSTOPS_LIMIT,
+	dmeFORMAT,
+	dmeUNREACHABLE
 
 } dmErr_t;
 
+/**
+ * @brief Options of loading the road network from a data file, zeroed options are
+ * the defaults. Junctions closer than mergeTolerance to an already loaded junction
+ * are merged into it and road endpoints are remapped accordingly, merging is disabled
+ * by default (tolerance 0). Junction and road sections larger than DM_LOAD_CHUNK_MIN
+ * bytes per thread are split at line starts and parsed concurrently by numThreads
+ * threads, road endpoints are resolved after all junctions are read. Results are
+ * identical to serial loading
+ * 
+ */
+typedef struct dmLoadOptions
+{
+	// Ristmike ühendamise kaugus, mittepositiivne väärtus keelab ühendamise
+	float mergeTolerance;
+	// Lugemise lõimede arv, 0 kasutab protsessorite arvu, 1 loeb järjest
+	size_t numThreads;
+
+} dmLoadOptions_t;
 
 /**
  * @brief Initialises dataModel structure with a data file
  * 
  * @param dm Pointer to dataModel structure
  * @param filename File name string of the data file
+ * @param opts Pointer to loading options, NULL uses the defaults
  * @return dmErr_t Error code, dmeOK on success
  */
-dmErr_t dm_initDataFile(dataModel_t * restrict dm, const char * restrict filename);
+dmErr_t dm_initDataFile(dataModel_t * restrict dm, const char * restrict filename, const dmLoadOptions_t * restrict opts);
+/**
+ * @brief Compiles the road network of a data file to a binary map image: junction
+ * coordinates, roads with costs, the id string table and a perfect hash of junction
+ * ids. Junction merging is applied before compiling, stops of the data file are not
+ * included.
+ * 
+ * @param filename File name string of the data file
+ * @param outname File name string of the binary map image
+ * @param opts Pointer to loading options, NULL uses the defaults
+ * @return dmErr_t Error code, dmeOK on success, dmeFORMAT if the network is too
+ * large for the image format or has a road with a non-positive cost
+ */
+dmErr_t dm_compileDataFile(const char * restrict filename, const char * restrict outname, const dmLoadOptions_t * restrict opts);
+/**
+ * @brief Initialises dataModel structure with a compiled binary map image and stops
+ * from a data file. The image is mapped to memory for the lifetime of the data model,
+ * ids and the junction id hash are views to it, nothing is parsed or hashed.
+ * 
+ * @param dm Pointer to dataModel structure
+ * @param mapname File name string of the binary map image made by dm_compileDataFile
+ * @param stopsname File name string of the data file with stops, other sections are
+ * skipped
+ * @return dmErr_t Error code, dmeOK on success, dmeFORMAT if the image is invalid
+ * or of a different version, also if a road joins a junction to itself or has a
+ * non-positive cost
+ */
+dmErr_t dm_initCompiled(dataModel_t * restrict dm, const char * restrict mapname, const char * restrict stopsname);
+/**
+ * @brief Finds a junction or a stop projection by its id. Junctions of a compiled map
+ * are resolved with its perfect hash by a single id comparison, other junctions with
+ * the junction hashmap
+ * 
+ * @param dm Pointer to dataModel structure
+ * @param id Null-terminated id string
+ * @return point_t* Pointer to the junction, NULL if not found
+ */
+point_t * dm_findJunction(const dataModel_t * restrict dm, const char * restrict id);
 /**
  * @brief Adds all stopping points as the nearest intersecting points with existing
  * roads to the the data model
@@ -305,14 +416,32 @@ bool dm_addStops(dataModel_t * restrict dm);
  */
 bool dm_addLine(dataModel_t * restrict dm, line_t * restrict pline);
 /**
- * @brief Updates junction indexes accordingly for the Dijsktra's algorithm
+ * @brief Updates junction indexes accordingly for the Dijsktra's algorithm. Junctions
+ * are numbered in the order of the Hilbert curve over their coordinates, so that
+ * junctions close to each other also get close indexes in all index-addressed arrays.
+ * Fills the junctions array in index order.
  * 
  * @param dm Pointer to dataModel structure
+ * @return true Success
+ * @return false Failure
  */
-void dm_updateJunctionIndexes(dataModel_t * restrict dm);
+bool dm_updateJunctionIndexes(dataModel_t * restrict dm);
 
 /**
- * @brief Creates relations matrix, costs matrix and points array
+ * @brief Checks with union-find whether all stops are in the same connected component
+ * of the road network, marks the results in the reachable array. Roads outside of the
+ * stops' component are removed and junction indexes are compacted, so later searches
+ * only visit that component, junctions outside of it get index SIZE_MAX and are
+ * removed from the junctions array.
+ * 
+ * @param dm Pointer to dataModel structure
+ * @return dmErr_t dmeOK if all stops are reachable from the starting point,
+ * dmeUNREACHABLE if some are not, dmeMEM on memory failure
+ */
+dmErr_t dm_checkConnectivity(dataModel_t * restrict dm);
+/**
+ * @brief Creates the compressed road graph and the shortest distances matrix
+ * between stops
  * 
  * @param dm Pointer to dataModel structure
  * @return true Success
@@ -1,3 +1,8 @@
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+	// madvise on POSIX-süsteemides
+	#define _DEFAULT_SOURCE
+#endif
+
 #include "fileHelper.h"
 #include "logger.h"
 
@@ -7,6 +12,14 @@
 #include <sys/stat.h>
 #include <assert.h>
 
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
 intptr_t fhelper_fileSize(const char * restrict fileName)
 {
 	struct stat fileStatus;
@@ -125,6 +138,133 @@ void * fhelper_readBin(const char * restrict fileName, size_t * restrict resultL
 	return mem;
 }
 
+static inline bool s_fhelper_map(fhelperMap_t * restrict map, const char * restrict fileName, bool copyOnWrite)
+{
+	assert(map != NULL);
+	assert(fileName != NULL);
+
+	// Tühja faili jaoks kuvandit ei tehta, vaade on siis lihtsalt tühi sõne
+	*map = (fhelperMap_t){
+		.data   = "",
+		.length = 0,
+		.view   = NULL
+	};
+
+#ifdef _WIN32
+	HANDLE hFile = CreateFileA(
+		fileName,
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		NULL,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+		NULL
+	);
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		writeLogger("Error opening file!");
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(hFile, &fileSize) || ((uint64_t)fileSize.QuadPart > (uint64_t)SIZE_MAX))
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+	else if (fileSize.QuadPart == 0)
+	{
+		CloseHandle(hFile);
+		return true;
+	}
+
+	HANDLE hMapping = CreateFileMappingA(hFile, NULL, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+	if (hMapping == NULL)
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+	void * view = MapViewOfFile(hMapping, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+	if (view == NULL)
+	{
+		CloseHandle(hMapping);
+		CloseHandle(hFile);
+		return false;
+	}
+
+	map->data     = view;
+	map->length   = (size_t)fileSize.QuadPart;
+	map->view     = view;
+	map->hFile    = hFile;
+	map->hMapping = hMapping;
+#else
+	int fd = open(fileName, O_RDONLY);
+	if (fd < 0)
+	{
+		writeLogger("Error opening file!");
+		return false;
+	}
+
+	struct stat fileStatus;
+	if ((fstat(fd, &fileStatus) < 0) || (fileStatus.st_size < 0) || ((uintmax_t)fileStatus.st_size > (uintmax_t)SIZE_MAX))
+	{
+		close(fd);
+		return false;
+	}
+	else if (fileStatus.st_size == 0)
+	{
+		close(fd);
+		return true;
+	}
+
+	const size_t length = (size_t)fileStatus.st_size;
+	void * view = mmap(NULL, length, copyOnWrite ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_PRIVATE, fd, 0);
+	// Kuvand jääb kehtima ka pärast faili sulgemist
+	close(fd);
+	if (view == MAP_FAILED)
+	{
+		return false;
+	}
+	// Fail loetakse algusest lõpuni, operatsioonisüsteem võib ette lugeda
+	madvise(view, length, MADV_SEQUENTIAL);
+
+	map->data   = view;
+	map->length = length;
+	map->view   = view;
+#endif
+
+	writeLogger("File mapped, size: %zu bytes", map->length);
+
+	return true;
+}
+bool fhelper_map(fhelperMap_t * restrict map, const char * restrict fileName)
+{
+	return s_fhelper_map(map, fileName, false);
+}
+bool fhelper_mapCopy(fhelperMap_t * restrict map, const char * restrict fileName)
+{
+	// Kirjutamisel kopeeritakse ainult muudetud lehed, fail ise jääb puutumata
+	return s_fhelper_map(map, fileName, true);
+}
+void fhelper_unmap(fhelperMap_t * restrict map)
+{
+	assert(map != NULL);
+
+	if (map->view != NULL)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(map->view);
+		CloseHandle(map->hMapping);
+		CloseHandle(map->hFile);
+#else
+		munmap(map->view, map->length);
+#endif
+	}
+	map->data   = NULL;
+	map->length = 0;
+	map->view   = NULL;
+}
+
 intptr_t fhelper_write(const char * fileName, const char * string, intptr_t stringLength)
 {
 	assert(fileName != NULL);
@@ -157,7 +297,7 @@ intptr_t fhelper_writeBin(const char * fileName, const void * data, size_t dataL
 	}
 
 	// Kirjutada õnnestunud baitide arv jäetakse meelde, see tagastatakse kasutajale
-	intptr_t writtenBytes = (intptr_t)fwrite(data, dataLength, 1, file);
+	intptr_t writtenBytes = (intptr_t)fwrite(data, 1, dataLength, file);
 	fclose(file);
 
 	return writtenBytes;
@@ -2,6 +2,25 @@
 #define FILE_HELPER_H
 
 #include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Data structure for a memory-mapped view of a file, view is writable only
+ * when created by fhelper_mapCopy
+ * 
+ */
+typedef struct fhelperMap
+{
+	const char * data;
+	size_t length;
+
+	void * view;
+#ifdef _WIN32
+	void * hFile, * hMapping;
+#endif
+
+} fhelperMap_t;
 
 /**
  * @brief Calculates files size
@@ -31,6 +50,35 @@ char * fhelper_read(const char * restrict fileName, size_t * restrict resultLeng
  */
 void * fhelper_readBin(const char * restrict fileName, size_t * restrict resultLength);
 
+/**
+ * @brief Maps file contents to memory as a read-only view, the operating system is
+ * advised that the view is read sequentially. No copy of the data is made.
+ * 
+ * @param map Pointer to fhelperMap structure receiving the view
+ * @param fileName Pointer to character array of desired filename
+ * @return true Success, map->data points to map->length bytes, NB! Data is NOT null-terminated!
+ * Empty file gives a valid zero-length view.
+ * @return false Failure
+ */
+bool fhelper_map(fhelperMap_t * restrict map, const char * restrict fileName);
+/**
+ * @brief Maps file contents to memory as a private copy-on-write view, writes through
+ * map->view change only the process' own copy of the touched pages, never the file
+ * 
+ * @param map Pointer to fhelperMap structure receiving the view
+ * @param fileName Pointer to character array of desired filename
+ * @return true Success, map->view points to map->length writable bytes (NULL for an
+ * empty file), NB! Data is NOT null-terminated!
+ * @return false Failure
+ */
+bool fhelper_mapCopy(fhelperMap_t * restrict map, const char * restrict fileName);
+/**
+ * @brief Unmaps file view created by fhelper_map or fhelper_mapCopy
+ * 
+ * @param map Pointer to fhelperMap structure
+ */
+void fhelper_unmap(fhelperMap_t * restrict map);
+
 /**
  * @brief Writes array contents to file in text mode
  * 
@@ -1,10 +1,128 @@
 #include "hashmap.h"
+#include "threadHelper.h"
 
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <stdatomic.h>
 
-hashNode_t * hashNode_make(const char * key, void * value)
+/**
+ * @brief Secret constants of wyhash
+ * 
+ */
+static const uint64_t s_hashMap_secret[4] = {
+	UINT64_C(0x2d358dccaa6c78a5),
+	UINT64_C(0x8bb84b93962eacc9),
+	UINT64_C(0x4b33a62ed433d4a3),
+	UINT64_C(0x4d5a2da51de1aa47)
+};
+
+/**
+ * @brief Multiplies 2 64-bit numbers to a 128-bit product, stores the lower half
+ * in a and the upper half in b
+ * 
+ */
+static inline void s_hashMap_mum(uint64_t * restrict a, uint64_t * restrict b)
+{
+#if defined(__SIZEOF_INT128__)
+	__extension__ typedef unsigned __int128 hashU128_t;
+	const hashU128_t r = (hashU128_t)*a * *b;
+	*a = (uint64_t)r;
+	*b = (uint64_t)(r >> 64);
+#else
+	// 32-bitiste osade kaupa korrutamine
+	const uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+	const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	const uint64_t t = rl + (rm0 << 32);
+	uint64_t carry = t < rl;
+	const uint64_t lo = t + (rm1 << 32);
+	carry += lo < t;
+	*a = lo;
+	*b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+}
+static inline uint64_t s_hashMap_mix(uint64_t a, uint64_t b)
+{
+	s_hashMap_mum(&a, &b);
+	return a ^ b;
+}
+static inline uint64_t s_hashMap_read8(const char * p)
+{
+	uint64_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+static inline uint64_t s_hashMap_read4(const char * p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+uint64_t hashMap_hashFull(const char * key, size_t keyLen)
+{
+	assert((key != NULL) || (keyLen == 0));
+
+	// Loetakse 4 või 8 baiti korraga, võtmed on enamasti lühemad kui 16 baiti
+	const unsigned char * ukey = (const unsigned char *)key;
+	uint64_t seed = s_hashMap_mix(s_hashMap_secret[0], s_hashMap_secret[1]), a, b;
+	if (keyLen <= 16)
+	{
+		if (keyLen >= 4)
+		{
+			const size_t off = (keyLen >> 3) << 2;
+			a = (s_hashMap_read4(key) << 32) | s_hashMap_read4(key + off);
+			b = (s_hashMap_read4(key + keyLen - 4) << 32) | s_hashMap_read4(key + keyLen - 4 - off);
+		}
+		else if (keyLen > 0)
+		{
+			a = ((uint64_t)ukey[0] << 16) | ((uint64_t)ukey[keyLen >> 1] << 8) | (uint64_t)ukey[keyLen - 1];
+			b = 0;
+		}
+		else
+		{
+			a = 0;
+			b = 0;
+		}
+	}
+	else
+	{
+		size_t i = keyLen;
+		const char * p = key;
+		for (; i > 16; i -= 16, p += 16)
+		{
+			seed = s_hashMap_mix(s_hashMap_read8(p) ^ s_hashMap_secret[1], s_hashMap_read8(p + 8) ^ seed);
+		}
+		a = s_hashMap_read8(p + i - 16);
+		b = s_hashMap_read8(p + i - 8);
+	}
+	a ^= s_hashMap_secret[1];
+	b ^= seed;
+	s_hashMap_mum(&a, &b);
+	return s_hashMap_mix(a ^ s_hashMap_secret[0] ^ (uint64_t)keyLen, b ^ s_hashMap_secret[1]);
+}
+size_t hashMap_hash(const char * key, size_t mapSize)
+{
+	assert(key != NULL);
+	assert(mapSize > 0);
+
+	return (size_t)(hashMap_hashFull(key, strlen(key)) % mapSize);
+}
+size_t hashMap_hashLen(const char * key, size_t keyLen, size_t mapSize)
+{
+	assert((key != NULL) || (keyLen == 0));
+	assert(mapSize > 0);
+
+	// Sama räsi mis hashMap_hash'il, lõpp on määratud pikkusega
+	return (size_t)(hashMap_hashFull(key, keyLen) % mapSize);
+}
+
+
+/**
+ * @brief Creates hashtable's node with already calculated hash of the key
+ * 
+ */
+static inline hashNode_t * s_hashNode_make(const char * key, uint64_t hash, void * value)
 {
 	assert(key != NULL);
 	
@@ -23,9 +141,16 @@ hashNode_t * hashNode_make(const char * key, void * value)
 		return NULL;
 	}
 	node->value = value;
+	node->hash  = hash;
 	node->next  = NULL;
 	return node;
 }
+hashNode_t * hashNode_make(const char * key, void * value)
+{
+	assert(key != NULL);
+
+	return s_hashNode_make(key, hashMap_hashFull(key, strlen(key)), value);
+}
 void hashNode_free(hashNode_t * restrict self)
 {
 	assert(self != NULL);
@@ -48,7 +173,7 @@ void hashNode_recursiveFree(hashNode_t * restrict self)
 	}
 }
 
-hashNodeCK_t * hashNodeCK_make(const char * key, void * value)
+static inline hashNodeCK_t * s_hashNodeCK_make(const char * key, uint64_t hash, void * value)
 {
 	assert(key != NULL);
 	
@@ -59,9 +184,16 @@ hashNodeCK_t * hashNodeCK_make(const char * key, void * value)
 	}
 	node->key   = key;
 	node->value = value;
+	node->hash  = hash;
 	node->next  = NULL;
 	return node;
 }
+hashNodeCK_t * hashNodeCK_make(const char * key, void * value)
+{
+	assert(key != NULL);
+
+	return s_hashNodeCK_make(key, hashMap_hashFull(key, strlen(key)), value);
+}
 void hashNodeCK_free(hashNodeCK_t * restrict self)
 {
 	assert(self != NULL);
@@ -149,10 +281,12 @@ void hashMap_zero(hashMap_t * restrict self)
 	assert(self != NULL);
 
 	*self = (hashMap_t){
-		.nodes    = NULL,
-		.numNodes = 0,
-		.numItems = 0
+		.nodes     = NULL,
+		.numNodes  = 0,
+		.numItems  = 0,
+		.freeNodes = NULL
 	};
+	arena_init(&self->pool, 0);
 }
 bool hashMap_init(hashMap_t * restrict self, size_t minSize)
 {
@@ -162,10 +296,13 @@ bool hashMap_init(hashMap_t * restrict self, size_t minSize)
 	// Räsitabelitel on oluline, et "ämbrite/bucketite" arv oleks algarv, see vähendab oluliselt
 	// konfliktide teket räsi arvutamisel (sest tuleb leida jagamise jääk ämbrite arvuga jagamisel)
 	// ning suurendab seega jõudlust nii elementide lisamisel, leidmisel kui ka eemaldamisel.
-	self->numNodes = s_hashMap_findNextPrime(minSize);
-	self->numItems = 0;
+	self->numNodes  = s_hashMap_findNextPrime(minSize);
+	self->numItems  = 0;
+	self->freeNodes = NULL;
+	// Sõlmed võetakse räsitabeli enda mälupuhvrist, mälu küsitakse alles esimesel lisamisel
+	arena_init(&self->pool, 0);
 	// Allokeeritakse vajalik mälu, kontrollitakse õnnestumist
-	self->nodes    = malloc(self->numNodes * sizeof(hashNode_t *));
+	self->nodes     = malloc(self->numNodes * sizeof(hashNode_t *));
 	if (self->nodes == NULL)
 	{
 		return false;
@@ -197,6 +334,8 @@ hashMap_t * hashMap_make(size_t minSize)
 	return map;
 }
 
+static bool s_hashMap_insertHash(hashMap_t * restrict self, const char * key, uint64_t hash, void * value);
+
 bool hashMap_initCopy(hashMap_t * restrict self, size_t minSize, const hashMap_t * restrict other)
 {
 	assert(self != NULL);
@@ -208,13 +347,13 @@ bool hashMap_initCopy(hashMap_t * restrict self, size_t minSize, const hashMap_t
 		return false;
 	}
 
-	// Elemendid kopeeritakse ühest räsitabelist teise
+	// Elemendid kopeeritakse ühest räsitabelist teise, räsi võetakse sõlmest
 	for (size_t i = 0; i < other->numNodes; ++i)
 	{
 		hashNode_t * node = other->nodes[i];
 		while (node != NULL)
 		{
-			if (!hashMap_insert(self, node->key, node->value))
+			if (!s_hashMap_insertHash(self, node->key, node->hash, node->value))
 			{
 				// Kui tabelist "other" koopia tegemine ebaõnnestub, siis on garanteeriutd, et see jääb puutumata
 				hashMap_destroy(self);
@@ -251,35 +390,72 @@ bool hashMap_resize(hashMap_t * restrict self, size_t minSize)
 	assert(self != NULL);
 	assert(minSize > 0);
 
-	hashMap_t newMap;
-	if (!hashMap_initCopy(&newMap, minSize, self))
+	const size_t numNodes = s_hashMap_findNextPrime(minSize);
+	hashNode_t ** nodes = malloc(numNodes * sizeof(hashNode_t *));
+	if (nodes == NULL)
 	{
 		// Kui suuruse muutmine ebaõnnestub, siis on garantii, et andmed ei lähe kaotsi
 		return false;
 	}
+	for (size_t i = 0; i < numNodes; ++i)
+	{
+		nodes[i] = NULL;
+	}
 
-	// Vana räsitabel hävitatakse
-	hashMap_destroy(self);
-	// Praegune räsitabel pannakse uuega võrduma
-	*self = newMap;
+	// Sõlmed tõstetakse uutesse "bucketitesse" ümber, neid ei kopeerita ega räsita uuesti
+	for (size_t i = 0; i < self->numNodes; ++i)
+	{
+		hashNode_t * node = self->nodes[i];
+		while (node != NULL)
+		{
+			hashNode_t * next = node->next;
+			hashNode_t ** pbucket = &nodes[node->hash % numNodes];
+			node->next = *pbucket;
+			*pbucket   = node;
+			node = next;
+		}
+	}
+
+	// Vana "bucketite" massiiv vabastatakse ja asendatakse uuega
+	free(self->nodes);
+	self->nodes    = nodes;
+	self->numNodes = numNodes;
 	return true;
 }
-size_t hashMap_hash(const char * key, size_t mapSize)
+/**
+ * @brief Takes a node with a copy of the key from the map's pool, reuses the first
+ * removed node, if the new key fits into the memory of its old key
+ * 
+ */
+static inline hashNode_t * s_hashMap_allocNode(hashMap_t * restrict self, const char * key, uint64_t hash, void * value)
 {
-	assert(key != NULL);
-	assert(mapSize > 0);
-
-	size_t hash = 0;
-	for (; *key != '\0'; ++key)
+	// Võti hoitakse sõlmega samas mälutükis vahetult sõlme järel
+	const size_t keyLen = strlen(key);
+	hashNode_t * node = self->freeNodes;
+	if ((node != NULL) && (strlen(node->key) >= keyLen))
+	{
+		self->freeNodes = node->next;
+	}
+	else
 	{
-		// Räsi arvutamisel eelistan kasutatada jällegi algarve, sest see tagab väiksema
-		// tõenäosuse konfliktide tekkeks räsitabelisse elementide paigutamisel
-		hash = (size_t)(hash * (size_t)37) + (size_t)*key;
+		node = arena_alloc(&self->pool, sizeof(hashNode_t) + keyLen + 1);
+		if (node == NULL)
+		{
+			return NULL;
+		}
+		node->key = (char *)(node + 1);
 	}
-	return hash % mapSize;
+	memcpy(node->key, key, keyLen + 1);
+	node->value = value;
+	node->hash  = hash;
+	node->next  = NULL;
+	return node;
 }
-
-bool hashMap_insert(hashMap_t * restrict self, const char * key, void * value)
+/**
+ * @brief Inserts a new "key" with already calculated hash to the hashmap
+ * 
+ */
+static bool s_hashMap_insertHash(hashMap_t * restrict self, const char * key, uint64_t hash, void * value)
 {
 	assert(self != NULL);
 	assert(key  != NULL);
@@ -295,13 +471,14 @@ bool hashMap_insert(hashMap_t * restrict self, const char * key, void * value)
 	}
 
 	// Esmalt leiab räsi põhjal sobiva "bucketi" aadressi
-	hashNode_t ** pnode = &self->nodes[hashMap_hash(key, self->numNodes)];
+	hashNode_t ** pnode = &self->nodes[hash % self->numNodes];
 
 	// Kui sellele "bucketi" aadressile on lingitud loend juba tehtud, siis minnakse lingitud loendi lõppu
 	// Kui selgub, et sellise "võtmega" element juba leidub räsitabelis, siis tagastakse viga näitav 'false'
+	// Võtmeid võrreldakse ainult räsi kokkulangemisel
 	while ((*pnode) != NULL)
 	{
-		if (strcmp((*pnode)->key, key) == 0)
+		if (((*pnode)->hash == hash) && (strcmp((*pnode)->key, key) == 0))
 		{
 			return false;
 		}
@@ -309,7 +486,7 @@ bool hashMap_insert(hashMap_t * restrict self, const char * key, void * value)
 	}
 
 	// Tehakse uus liige lingitud loendisse
-	hashNode_t * node = hashNode_make(key, value);
+	hashNode_t * node = s_hashMap_allocNode(self, key, hash, value);
 	if (node == NULL)
 	{
 		return false;
@@ -321,6 +498,13 @@ bool hashMap_insert(hashMap_t * restrict self, const char * key, void * value)
 	++self->numItems;
 	return true;
 }
+bool hashMap_insert(hashMap_t * restrict self, const char * key, void * value)
+{
+	assert(self != NULL);
+	assert(key  != NULL);
+
+	return s_hashMap_insertHash(self, key, hashMap_hashFull(key, strlen(key)), value);
+}
 hashNode_t * hashMap_get(const hashMap_t * restrict self, const char * key)
 {
 	assert(self != NULL);
@@ -334,13 +518,14 @@ hashNode_t * hashMap_get(const hashMap_t * restrict self, const char * key)
 	}
 
 	// Leitakse "võtme" räsi põhjal eeldatav "bucket"
-	hashNode_t * node = self->nodes[hashMap_hash(key, self->numNodes)];
+	const uint64_t hash = hashMap_hashFull(key, strlen(key));
+	hashNode_t * node = self->nodes[hash % self->numNodes];
 
 	// Otsitakse lingitud loendist sobiva "võtmega" elementi
 	while (node != NULL)
 	{
-		// "Võti" sobib, s.o erinevus nende vahel on 0
-		if (strcmp(node->key, key) == 0)
+		// "Võti" sobib, s.o räsid on võrdsed ja erinevus nende vahel on 0
+		if ((node->hash == hash) && (strcmp(node->key, key) == 0))
 		{
 			// Tagastakse dünaamiliselt allokeeritud element, s.o andmestruktuuri aadress
 			return node;
@@ -363,12 +548,13 @@ void * hashMap_remove(hashMap_t * restrict self, const char * key)
 	}
 
 	// Leitakse etteantud "võtme" põhjal tema räsile vastav "bucketi" aadress
-	hashNode_t ** pnode = &self->nodes[hashMap_hash(key, self->numNodes)];
+	const uint64_t hash = hashMap_hashFull(key, strlen(key));
+	hashNode_t ** pnode = &self->nodes[hash % self->numNodes];
 	// Otsitakse üles vastav võti
 	while ((*pnode) != NULL)
 	{
 		// Võti leiti
-		if (strcmp((*pnode)->key, key) == 0)
+		if (((*pnode)->hash == hash) && (strcmp((*pnode)->key, key) == 0))
 		{
 			hashNode_t * node = *pnode;
 			// Eemaldatud elemendi väärtus talletatakse
@@ -377,8 +563,9 @@ void * hashMap_remove(hashMap_t * restrict self, const char * key)
 			// Sellega eemaldatakse hõlpsasti lingitud loendist element
 			*pnode = node->next;
 
-			// Eemaldatud elemendi dünaamiliselt allokeeritud mälu vabastakse
-			hashNode_free(node);
+			// Eemaldatud element lisatakse vabade sõlmede nimistusse taaskasutamiseks
+			node->next      = self->freeNodes;
+			self->freeNodes = node;
 
 			// Vähendatakse informatiivset elementide arvu räsitabelis
 			--self->numItems;
@@ -406,14 +593,13 @@ void hashMap_destroy(hashMap_t * restrict self)
 		return;
 	}
 
-	// Kõik "bucketites" olevate lingitud lonedite mälu vabastatakse ükshaaval
-	for (size_t i = 0; i < self->numNodes; ++i)
-	{
-		hashNode_recursiveFree(self->nodes[i]);
-	}
+	// Kõigi sõlmede ja võtmete mälu vabastatakse puhvri plokkide kaupa
+	arena_destroy(&self->pool);
+	self->freeNodes = NULL;
 
 	// Lõpuks vabastakse ka "bucketite" massiivi mälu
 	free(self->nodes);
+	self->nodes = NULL;
 }
 void hashMap_free(hashMap_t * restrict self)
 {
@@ -425,223 +611,1372 @@ void hashMap_free(hashMap_t * restrict self)
 }
 
 
-void hashMapCK_zero(hashMapCK_t * restrict self)
+/**
+ * @brief Allocates an array of numNodes empty "buckets"
+ * 
+ */
+static inline hashNodeCK_t ** s_hashMapCK_makeSlots(size_t numNodes)
 {
-	assert(self != NULL);
-
-	*self = (hashMapCK_t){
-		.nodes    = NULL,
-		.numNodes = 0,
-		.numItems = 0
-	};
+	hashNodeCK_t ** nodes = malloc(numNodes * sizeof(hashNodeCK_t *));
+	if (nodes == NULL)
+	{
+		return NULL;
+	}
+	for (size_t i = 0; i < numNodes; ++i)
+	{
+		nodes[i] = NULL;
+	}
+	return nodes;
 }
-bool hashMapCK_init(hashMapCK_t * restrict self, size_t minSize)
+/**
+ * @brief Relinks all nodes of a chain to the "buckets" of given slot-array, nodes
+ * aren't copied and keys aren't hashed again
+ * 
+ */
+static inline void s_hashMapCK_relink(hashNodeCK_t ** restrict nodes, size_t numNodes, hashNodeCK_t * node)
 {
-	assert(self != NULL);
-	assert(minSize > 0);
-
-	self->numNodes = s_hashMap_findNextPrime(minSize);
-	self->numItems = 0;
-	self->nodes    = malloc(self->numNodes * sizeof(hashNodeCK_t *));
-	if (self->nodes == NULL)
+	while (node != NULL)
 	{
-		return false;
+		hashNodeCK_t * next = node->next;
+		hashNodeCK_t ** pbucket = &nodes[node->hash % numNodes];
+		node->next = *pbucket;
+		*pbucket   = node;
+		node = next;
 	}
-	for (size_t i = 0; i < self->numNodes; ++i)
+}
+
+/**
+ * @brief Node of a concurrent hashMapCK. Lookups copy the embedded node to the
+ * snapshot of the calling thread, the "next" of the embedded node isn't used
+ * 
+ */
+typedef struct hashNodeConcurrent
+{
+	hashNodeCK_t node;
+	_Atomic(struct hashNodeConcurrent *) next;
+	// Link in the stripe's list of removed or free nodes
+	struct hashNodeConcurrent * freeNext;
+} hashNodeConcurrent_t, hashNodeCC_t;
+
+/**
+ * @brief Slot-array of a concurrent hashMapCK, number of slots is a power of two, so
+ * that every bucket belongs to the stripe given by the lowest bits of the hash
+ * 
+ */
+typedef struct hashTableConcurrent
+{
+	size_t numNodes;
+	_Atomic(hashNodeCC_t *) nodes[];
+} hashTableConcurrent_t, hashTableCC_t;
+
+/**
+ * @brief Write lock stripe of a concurrent hashMapCK with its own node pool
+ * 
+ */
+typedef struct hashStripeConcurrent
+{
+	thelperMutex_t lock;
+	arena_t pool;
+	hashNodeCC_t * freeNodes;
+	// Removed nodes waiting for a grace period
+	hashNodeCC_t * retired;
+	size_t numRetired;
+} hashStripeConcurrent_t, hashStripeCC_t;
+
+struct hashMapCKConcurrent
+{
+	_Atomic(hashTableCC_t *) table;
+	atomic_size_t numItems;
+
+	// Lookups count themselves in by the parity of the epoch, a grace period switches
+	// the epoch and waits until the count of the previous parity drops to zero
+	atomic_size_t epoch;
+	atomic_size_t readers[2];
+	thelperMutex_t graceLock;
+
+	hashStripeCC_t stripes[HASHMAPCK_STRIPES];
+};
+
+// Otsingu tulemus kopeeritakse lõime enda sõlme, sest leitud sõlm võidakse pärast
+// otsingu lõppu taaskasutada
+static _Thread_local hashNodeCK_t s_hashMapCK_snapshot;
+
+/**
+ * @brief Starts a lookup of a concurrent hashMapCK, memory reachable from the current
+ * slot-array isn't reclaimed until the lookup ends
+ * 
+ * @return size_t Epoch the lookup was counted in
+ */
+static inline size_t s_hashMapCC_readBegin(struct hashMapCKConcurrent * restrict cc)
+{
+	// Kui epohh vahetus loenduri suurendamise ajal, võib kirjutaja vana paarsuse lugejaid
+	// juba loendamas olla, seega proovitakse uue epohhiga uuesti
+	for (;;)
 	{
-		self->nodes[i] = NULL;
+		const size_t epoch = atomic_load(&cc->epoch);
+		atomic_fetch_add(&cc->readers[epoch & 1], 1);
+		if (atomic_load(&cc->epoch) == epoch)
+		{
+			return epoch;
+		}
+		atomic_fetch_sub(&cc->readers[epoch & 1], 1);
 	}
-	return true;
 }
-hashMapCK_t * hashMapCK_make(size_t minSize)
+static inline void s_hashMapCC_readEnd(struct hashMapCKConcurrent * restrict cc, size_t epoch)
 {
-	assert(minSize > 0);
-
-	hashMapCK_t * map = malloc(sizeof(hashMapCK_t));
-	if (map == NULL)
+	atomic_fetch_sub_explicit(&cc->readers[epoch & 1], 1, memory_order_release);
+}
+/**
+ * @brief Waits for a grace period, after that no lookup can reach memory that was
+ * unlinked before the call. Lookups don't wait for it.
+ * 
+ */
+static inline void s_hashMapCC_synchronize(struct hashMapCKConcurrent * restrict cc)
+{
+	// Ooteajad on järjestatud, seega on eelmise paarsuse lugejad eelmise ooteajaga juba
+	// lahkunud ja praeguse paarsuse lugejad lõpetavad ilma uute lisandumiseta
+	thelper_mutexLock(&cc->graceLock);
+	const size_t epoch = atomic_fetch_add(&cc->epoch, 1);
+	while (atomic_load(&cc->readers[epoch & 1]) != 0)
 	{
-		return NULL;
+		thelper_yield();
 	}
-
-	if (hashMapCK_init(map, minSize) == false)
+	thelper_mutexUnlock(&cc->graceLock);
+}
+/**
+ * @brief Waits for a grace period and moves the removed nodes of a stripe to its free
+ * list, caller has to hold the lock of the stripe
+ * 
+ */
+static inline void s_hashMapCC_reclaim(struct hashMapCKConcurrent * restrict cc, hashStripeCC_t * restrict stripe)
+{
+	s_hashMapCC_synchronize(cc);
+	while (stripe->retired != NULL)
 	{
-		free(map);
-		return NULL;
+		hashNodeCC_t * node = stripe->retired;
+		stripe->retired   = node->freeNext;
+		node->freeNext    = stripe->freeNodes;
+		stripe->freeNodes = node;
 	}
-
-	return map;
+	stripe->numRetired = 0;
 }
-
-bool hashMapCK_initCopy(hashMapCK_t * restrict self, size_t minSize, const hashMapCK_t * restrict other)
+/**
+ * @brief Takes a node from the free list or the pool of the stripe, caller has to hold
+ * the lock of the stripe
+ * 
+ */
+static inline hashNodeCC_t * s_hashMapCC_allocNode(hashStripeCC_t * restrict stripe, const char * key, uint64_t hash, void * value)
 {
-	assert(self != NULL);
-	assert(minSize > 0);
-	assert(other != NULL);
-	
-	if (!hashMapCK_init(self, minSize))
+	hashNodeCC_t * node = stripe->freeNodes;
+	if (node != NULL)
 	{
-		return false;
+		stripe->freeNodes = node->freeNext;
 	}
-
-	for (size_t i = 0; i < other->numNodes; ++i)
+	else if ((node = arena_alloc(&stripe->pool, sizeof(hashNodeCC_t))) == NULL)
 	{
-		hashNodeCK_t * node = other->nodes[i];
-		while (node != NULL)
-		{
-			if (!hashMapCK_insert(self, node->key, node->value))
-			{
-				hashMapCK_destroy(self);
-				return false;
-			}
-			node = node->next;
-		}
+		return NULL;
 	}
-
-	return true;
+	node->node = (hashNodeCK_t){
+		.key   = key,
+		.value = value,
+		.hash  = hash,
+		.next  = NULL
+	};
+	atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+	node->freeNext = NULL;
+	return node;
 }
-hashMapCK_t * hashMapCK_makeCopy(size_t minSize, const hashMapCK_t * restrict other)
+static inline hashTableCC_t * s_hashMapCC_makeTable(size_t minSize)
 {
-	assert(minSize > 0);
-	assert(other != NULL);
+	size_t numNodes = HASHMAPCK_STRIPES;
+	while ((numNodes < minSize) && (numNodes <= (SIZE_MAX / 2 / sizeof(hashNodeCC_t *))))
+	{
+		numNodes *= 2;
+	}
 
-	hashMapCK_t * mem = malloc(sizeof(hashMapCK_t));
-	if (mem == NULL)
+	hashTableCC_t * table = malloc(sizeof(hashTableCC_t) + (numNodes * sizeof(_Atomic(hashNodeCC_t *))));
+	if (table == NULL)
 	{
 		return NULL;
 	}
-	else if (!hashMapCK_initCopy(mem, minSize, other))
+	table->numNodes = numNodes;
+	for (size_t i = 0; i < numNodes; ++i)
 	{
-		free(mem);
-		return NULL;
+		atomic_init(&table->nodes[i], NULL);
 	}
-
-	return mem;
+	return table;
 }
-
-bool hashMapCK_resize(hashMapCK_t * restrict self, size_t minSize)
+/**
+ * @brief Finds the link pointing to the node with given key, returns the terminating
+ * NULL-link of the bucket, if the key wasn't found. Safe both for lookups and for
+ * writers holding the lock of the key's stripe.
+ * 
+ */
+static inline _Atomic(hashNodeCC_t *) * s_hashMapCC_find(hashTableCC_t * restrict table, const char * key, size_t keyLen, uint64_t hash)
 {
-	assert(self != NULL);
-	assert(minSize > 0);
-
-	hashMapCK_t newMap;
-	if (!hashMapCK_initCopy(&newMap, minSize, self))
+	_Atomic(hashNodeCC_t *) * plink = &table->nodes[hash & (table->numNodes - 1)];
+	hashNodeCC_t * node;
+	while ((node = atomic_load_explicit(plink, memory_order_acquire)) != NULL)
 	{
-		return false;
+		if ((node->node.hash == hash) && (strncmp(node->node.key, key, keyLen) == 0) && (node->node.key[keyLen] == '\0'))
+		{
+			return plink;
+		}
+		plink = &node->next;
 	}
-
-	// Destroy old hashmap
-	hashMapCK_destroy(self);
-	*self = newMap;
-	return true;
+	return plink;
 }
-
-bool hashMapCK_insert(hashMapCK_t * restrict self, const char * key, void * value)
+static inline hashNodeCK_t * s_hashMapCC_get(const hashMapCK_t * restrict self, const char * key, size_t keyLen)
 {
-	assert(self != NULL);
-	assert(key  != NULL);
-	assert(self->nodes != NULL);
+	struct hashMapCKConcurrent * cc = self->concurrent;
+	const uint64_t hash = hashMap_hashFull(key, keyLen);
 
-	// Kui räsitabel on "küllastunud", proovib mälu juurde allokeerida
-	if (self->numItems >= self->numNodes)
+	const size_t epoch = s_hashMapCC_readBegin(cc);
+	hashTableCC_t * table = atomic_load_explicit(&cc->table, memory_order_acquire);
+	const hashNodeCC_t * node = atomic_load_explicit(s_hashMapCC_find(table, key, keyLen, hash), memory_order_acquire);
+	if (node != NULL)
 	{
-		// Tagastusväärtust ei kontrollita, kui see ebaõnnestub, siis säilub esialgne räsitabel, mis hakkab olema "üleküllastunud"
-		hashMapCK_resize(self, (self->numItems + 1) * 2);
+		s_hashMapCK_snapshot = node->node;
 	}
+	s_hashMapCC_readEnd(cc, epoch);
 
-	hashNodeCK_t ** pnode = &self->nodes[hashMap_hash(key, self->numNodes)];
-
-	while ((*pnode) != NULL)
+	return (node != NULL) ? &s_hashMapCK_snapshot : NULL;
+}
+static bool s_hashMapCC_resize(hashMapCK_t * restrict self, size_t minSize);
+static inline bool s_hashMapCC_insertHash(hashMapCK_t * restrict self, const char * key, uint64_t hash, void * value)
+{
+	struct hashMapCKConcurrent * cc = self->concurrent;
+	hashStripeCC_t * stripe = &cc->stripes[hash & (HASHMAPCK_STRIPES - 1)];
+
+	thelper_mutexLock(&stripe->lock);
+	// Massiivi vahetab ainult kõik triibud lukustav suuruse muutmine
+	hashTableCC_t * table = atomic_load_explicit(&cc->table, memory_order_relaxed);
+	const size_t numNodes = table->numNodes;
+	_Atomic(hashNodeCC_t *) * plink = s_hashMapCC_find(table, key, strlen(key), hash);
+	hashNodeCC_t * node = NULL;
+	if ((atomic_load_explicit(plink, memory_order_relaxed) == NULL) &&
+		((node = s_hashMapCC_allocNode(stripe, key, hash, value)) != NULL))
 	{
-		if (strcmp((*pnode)->key, key) == 0)
-		{
-			return false;
-		}
-		pnode = &(*pnode)->next;
+		// Sõlme väljad jõuavad lugejateni enne sõlme enda aadressi
+		atomic_store_explicit(plink, node, memory_order_release);
 	}
+	thelper_mutexUnlock(&stripe->lock);
 
-	hashNodeCK_t * node = hashNodeCK_make(key, value);
 	if (node == NULL)
 	{
 		return false;
 	}
-
-	*pnode = node;
-	++self->numItems;
+	const size_t numItems = atomic_fetch_add(&cc->numItems, 1) + 1;
+	if (numItems > numNodes)
+	{
+		// Ebaõnnestumisel jääb alles praegune, "üleküllastunud" massiiv
+		s_hashMapCC_resize(self, numItems * 2);
+	}
 	return true;
 }
-hashNodeCK_t * hashMapCK_get(const hashMapCK_t * restrict self, const char * key)
+static inline void * s_hashMapCC_remove(hashMapCK_t * restrict self, const char * key)
 {
-	assert(self != NULL);
+	struct hashMapCKConcurrent * cc = self->concurrent;
+	const size_t keyLen = strlen(key);
+	const uint64_t hash = hashMap_hashFull(key, keyLen);
+	hashStripeCC_t * stripe = &cc->stripes[hash & (HASHMAPCK_STRIPES - 1)];
+
+	thelper_mutexLock(&stripe->lock);
+	hashTableCC_t * table = atomic_load_explicit(&cc->table, memory_order_relaxed);
+	_Atomic(hashNodeCC_t *) * plink = s_hashMapCC_find(table, key, keyLen, hash);
+	hashNodeCC_t * node = atomic_load_explicit(plink, memory_order_relaxed);
+	void * value = NULL;
+	if (node != NULL)
+	{
+		value = node->node.value;
+		// Sõlm eemaldatakse ahelast, tema enda lüli jääb alles, et sõlmel olev lugeja
+		// jõuaks ikkagi ahela lõppu
+		atomic_store_explicit(plink, atomic_load_explicit(&node->next, memory_order_relaxed), memory_order_release);
+		node->freeNext  = stripe->retired;
+		stripe->retired = node;
+		++stripe->numRetired;
+		atomic_fetch_sub(&cc->numItems, 1);
+
+		if (stripe->numRetired >= HASHMAPCK_RETIRE_BATCH)
+		{
+			s_hashMapCC_reclaim(cc, stripe);
+		}
+	}
+	thelper_mutexUnlock(&stripe->lock);
+
+	return value;
+}
+static bool s_hashMapCC_resize(hashMapCK_t * restrict self, size_t minSize)
+{
+	struct hashMapCKConcurrent * cc = self->concurrent;
+	for (size_t i = 0; i < HASHMAPCK_STRIPES; ++i)
+	{
+		thelper_mutexLock(&cc->stripes[i].lock);
+	}
+
+	hashTableCC_t * old = atomic_load_explicit(&cc->table, memory_order_relaxed);
+	hashTableCC_t * table = NULL;
+	bool success = true;
+	// Mitu samaaegset lisajat võivad küsida sama suurendamist, ainult esimene teeb selle
+	size_t numNodes = HASHMAPCK_STRIPES;
+	while ((numNodes < minSize) && (numNodes <= (SIZE_MAX / 2 / sizeof(hashNodeCC_t *))))
+	{
+		numNodes *= 2;
+	}
+	if ((numNodes != old->numNodes) && ((table = s_hashMapCC_makeTable(minSize)) == NULL))
+	{
+		success = false;
+	}
+
+	// Sõlmed kopeeritakse, sest vana massiivi ahelatel võivad lugejad veel olla
+	for (size_t i = 0; (table != NULL) && (i < old->numNodes); ++i)
+	{
+		for (hashNodeCC_t * node = atomic_load_explicit(&old->nodes[i], memory_order_relaxed); node != NULL;
+			node = atomic_load_explicit(&node->next, memory_order_relaxed))
+		{
+			hashStripeCC_t * stripe = &cc->stripes[node->node.hash & (HASHMAPCK_STRIPES - 1)];
+			hashNodeCC_t * copy = s_hashMapCC_allocNode(stripe, node->node.key, node->node.hash, node->node.value);
+			if (copy == NULL)
+			{
+				// Juba tehtud koopiad lähevad triipude vabade sõlmede nimistutesse
+				for (size_t j = 0; j < table->numNodes; ++j)
+				{
+					hashNodeCC_t * done = atomic_load_explicit(&table->nodes[j], memory_order_relaxed);
+					while (done != NULL)
+					{
+						hashNodeCC_t * next = atomic_load_explicit(&done->next, memory_order_relaxed);
+						hashStripeCC_t * doneStripe = &cc->stripes[done->node.hash & (HASHMAPCK_STRIPES - 1)];
+						done->freeNext        = doneStripe->freeNodes;
+						doneStripe->freeNodes = done;
+						done = next;
+					}
+				}
+				free(table);
+				table   = NULL;
+				success = false;
+				break;
+			}
+			_Atomic(hashNodeCC_t *) * pbucket = &table->nodes[copy->node.hash & (table->numNodes - 1)];
+			atomic_store_explicit(&copy->next, atomic_load_explicit(pbucket, memory_order_relaxed), memory_order_relaxed);
+			atomic_store_explicit(pbucket, copy, memory_order_relaxed);
+		}
+	}
+
+	if (table != NULL)
+	{
+		atomic_store_explicit(&cc->table, table, memory_order_release);
+		// Pärast ooteaega ei ole vanal massiivil ega eemaldatud sõlmedel enam lugejaid
+		s_hashMapCC_synchronize(cc);
+		for (size_t i = 0; i < old->numNodes; ++i)
+		{
+			hashNodeCC_t * node = atomic_load_explicit(&old->nodes[i], memory_order_relaxed);
+			while (node != NULL)
+			{
+				hashNodeCC_t * next = atomic_load_explicit(&node->next, memory_order_relaxed);
+				hashStripeCC_t * stripe = &cc->stripes[node->node.hash & (HASHMAPCK_STRIPES - 1)];
+				node->freeNext    = stripe->freeNodes;
+				stripe->freeNodes = node;
+				node = next;
+			}
+		}
+		free(old);
+		for (size_t i = 0; i < HASHMAPCK_STRIPES; ++i)
+		{
+			hashStripeCC_t * stripe = &cc->stripes[i];
+			while (stripe->retired != NULL)
+			{
+				hashNodeCC_t * node = stripe->retired;
+				stripe->retired   = node->freeNext;
+				node->freeNext    = stripe->freeNodes;
+				stripe->freeNodes = node;
+			}
+			stripe->numRetired = 0;
+		}
+	}
+
+	for (size_t i = HASHMAPCK_STRIPES; i-- > 0;)
+	{
+		thelper_mutexUnlock(&cc->stripes[i].lock);
+	}
+	return success;
+}
+static bool s_hashMapCK_insertHash(hashMapCK_t * restrict self, const char * key, uint64_t hash, void * value);
+
+/**
+ * @brief Copies the items of a concurrent map to a single-threaded map, the source map
+ * may be used concurrently
+ * 
+ */
+static inline bool s_hashMapCC_copyTo(hashMapCK_t * restrict self, const hashMapCK_t * restrict other)
+{
+	struct hashMapCKConcurrent * cc = other->concurrent;
+	bool success = true;
+
+	const size_t epoch = s_hashMapCC_readBegin(cc);
+	hashTableCC_t * table = atomic_load_explicit(&cc->table, memory_order_acquire);
+	for (size_t i = 0; success && (i < table->numNodes); ++i)
+	{
+		for (const hashNodeCC_t * node = atomic_load_explicit(&table->nodes[i], memory_order_acquire); success && (node != NULL);
+			node = atomic_load_explicit(&node->next, memory_order_acquire))
+		{
+			success = s_hashMapCK_insertHash(self, node->node.key, node->node.hash, node->node.value);
+		}
+	}
+	s_hashMapCC_readEnd(cc, epoch);
+
+	return success;
+}
+static inline void s_hashMapCC_destroy(struct hashMapCKConcurrent * restrict cc)
+{
+	// Kõik sõlmed, ka eemaldatud ja vabad, vabastatakse triipude puhvrite plokkide kaupa
+	free(atomic_load_explicit(&cc->table, memory_order_relaxed));
+	for (size_t i = 0; i < HASHMAPCK_STRIPES; ++i)
+	{
+		thelper_mutexDestroy(&cc->stripes[i].lock);
+		arena_destroy(&cc->stripes[i].pool);
+	}
+	thelper_mutexDestroy(&cc->graceLock);
+	free(cc);
+}
+
+void hashMapCK_zero(hashMapCK_t * restrict self)
+{
+	assert(self != NULL);
+
+	*self = (hashMapCK_t){
+		.nodes       = NULL,
+		.numNodes    = 0,
+		.numItems    = 0,
+		.freeNodes   = NULL,
+		.oldNodes    = NULL,
+		.numOldNodes = 0,
+		.numMigrated = 0,
+		.incremental = false,
+		.concurrent  = NULL
+	};
+	arena_init(&self->pool, 0);
+}
+bool hashMapCK_init(hashMapCK_t * restrict self, size_t minSize)
+{
+	assert(self != NULL);
+	assert(minSize > 0);
+
+	self->numNodes    = s_hashMap_findNextPrime(minSize);
+	self->numItems    = 0;
+	self->freeNodes   = NULL;
+	self->oldNodes    = NULL;
+	self->numOldNodes = 0;
+	self->numMigrated = 0;
+	self->incremental = false;
+	self->concurrent  = NULL;
+	arena_init(&self->pool, 0);
+	self->nodes       = s_hashMapCK_makeSlots(self->numNodes);
+	return self->nodes != NULL;
+}
+bool hashMapCK_initConcurrent(hashMapCK_t * restrict self, size_t minSize)
+{
+	assert(self != NULL);
+	assert(minSize > 0);
+
+	hashMapCK_zero(self);
+	struct hashMapCKConcurrent * cc = malloc(sizeof(struct hashMapCKConcurrent));
+	if (cc == NULL)
+	{
+		return false;
+	}
+	atomic_init(&cc->table, s_hashMapCC_makeTable(minSize));
+	atomic_init(&cc->numItems, 0);
+	atomic_init(&cc->epoch, 0);
+	atomic_init(&cc->readers[0], 0);
+	atomic_init(&cc->readers[1], 0);
+	bool success = thelper_mutexInit(&cc->graceLock);
+	for (size_t i = 0; i < HASHMAPCK_STRIPES; ++i)
+	{
+		hashStripeCC_t * stripe = &cc->stripes[i];
+		stripe->freeNodes  = NULL;
+		stripe->retired    = NULL;
+		stripe->numRetired = 0;
+		arena_init(&stripe->pool, 0);
+		success &= thelper_mutexInit(&stripe->lock);
+	}
+	self->concurrent = cc;
+
+	if (!success || (atomic_load_explicit(&cc->table, memory_order_relaxed) == NULL))
+	{
+		hashMapCK_destroy(self);
+		return false;
+	}
+	return true;
+}
+hashMapCK_t * hashMapCK_make(size_t minSize)
+{
+	assert(minSize > 0);
+
+	hashMapCK_t * map = malloc(sizeof(hashMapCK_t));
+	if (map == NULL)
+	{
+		return NULL;
+	}
+
+	if (hashMapCK_init(map, minSize) == false)
+	{
+		free(map);
+		return NULL;
+	}
+
+	return map;
+}
+
+bool hashMapCK_initCopy(hashMapCK_t * restrict self, size_t minSize, const hashMapCK_t * restrict other)
+{
+	assert(self != NULL);
+	assert(minSize > 0);
+	assert(other != NULL);
+	
+	if (!hashMapCK_init(self, minSize))
+	{
+		return false;
+	}
+	else if (other->concurrent != NULL)
+	{
+		if (!s_hashMapCC_copyTo(self, other))
+		{
+			hashMapCK_destroy(self);
+			return false;
+		}
+		return true;
+	}
+
+	// Pooleli migratsiooni korral kopeeritakse ka vana massiivi veel liigutamata "bucketid"
+	for (size_t i = 0; i < (other->numNodes + other->numOldNodes); ++i)
+	{
+		hashNodeCK_t * node = (i < other->numNodes) ? other->nodes[i] : other->oldNodes[i - other->numNodes];
+		while (node != NULL)
+		{
+			if (!s_hashMapCK_insertHash(self, node->key, node->hash, node->value))
+			{
+				hashMapCK_destroy(self);
+				return false;
+			}
+			node = node->next;
+		}
+	}
+
+	return true;
+}
+hashMapCK_t * hashMapCK_makeCopy(size_t minSize, const hashMapCK_t * restrict other)
+{
+	assert(minSize > 0);
+	assert(other != NULL);
+
+	hashMapCK_t * mem = malloc(sizeof(hashMapCK_t));
+	if (mem == NULL)
+	{
+		return NULL;
+	}
+	else if (!hashMapCK_initCopy(mem, minSize, other))
+	{
+		free(mem);
+		return NULL;
+	}
+
+	return mem;
+}
+
+bool hashMapCK_resize(hashMapCK_t * restrict self, size_t minSize)
+{
+	assert(self != NULL);
+	assert(minSize > 0);
+
+	if (self->concurrent != NULL)
+	{
+		return s_hashMapCC_resize(self, minSize);
+	}
+
+	const size_t numNodes = s_hashMap_findNextPrime(minSize);
+	hashNodeCK_t ** nodes = s_hashMapCK_makeSlots(numNodes);
+	if (nodes == NULL)
+	{
+		return false;
+	}
+
+	// Sõlmed tõstetakse ümber mõlemast massiivist, pooleli migratsioon lõpeb sellega
+	for (size_t i = 0; i < self->numNodes; ++i)
+	{
+		s_hashMapCK_relink(nodes, numNodes, self->nodes[i]);
+	}
+	for (size_t i = self->numMigrated; i < self->numOldNodes; ++i)
+	{
+		s_hashMapCK_relink(nodes, numNodes, self->oldNodes[i]);
+	}
+	free(self->nodes);
+	free(self->oldNodes);
+	self->nodes       = nodes;
+	self->numNodes    = numNodes;
+	self->oldNodes    = NULL;
+	self->numOldNodes = 0;
+	self->numMigrated = 0;
+	return true;
+}
+
+/**
+ * @brief Moves up to maxBuckets buckets from the previous slot-array to the current
+ * one, nodes are relinked without allocating. Frees the previous slot-array when it
+ * has been emptied.
+ * 
+ */
+static inline void s_hashMapCK_migrate(hashMapCK_t * restrict self, size_t maxBuckets)
+{
+	const size_t end = ((self->numOldNodes - self->numMigrated) > maxBuckets) ?
+		(self->numMigrated + maxBuckets) : self->numOldNodes;
+	for (; self->numMigrated < end; ++self->numMigrated)
+	{
+		s_hashMapCK_relink(self->nodes, self->numNodes, self->oldNodes[self->numMigrated]);
+		self->oldNodes[self->numMigrated] = NULL;
+	}
+	if (self->numMigrated == self->numOldNodes)
+	{
+		free(self->oldNodes);
+		self->oldNodes    = NULL;
+		self->numOldNodes = 0;
+		self->numMigrated = 0;
+	}
+}
+/**
+ * @brief Starts incremental rehashing to a new slot-array of at least minSize slots,
+ * the current slot-array becomes the previous one. Any earlier migration is
+ * finished first.
+ * 
+ */
+static inline bool s_hashMapCK_beginMigrate(hashMapCK_t * restrict self, size_t minSize)
+{
+	const size_t numNodes = s_hashMap_findNextPrime(minSize);
+	hashNodeCK_t ** nodes = s_hashMapCK_makeSlots(numNodes);
+	if (nodes == NULL)
+	{
+		return false;
+	}
+	s_hashMapCK_migrate(self, SIZE_MAX);
+
+	self->oldNodes    = self->nodes;
+	self->numOldNodes = self->numNodes;
+	self->numMigrated = 0;
+	self->nodes       = nodes;
+	self->numNodes    = numNodes;
+	return true;
+}
+/**
+ * @brief Finds the link pointing to the node with given key from both slot-arrays,
+ * returns pointer to the terminating NULL-link of the current slot-array's bucket,
+ * if the key wasn't found
+ * 
+ */
+static inline hashNodeCK_t ** s_hashMapCK_find(const hashMapCK_t * restrict self, const char * key, size_t keyLen, uint64_t hash)
+{
+	// Vana massiivi "bucket" on tühi, kui see on juba migreeritud. strncmp peatub sõlme
+	// võtme lõpus, pikkuse võrdsust kontrollib null-terminaator
+	if (self->oldNodes != NULL)
+	{
+		const size_t oldIdx = hash % self->numOldNodes;
+		hashNodeCK_t ** pnode = &self->oldNodes[oldIdx];
+		while ((oldIdx >= self->numMigrated) && ((*pnode) != NULL))
+		{
+			if (((*pnode)->hash == hash) && (strncmp((*pnode)->key, key, keyLen) == 0) && ((*pnode)->key[keyLen] == '\0'))
+			{
+				return pnode;
+			}
+			pnode = &(*pnode)->next;
+		}
+	}
+
+	hashNodeCK_t ** pnode = &self->nodes[hash % self->numNodes];
+	while ((*pnode) != NULL)
+	{
+		if (((*pnode)->hash == hash) && (strncmp((*pnode)->key, key, keyLen) == 0) && ((*pnode)->key[keyLen] == '\0'))
+		{
+			return pnode;
+		}
+		pnode = &(*pnode)->next;
+	}
+	return pnode;
+}
+
+static bool s_hashMapCK_insertHash(hashMapCK_t * restrict self, const char * key, uint64_t hash, void * value)
+{
+	assert(self != NULL);
 	assert(key  != NULL);
 	assert(self->nodes != NULL);
 
-	if (!self->numItems)
+	// Kui räsitabel on "küllastunud", proovib mälu juurde allokeerida
+	if (self->numItems >= self->numNodes)
+	{
+		// Tagastusväärtust ei kontrollita, kui see ebaõnnestub, siis säilub esialgne räsitabel, mis hakkab olema "üleküllastunud".
+		// Inkrementaalses režiimis jäetakse vana massiiv alles ja see migreeritakse järk-järgult
+		if (self->incremental)
+		{
+			s_hashMapCK_beginMigrate(self, (self->numItems + 1) * 2);
+		}
+		else
+		{
+			hashMapCK_resize(self, (self->numItems + 1) * 2);
+		}
+	}
+	if (self->oldNodes != NULL)
+	{
+		s_hashMapCK_migrate(self, HASHMAPCK_MIGRATE_STEP);
+	}
+
+	hashNodeCK_t ** pnode = s_hashMapCK_find(self, key, strlen(key), hash);
+	if ((*pnode) != NULL)
+	{
+		return false;
+	}
+
+	// Sõlm võetakse vabade sõlmede nimistust või räsitabeli mälupuhvrist
+	hashNodeCK_t * node = self->freeNodes;
+	if (node != NULL)
+	{
+		self->freeNodes = node->next;
+	}
+	else if ((node = arena_alloc(&self->pool, sizeof(hashNodeCK_t))) == NULL)
+	{
+		return false;
+	}
+	node->key   = key;
+	node->value = value;
+	node->hash  = hash;
+	node->next  = NULL;
+
+	*pnode = node;
+	++self->numItems;
+	return true;
+}
+bool hashMapCK_insert(hashMapCK_t * restrict self, const char * key, void * value)
+{
+	assert(self != NULL);
+	assert(key  != NULL);
+
+	const uint64_t hash = hashMap_hashFull(key, strlen(key));
+	return (self->concurrent != NULL) ? s_hashMapCC_insertHash(self, key, hash, value) : s_hashMapCK_insertHash(self, key, hash, value);
+}
+hashNodeCK_t * hashMapCK_get(const hashMapCK_t * restrict self, const char * key)
+{
+	assert(self != NULL);
+	assert(key  != NULL);
+
+	if (self->concurrent != NULL)
+	{
+		return s_hashMapCC_get(self, key, strlen(key));
+	}
+	assert(self->nodes != NULL);
+
+	if (!self->numItems)
+	{
+		return NULL;
+	}
+
+	const size_t keyLen = strlen(key);
+	return *s_hashMapCK_find(self, key, keyLen, hashMap_hashFull(key, keyLen));
+}
+hashNodeCK_t * hashMapCK_getLen(const hashMapCK_t * restrict self, const char * key, size_t keyLen)
+{
+	assert(self != NULL);
+	assert((key != NULL) || (keyLen == 0));
+
+	if (self->concurrent != NULL)
+	{
+		return s_hashMapCC_get(self, key, keyLen);
+	}
+	assert(self->nodes != NULL);
+
+	if (!self->numItems)
+	{
+		return NULL;
+	}
+
+	return *s_hashMapCK_find(self, key, keyLen, hashMap_hashFull(key, keyLen));
+}
+void * hashMapCK_remove(hashMapCK_t * restrict self, const char * key)
+{
+	assert(self != NULL);
+	assert(key  != NULL);
+
+	if (self->concurrent != NULL)
+	{
+		return s_hashMapCC_remove(self, key);
+	}
+	assert(self->nodes != NULL);
+
+	if (!self->numItems)
+	{
+		return NULL;
+	}
+
+	if (self->oldNodes != NULL)
+	{
+		s_hashMapCK_migrate(self, HASHMAPCK_MIGRATE_STEP);
+	}
+
+	const size_t keyLen = strlen(key);
+	hashNodeCK_t ** pnode = s_hashMapCK_find(self, key, keyLen, hashMap_hashFull(key, keyLen));
+	if ((*pnode) == NULL)
+	{
+		return NULL;
+	}
+
+	// remove node, return value
+	hashNodeCK_t * node = *pnode;
+	void * value = node->value;
+	*pnode = node->next;
+
+	node->next      = self->freeNodes;
+	self->freeNodes = node;
+	--self->numItems;
+	return value;
+}
+void hashMapCK_setIncremental(hashMapCK_t * restrict self, bool incremental)
+{
+	assert(self != NULL);
+
+	// Samaaegses režiimis kopeerib suuruse muutmine sõlmed niikuinii uude massiivi
+	if (self->concurrent != NULL)
+	{
+		return;
+	}
+	assert(self->nodes != NULL);
+
+	if (!incremental && (self->oldNodes != NULL))
+	{
+		s_hashMapCK_migrate(self, SIZE_MAX);
+	}
+	self->incremental = incremental;
+}
+
+void hashMapCK_destroy(hashMapCK_t * restrict self)
+{
+	assert(self != NULL);
+
+	if (self->concurrent != NULL)
+	{
+		s_hashMapCC_destroy(self->concurrent);
+		self->concurrent = NULL;
+		return;
+	}
+	else if (self->nodes == NULL)
+	{
+		return;
+	}
+
+	// Sõlmed vabastatakse puhvri plokkide kaupa, ka pooleli migratsiooni vanas massiivis olevad
+	arena_destroy(&self->pool);
+	free(self->nodes);
+	free(self->oldNodes);
+	self->nodes     = NULL;
+	self->oldNodes  = NULL;
+	self->freeNodes = NULL;
+}
+void hashMapCK_free(hashMapCK_t * restrict self)
+{
+	assert(self != NULL);
+
+	hashMapCK_destroy(self);
+	free(self);
+}
+
+
+
+/**
+ * @brief Maximum load factor of hashMapOA as a fraction HASHMAPOA_LOAD_NUM / HASHMAPOA_LOAD_DEN
+ * 
+ */
+#define HASHMAPOA_LOAD_NUM 7U
+#define HASHMAPOA_LOAD_DEN 8U
+
+/**
+ * @brief Calculates the number of slots needed to hold minSize items under the
+ * maximum load factor, result is a power of two
+ * 
+ */
+static inline size_t s_hashMapOA_numSlots(size_t minSize)
+{
+	size_t slots = 8;
+	while (((slots / HASHMAPOA_LOAD_DEN) * HASHMAPOA_LOAD_NUM) < minSize)
+	{
+		slots *= 2;
+	}
+	return slots;
+}
+/**
+ * @brief Places an entry, that is known not to be in the hashmap, Robin Hood style:
+ * an entry further from its home slot takes the place of a closer one, which
+ * continues probing. Hashmap must have at least one free slot
+ * 
+ */
+static inline void s_hashMapOA_place(hashMapOA_t * restrict self, hashEntryOA_t entry, size_t idx)
+{
+	const size_t mask = self->numSlots - 1;
+	for (;; idx = (idx + 1) & mask, ++entry.dist)
+	{
+		hashEntryOA_t * slot = &self->entries[idx];
+		if (slot->dist == 0)
+		{
+			*slot = entry;
+			return;
+		}
+		else if (slot->dist < entry.dist)
+		{
+			const hashEntryOA_t temp = *slot;
+			*slot = entry;
+			entry = temp;
+		}
+	}
+}
+
+void hashMapOA_zero(hashMapOA_t * restrict self)
+{
+	assert(self != NULL);
+
+	*self = (hashMapOA_t){
+		.entries  = NULL,
+		.numSlots = 0,
+		.numItems = 0
+	};
+}
+bool hashMapOA_init(hashMapOA_t * restrict self, size_t minSize)
+{
+	assert(self != NULL);
+	assert(minSize > 0);
+
+	// Pesade arv on kahe aste, indeks leitakse maski, mitte jäägiga
+	self->numSlots = s_hashMapOA_numSlots(minSize);
+	self->numItems = 0;
+	self->entries  = malloc(self->numSlots * sizeof(hashEntryOA_t));
+	if (self->entries == NULL)
+	{
+		return false;
+	}
+	for (size_t i = 0; i < self->numSlots; ++i)
+	{
+		self->entries[i] = (hashEntryOA_t){
+			.key   = NULL,
+			.value = NULL,
+			.hash  = 0,
+			.dist  = 0
+		};
+	}
+	return true;
+}
+hashMapOA_t * hashMapOA_make(size_t minSize)
+{
+	assert(minSize > 0);
+
+	hashMapOA_t * map = malloc(sizeof(hashMapOA_t));
+	if (map == NULL)
 	{
 		return NULL;
 	}
 
-	hashNodeCK_t * node = self->nodes[hashMap_hash(key, self->numNodes)];
+	if (hashMapOA_init(map, minSize) == false)
+	{
+		free(map);
+		return NULL;
+	}
 
-	while (node != NULL)
+	return map;
+}
+
+bool hashMapOA_initCopy(hashMapOA_t * restrict self, size_t minSize, const hashMapOA_t * restrict other)
+{
+	assert(self != NULL);
+	assert(minSize > 0);
+	assert(other != NULL);
+
+	if (!hashMapOA_init(self, (minSize > other->numItems) ? minSize : other->numItems))
+	{
+		return false;
+	}
+
+	// Võtmed on erinevad, seega paigutatakse kirjed otse ilma duplikaate otsimata,
+	// räsi võetakse kirjest
+	for (size_t i = 0; i < other->numSlots; ++i)
 	{
-		if (strcmp(node->key, key) == 0)
+		const hashEntryOA_t * entry = &other->entries[i];
+		if (entry->dist != 0)
 		{
-			return node;
+			s_hashMapOA_place(
+				self,
+				(hashEntryOA_t){ .key = entry->key, .value = entry->value, .hash = entry->hash, .dist = 1 },
+				(size_t)entry->hash & (self->numSlots - 1)
+			);
+			++self->numItems;
 		}
-		node = node->next;
 	}
-	return NULL;
+
+	return true;
 }
-void * hashMapCK_remove(hashMapCK_t * restrict self, const char * key)
+hashMapOA_t * hashMapOA_makeCopy(size_t minSize, const hashMapOA_t * restrict other)
+{
+	assert(minSize > 0);
+	assert(other != NULL);
+
+	hashMapOA_t * mem = malloc(sizeof(hashMapOA_t));
+	if (mem == NULL)
+	{
+		return NULL;
+	}
+	else if (!hashMapOA_initCopy(mem, minSize, other))
+	{
+		free(mem);
+		return NULL;
+	}
+
+	return mem;
+}
+
+bool hashMapOA_resize(hashMapOA_t * restrict self, size_t minSize)
+{
+	assert(self != NULL);
+	assert(minSize > 0);
+
+	hashMapOA_t newMap;
+	if (!hashMapOA_initCopy(&newMap, minSize, self))
+	{
+		return false;
+	}
+
+	hashMapOA_destroy(self);
+	*self = newMap;
+	return true;
+}
+
+bool hashMapOA_insert(hashMapOA_t * restrict self, const char * key, void * value)
 {
 	assert(self != NULL);
 	assert(key  != NULL);
-	assert(self->nodes != NULL);
+	assert(self->entries != NULL);
+
+	// Kui täituvus ületaks lubatu, proovib tabelit kahekordistada. Ebaõnnestumisel
+	// jätkatakse vanas tabelis, kuni vähemalt üks pesa jääb vabaks
+	if ((self->numItems + 1) > ((self->numSlots / HASHMAPOA_LOAD_DEN) * HASHMAPOA_LOAD_NUM) &&
+		!hashMapOA_resize(self, self->numItems * 2) && ((self->numItems + 1) >= self->numSlots))
+	{
+		return false;
+	}
+
+	// Otsitakse võtit seni, kuni pesa kirje on oma kodupesale lähemal kui otsitav
+	// oleks, sealt edasi ei saa võtit Robin Hoodi järjestuse tõttu enam olla
+	const size_t mask = self->numSlots - 1;
+	const uint64_t hash = hashMap_hashFull(key, strlen(key));
+	size_t idx = (size_t)hash & mask, dist = 1;
+	for (; self->entries[idx].dist >= dist; idx = (idx + 1) & mask, ++dist)
+	{
+		if ((self->entries[idx].hash == hash) && (strcmp(self->entries[idx].key, key) == 0))
+		{
+			return false;
+		}
+	}
+
+	s_hashMapOA_place(self, (hashEntryOA_t){ .key = key, .value = value, .hash = hash, .dist = dist }, idx);
+	++self->numItems;
+	return true;
+}
+hashEntryOA_t * hashMapOA_get(const hashMapOA_t * restrict self, const char * key)
+{
+	assert(self != NULL);
+	assert(key  != NULL);
+	assert(self->entries != NULL);
 
 	if (!self->numItems)
 	{
 		return NULL;
 	}
 
-	hashNodeCK_t ** pnode = &self->nodes[hashMap_hash(key, self->numNodes)];
-	while ((*pnode) != NULL)
+	const size_t mask = self->numSlots - 1;
+	const uint64_t hash = hashMap_hashFull(key, strlen(key));
+	size_t idx = (size_t)hash & mask;
+	for (size_t dist = 1; self->entries[idx].dist >= dist; idx = (idx + 1) & mask, ++dist)
 	{
-		if (strcmp((*pnode)->key, key) == 0)
+		if ((self->entries[idx].hash == hash) && (strcmp(self->entries[idx].key, key) == 0))
 		{
-			// remove node, return value
-			hashNodeCK_t * node = *pnode;
-			void * value = node->value;
-			*pnode = node->next;
+			return &self->entries[idx];
+		}
+	}
+	return NULL;
+}
+hashEntryOA_t * hashMapOA_getLen(const hashMapOA_t * restrict self, const char * key, size_t keyLen)
+{
+	assert(self != NULL);
+	assert((key != NULL) || (keyLen == 0));
+	assert(self->entries != NULL);
 
-			hashNodeCK_free(node);
-			--self->numItems;
-			return value;
+	if (!self->numItems)
+	{
+		return NULL;
+	}
+
+	const size_t mask = self->numSlots - 1;
+	const uint64_t hash = hashMap_hashFull(key, keyLen);
+	size_t idx = (size_t)hash & mask;
+	for (size_t dist = 1; self->entries[idx].dist >= dist; idx = (idx + 1) & mask, ++dist)
+	{
+		// strncmp peatub kirje võtme lõpus, pikkuse võrdsust kontrollib null-terminaator
+		const char * ekey = self->entries[idx].key;
+		if ((self->entries[idx].hash == hash) && (strncmp(ekey, key, keyLen) == 0) && (ekey[keyLen] == '\0'))
+		{
+			return &self->entries[idx];
 		}
-		pnode = &(*pnode)->next;
 	}
 	return NULL;
 }
+void * hashMapOA_remove(hashMapOA_t * restrict self, const char * key)
+{
+	assert(self != NULL);
+	assert(key  != NULL);
+	assert(self->entries != NULL);
 
-void hashMapCK_destroy(hashMapCK_t * restrict self)
+	hashEntryOA_t * entry = hashMapOA_get(self, key);
+	if (entry == NULL)
+	{
+		return NULL;
+	}
+	void * value = entry->value;
+
+	// Järgnevad kirjed, mis pole oma kodupesas, nihutatakse ühe võrra tagasi, nii
+	// ei ole vaja kustutatud pesade märgiseid
+	const size_t mask = self->numSlots - 1;
+	size_t idx = (size_t)(entry - self->entries);
+	for (size_t next = (idx + 1) & mask; self->entries[next].dist > 1; idx = next, next = (next + 1) & mask)
+	{
+		self->entries[idx] = self->entries[next];
+		--self->entries[idx].dist;
+	}
+	self->entries[idx] = (hashEntryOA_t){
+		.key   = NULL,
+		.value = NULL,
+		.hash  = 0,
+		.dist  = 0
+	};
+	--self->numItems;
+	return value;
+}
+
+void hashMapOA_destroy(hashMapOA_t * restrict self)
 {
 	assert(self != NULL);
 
-	if (self->nodes == NULL)
+	if (self->entries == NULL)
 	{
 		return;
 	}
+	free(self->entries);
+	self->entries = NULL;
+}
+void hashMapOA_free(hashMapOA_t * restrict self)
+{
+	assert(self != NULL);
 
-	for (size_t i = 0; i < self->numNodes; ++i)
+	hashMapOA_destroy(self);
+	free(self);
+}
+
+
+/**
+ * @brief Maximum pilot value tried per bucket of hashMapPH before giving up
+ * 
+ */
+#define HASHMAPPH_MAX_PILOT (UINT32_C(1) << 20)
+
+static inline size_t s_hashMapPH_bucket(uint64_t hash, size_t numBuckets)
+{
+	return (size_t)((hash >> 32) % numBuckets);
+}
+static inline size_t s_hashMapPH_slot(uint64_t hash, uint32_t pilot, size_t numSlots)
+{
+	// Pilooti ei saa räsiga ainult XOR-ida, siis jääksid sama alumiste bittidega võtmed kokku
+	return (size_t)(s_hashMap_mix(hash ^ s_hashMap_secret[2], (uint64_t)pilot ^ s_hashMap_secret[3]) % numSlots);
+}
+
+size_t hashMapPH_numBuckets(size_t numKeys)
+{
+	return numKeys / 4 + 1;
+}
+size_t hashMapPH_numSlots(size_t numKeys)
+{
+	return numKeys + numKeys / 16 + 1;
+}
+void hashMapPH_zero(hashMapPH_t * restrict self)
+{
+	assert(self != NULL);
+	*self = (hashMapPH_t){
+		.pilots     = NULL,
+		.slots      = NULL,
+		.numBuckets = 0,
+		.numSlots   = 0,
+		.owned      = false
+	};
+}
+bool hashMapPH_build(hashMapPH_t * restrict self, const char * const * keys, size_t numKeys)
+{
+	assert(self != NULL);
+	assert((keys != NULL) || (numKeys == 0));
+	assert(numKeys < HASHMAPPH_EMPTY);
+
+	hashMapPH_zero(self);
+	const size_t numBuckets = hashMapPH_numBuckets(numKeys), numSlots = hashMapPH_numSlots(numKeys);
+	uint32_t * pilots = calloc(numBuckets, sizeof(uint32_t));
+	uint32_t * slots  = malloc(numSlots * sizeof(uint32_t));
+	uint64_t * hashes = malloc((numKeys + 1) * sizeof(uint64_t));
+	// Ämbrite algused, ämbrite võtmed ja ämbrid suuruse järgi kahanevalt
+	size_t * starts  = calloc(numBuckets + 1, sizeof(size_t));
+	uint32_t * order = malloc((numKeys + 1) * sizeof(uint32_t));
+	size_t * sorted  = malloc(numBuckets * sizeof(size_t));
+	bool ok = (pilots != NULL) && (slots != NULL) && (hashes != NULL) && (starts != NULL) && (order != NULL) && (sorted != NULL);
+
+	size_t maxSize = 0;
+	if (ok)
 	{
-		hashNodeCK_recursiveFree(self->nodes[i]);
+		for (size_t i = 0; i < numSlots; ++i)
+		{
+			slots[i] = HASHMAPPH_EMPTY;
+		}
+		// Loendav sorteerimine ämbrite kaupa
+		for (size_t i = 0; i < numKeys; ++i)
+		{
+			hashes[i] = hashMap_hashFull(keys[i], strlen(keys[i]));
+			++starts[s_hashMapPH_bucket(hashes[i], numBuckets) + 1];
+		}
+		for (size_t b = 0; b < numBuckets; ++b)
+		{
+			maxSize = (starts[b + 1] > maxSize) ? starts[b + 1] : maxSize;
+			starts[b + 1] += starts[b];
+		}
+		size_t * fill = calloc(numBuckets, sizeof(size_t));
+		size_t * bySize = calloc(maxSize + 2, sizeof(size_t));
+		ok = (fill != NULL) && (bySize != NULL);
+		if (ok)
+		{
+			for (size_t i = 0; i < numKeys; ++i)
+			{
+				const size_t b = s_hashMapPH_bucket(hashes[i], numBuckets);
+				order[starts[b] + fill[b]] = (uint32_t)i;
+				++fill[b];
+			}
+			// Suured ämbrid paigutatakse enne, kui tabel täitub
+			for (size_t b = 0; b < numBuckets; ++b)
+			{
+				++bySize[maxSize - (starts[b + 1] - starts[b]) + 1];
+			}
+			for (size_t s = 0; s <= maxSize; ++s)
+			{
+				bySize[s + 1] += bySize[s];
+			}
+			for (size_t b = 0; b < numBuckets; ++b)
+			{
+				sorted[bySize[maxSize - (starts[b + 1] - starts[b])]++] = b;
+			}
+		}
+		free(fill);
+		free(bySize);
 	}
-	free(self->nodes);
+
+	for (size_t k = 0; ok && (k < numBuckets); ++k)
+	{
+		const size_t b = sorted[k], beg = starts[b], end = starts[b + 1];
+		if (beg == end)
+		{
+			break;
+		}
+		// Sama räsiga võtmeid ei saa ükski piloot lahutada
+		for (size_t i = beg; ok && (i < end); ++i)
+		{
+			for (size_t j = i + 1; ok && (j < end); ++j)
+			{
+				ok = hashes[order[i]] != hashes[order[j]];
+			}
+		}
+		uint32_t pilot = 0;
+		for (; ok && (pilot < HASHMAPPH_MAX_PILOT); ++pilot)
+		{
+			size_t placed = beg;
+			for (; placed < end; ++placed)
+			{
+				const size_t slot = s_hashMapPH_slot(hashes[order[placed]], pilot, numSlots);
+				if (slots[slot] != HASHMAPPH_EMPTY)
+				{
+					break;
+				}
+				slots[slot] = order[placed];
+			}
+			if (placed == end)
+			{
+				break;
+			}
+			// Kokkupõrge, juba paigutatud võtmed võetakse tagasi
+			for (size_t i = beg; i < placed; ++i)
+			{
+				slots[s_hashMapPH_slot(hashes[order[i]], pilot, numSlots)] = HASHMAPPH_EMPTY;
+			}
+		}
+		ok &= pilot < HASHMAPPH_MAX_PILOT;
+		pilots[b] = pilot;
+	}
+
+	free(hashes);
+	free(starts);
+	free(order);
+	free(sorted);
+	if (!ok)
+	{
+		free(pilots);
+		free(slots);
+		return false;
+	}
+	*self = (hashMapPH_t){
+		.pilots     = pilots,
+		.slots      = slots,
+		.numBuckets = numBuckets,
+		.numSlots   = numSlots,
+		.owned      = true
+	};
+	return true;
 }
-void hashMapCK_free(hashMapCK_t * restrict self)
+void hashMapPH_initView(hashMapPH_t * restrict self, uint32_t * pilots, size_t numBuckets, uint32_t * slots, size_t numSlots)
+{
+	assert(self != NULL);
+	assert(pilots != NULL);
+	assert(slots != NULL);
+	assert(numBuckets > 0);
+	assert(numSlots > 0);
+
+	*self = (hashMapPH_t){
+		.pilots     = pilots,
+		.slots      = slots,
+		.numBuckets = numBuckets,
+		.numSlots   = numSlots,
+		.owned      = false
+	};
+}
+uint32_t hashMapPH_get(const hashMapPH_t * restrict self, const char * key, size_t keyLen)
 {
 	assert(self != NULL);
+	assert((key != NULL) || (keyLen == 0));
 
-	hashMapCK_destroy(self);
-	free(self);
+	if (self->numSlots == 0)
+	{
+		return HASHMAPPH_EMPTY;
+	}
+	const uint64_t hash = hashMap_hashFull(key, keyLen);
+	const uint32_t pilot = self->pilots[s_hashMapPH_bucket(hash, self->numBuckets)];
+	return self->slots[s_hashMapPH_slot(hash, pilot, self->numSlots)];
 }
+void hashMapPH_destroy(hashMapPH_t * restrict self)
+{
+	assert(self != NULL);
 
+	if (self->owned)
+	{
+		free(self->pilots);
+		free(self->slots);
+	}
+	hashMapPH_zero(self);
+}
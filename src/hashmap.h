@@ -1,6 +1,9 @@
 #ifndef HASHMAP_H
 #define HASHMAP_H
 
+#include "arena.h"
+
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <assert.h>
@@ -13,6 +16,8 @@ typedef struct hashNode
 {
 	char * key;
 	void * value;
+	// Full hash of the key, chains are compared by it before the keys
+	uint64_t hash;
 
 	struct hashNode * next;
 } hashNode_t;
@@ -26,6 +31,8 @@ typedef struct hashNodeConstKey
 {
 	const char * key;
 	void * value;
+	// Full hash of the key, chains are compared by it before the keys
+	uint64_t hash;
 
 	struct hashNodeConstKey * next;
 } hashNodeConstKey_t, hashNodeCK_t;
@@ -40,6 +47,11 @@ typedef struct hashMap
 {
 	hashNode_t ** nodes;
 	size_t numNodes, numItems;
+
+	// Nodes are allocated from the map's own pool together with the copies of their
+	// keys, removed nodes are kept in a free-list for reuse
+	arena_t pool;
+	hashNode_t * freeNodes;
 } hashMap_t;
 
 /**
@@ -50,14 +62,98 @@ typedef struct hashMapConstKey
 {
 	hashNodeCK_t ** nodes;
 	size_t numNodes, numItems;
+
+	// Nodes are allocated from the map's own pool, removed nodes are kept in a
+	// free-list for reuse
+	arena_t pool;
+	hashNodeCK_t * freeNodes;
+
+	// Incremental rehashing: buckets of the previous slot-array, which are migrated
+	// a few at a time, buckets before numMigrated are already empty
+	hashNodeCK_t ** oldNodes;
+	size_t numOldNodes, numMigrated;
+	bool incremental;
+
+	// State of the concurrent mode, NULL in the single-threaded mode. A concurrent map
+	// keeps its own slot-array, nodes and item count, the fields above stay empty
+	struct hashMapCKConcurrent * concurrent;
 } hashMapConstKey_t, hashMapCK_t;
 
+/**
+ * @brief Number of old buckets migrated per insert or remove in incremental mode of
+ * hashMapCK, the previous slot-array is emptied before the new one fills up
+ * 
+ */
+#define HASHMAPCK_MIGRATE_STEP 4
+/**
+ * @brief Number of write lock stripes of a hashMapCK in concurrent mode, a power of two
+ * 
+ */
+#define HASHMAPCK_STRIPES 16
+/**
+ * @brief Number of removed nodes a stripe of a concurrent hashMapCK collects before
+ * waiting for a grace period and reclaiming them
+ * 
+ */
+#define HASHMAPCK_RETIRE_BATCH 64
+
+/**
+ * @brief Slot of the open-addressing hashtable, "key" is used the same way as in
+ * hashNodeCK_t, the memory must stay "alive" while the entry is in the hashtable
+ * 
+ */
+typedef struct hashEntryOpenAddressing
+{
+	const char * key;
+	void * value;
+	// Full hash of the key, probes are compared by it before the keys, resizing
+	// doesn't hash the keys again
+	uint64_t hash;
+
+	// Entry's distance from its home slot plus 1, 0 marks an empty slot
+	size_t dist;
+} hashEntryOpenAddressing_t, hashEntryOA_t;
+
+/**
+ * @brief Open-addressing hashtable with constant keys, uses Robin Hood hashing. Entries
+ * are stored in one contiguous array with power-of-two number of slots, so lookups
+ * don't chase pointers and slot index is found with a mask of the hash instead of a division
+ * 
+ */
+typedef struct hashMapOpenAddressing
+{
+	hashEntryOA_t * entries;
+	size_t numSlots, numItems;
+} hashMapOpenAddressing_t, hashMapOA_t;
+
+/**
+ * @brief Static perfect hash of a fixed key set in the style of PTHash. Keys are split
+ * into buckets and every bucket has a pilot value, that moves all of its keys to free
+ * slots. Slots hold the indexes of the keys, the keys themselves aren't stored, so the
+ * caller has to compare the key at the found index. Arrays are either owned or views
+ * to memory owned by someone else, e.g. a mapped file
+ * 
+ */
+typedef struct hashMapPerfect
+{
+	uint32_t * pilots;
+	uint32_t * slots;
+	size_t numBuckets, numSlots;
+	bool owned;
+} hashMapPerfect_t, hashMapPH_t;
+
+/**
+ * @brief Marks an empty slot of hashMapPH, also returned for keys outside the key set
+ * 
+ */
+#define HASHMAPPH_EMPTY UINT32_MAX
+
 /* *********** Funktsioonide deklaratsioonid *********** */
 
 
 /**
  * @brief Creates hashtable's node using "key" and value, allocates memory for key and
- * the object itself.
+ * the object itself. Nodes inserted to a hashMap are allocated from the map's pool instead.
  * Complexity: O(1).
  * 
  * @param key Pointer to null-terminated character array that holds "key"
@@ -82,7 +178,7 @@ void hashNode_recursiveFree(hashNode_t * restrict self);
 
 /**
  * @brief Creates hashtable's node using "key" and value, allocates memory only for the object itself,
- * key's pointer is just copied.
+ * key's pointer is just copied. Nodes inserted to a hashMapCK are allocated from the map's pool instead.
  * Complexity: O(1).
  * 
  * @param key Pointer to null-terminated character array that holds "key", must
@@ -161,9 +257,10 @@ bool hashMap_initCopy(hashMap_t * restrict self, size_t minSize, const hashMap_t
 hashMap_t * hashMap_makeCopy(size_t minSize, const hashMap_t * restrict other);
 
 /**
- * @brief Resizes said hashMap structure's slot-array to have a new minimum desired size
+ * @brief Resizes said hashMap structure's slot-array to have a new minimum desired size,
+ * nodes are relinked to the new slot-array without copying them.
  * Reserves the original hashMap structure in case of failure.
- * Complexity: O(minSize).
+ * Complexity: O(n + minSize).
  * 
  * @param self Pointer to hashMap structure to be resized
  * @param minSize New minimum desired size, closest larger prime number of it is calculated
@@ -171,6 +268,16 @@ hashMap_t * hashMap_makeCopy(size_t minSize, const hashMap_t * restrict other);
  * @return false Failure
  */
 bool hashMap_resize(hashMap_t * restrict self, size_t minSize);
+/**
+ * @brief Calculates the full 64-bit hash of a key, word-at-a-time hash in the style of
+ * wyhash, all hashmaps use it and store the result in their nodes.
+ * Complexity: O(keyLen).
+ * 
+ * @param key Pointer to character array of "key", doesn't have to be null-terminated
+ * @param keyLen Length of the "key" in characters
+ * @return uint64_t Hash of the key
+ */
+uint64_t hashMap_hashFull(const char * key, size_t keyLen);
 /**
  * @brief Hashmap's default hash function, is used to calculated the slot index of
  * given key with given hashmap size.
@@ -181,6 +288,17 @@ bool hashMap_resize(hashMap_t * restrict self, size_t minSize);
  * @return size_t Calculated/hashed hashmap slot index in the range 0 ... (mapSize - 1) inclusive
  */
 size_t hashMap_hash(const char * key, size_t mapSize);
+/**
+ * @brief Length-delimited variant of hashMap_hash, gives the same slot index as
+ * hashMap_hash would give for a null-terminated copy of the key.
+ * Complexity: O(keyLen).
+ * 
+ * @param key Pointer to character array of "key", doesn't have to be null-terminated
+ * @param keyLen Length of the "key" in characters
+ * @param mapSize Hashmap's size/number of slots
+ * @return size_t Calculated/hashed hashmap slot index in the range 0 ... (mapSize - 1) inclusive
+ */
+size_t hashMap_hashLen(const char * key, size_t keyLen, size_t mapSize);
 
 /**
  * @brief Inserts a new "key" with a pointer-sized value to the hashmap.
@@ -214,15 +332,15 @@ hashNode_t * hashMap_get(const hashMap_t * restrict self, const char * key);
 void * hashMap_remove(hashMap_t * restrict self, const char * key);
 
 /**
- * @brief Destroys the hashMap object.
- * Complexity: O(n).
+ * @brief Destroys the hashMap object, node pool is freed block by block.
+ * Complexity: O(number of slots).
  * 
  * @param self Pointer to hashMap structure
  */
 void hashMap_destroy(hashMap_t * restrict self);
 /**
  * @brief Destroys the hashMap object, frees memory.
- * Complexity: O(n).
+ * Complexity: O(number of slots).
  * 
  * @param self Pointer to heap-allocated hashMap structure
  */
@@ -247,6 +365,34 @@ void hashMapCK_zero(hashMapCK_t * restrict self);
  * @return false Failure
  */
 bool hashMapCK_init(hashMapCK_t * restrict self, size_t minSize);
+/**
+ * @brief Initialises hashMapCK structure in concurrent mode, the map can then be used
+ * from several threads at once through the same hashMapCK functions.
+ * 
+ * Lookups take no locks and never wait for writers. Inserts and removes lock one of
+ * HASHMAPCK_STRIPES stripes chosen by the key's hash, so writers of different keys
+ * mostly don't wait for each other either, resizing locks all stripes. Every stripe
+ * allocates nodes from its own pool.
+ * 
+ * Removed nodes and replaced slot-arrays are reclaimed after a grace period, when no
+ * lookup that could still see them is running. Grace periods are waited for on every
+ * resize and whenever a stripe has HASHMAPCK_RETIRE_BATCH removed nodes, so the
+ * memory held for readers stays bounded. Reclaimed nodes are reused by later inserts.
+ * 
+ * Because of that, lookups of a concurrent map return a snapshot of the node owned by
+ * the calling thread, valid until the thread's next lookup. Changing the snapshot
+ * doesn't change the map. Incremental rehashing isn't used in concurrent mode, the
+ * numItems field isn't maintained. Copying, destroying and freeing the map may not
+ * run concurrently with other users.
+ * Complexity: O(minSize).
+ * 
+ * @param self Pointer to the hashMapCK structure
+ * @param minSize Minimum desired size of the hashtable in number of slots, this will
+ * be rounded up to a power of two, at least HASHMAPCK_STRIPES
+ * @return true Success
+ * @return false Failure
+ */
+bool hashMapCK_initConcurrent(hashMapCK_t * restrict self, size_t minSize);
 /**
  * @brief Allocates memory for the hashMapCK structure on the heap and initialises
  * hashMapCK structure with pre-determined hashtable size
@@ -264,7 +410,8 @@ hashMapCK_t * hashMapCK_make(size_t minSize);
  * @param self Destination hashmap
  * @param minSize Minimum desired size for the new hashmap (number of slots), this
  * will be calculated to be the next closest prime number
- * @param other Source hashmap
+ * @param other Source hashmap, a concurrent source may be used by other threads during
+ * the copy, the copy itself isn't concurrent
  * @return true Success copying
  * @return false Failure
  */
@@ -281,9 +428,12 @@ bool hashMapCK_initCopy(hashMapCK_t * restrict self, size_t minSize, const hashM
 hashMapCK_t * hashMapCK_makeCopy(size_t minSize, const hashMapCK_t * restrict other);
 
 /**
- * @brief Resizes said hashMapCK structure's slot-array to have a new minimum desired size
- * Reserves the original hashMapCK structure in case of failure.
- * Complexity: O(minSize).
+ * @brief Resizes said hashMapCK structure's slot-array to have a new minimum desired size,
+ * nodes are relinked to the new slot-array without copying them.
+ * Reserves the original hashMapCK structure in case of failure. In concurrent mode the
+ * nodes are copied instead, the old slot-array and removed nodes are reclaimed after a
+ * grace period.
+ * Complexity: O(n + minSize).
  * 
  * @param self Pointer to hashMapCK structure to be resized
  * @param minSize New minimum desired size, closest larger prime number of it is calculated
@@ -291,6 +441,21 @@ hashMapCK_t * hashMapCK_makeCopy(size_t minSize, const hashMapCK_t * restrict ot
  * @return false Failure
  */
 bool hashMapCK_resize(hashMapCK_t * restrict self, size_t minSize);
+/**
+ * @brief Switches incremental rehashing mode of hashMapCK. In incremental mode a full
+ * table isn't rehashed at once, the previous slot-array is kept and its buckets are
+ * moved to the new one HASHMAPCK_MIGRATE_STEP at a time by every insert and remove.
+ * Lookups check both slot-arrays until the migration is done. Switching the mode off
+ * finishes the migration. Only hashMapCK has this mode, the maps of the data model
+ * are hashMapOA and are reserved from the junctions section size before loading, so
+ * they don't rehash while the data file is read.
+ * Has no effect in concurrent mode.
+ * Complexity: O(1) when switching on, O(n) when switching off.
+ * 
+ * @param self Pointer to hashMapCK structure
+ * @param incremental Whether to rehash incrementally
+ */
+void hashMapCK_setIncremental(hashMapCK_t * restrict self, bool incremental);
 
 /**
  * @brief Inserts a new "key" with a pointer-sized value to the hashmap.
@@ -310,9 +475,22 @@ bool hashMapCK_insert(hashMapCK_t * restrict self, const char * key, void * valu
  * 
  * @param self Pointer to hashMapCK structure
  * @param key Pointer to null-terminated character array of desired "key"
- * @return hashNodeCK_t* Pointer to hashNodeCK object in the hashmap, NULL if an object with that "key" was not found
+ * @return hashNodeCK_t* Pointer to hashNodeCK object in the hashmap, NULL if an object with that "key" was not found.
+ * In concurrent mode points to a copy owned by the calling thread, valid until its next lookup
  */
 hashNodeCK_t * hashMapCK_get(const hashMapCK_t * restrict self, const char * key);
+/**
+ * @brief Finds corresponding hashNode object with desired length-delimited "key" from
+ * hashmap, allows looking up substrings without copying them.
+ * Complexity: O(1).
+ * 
+ * @param self Pointer to hashMapCK structure
+ * @param key Pointer to character array of desired "key", doesn't have to be null-terminated
+ * @param keyLen Length of the "key" in characters
+ * @return hashNodeCK_t* Pointer to hashNodeCK object in the hashmap, NULL if an object with that "key" was not found.
+ * In concurrent mode points to a copy owned by the calling thread, valid until its next lookup
+ */
+hashNodeCK_t * hashMapCK_getLen(const hashMapCK_t * restrict self, const char * key, size_t keyLen);
 /**
  * @brief Removes object from hashmap with desired "key".
  * Complexity: O(1).
@@ -325,19 +503,214 @@ hashNodeCK_t * hashMapCK_get(const hashMapCK_t * restrict self, const char * key
 void * hashMapCK_remove(hashMapCK_t * restrict self, const char * key);
 
 /**
- * @brief Destroys the hashMapCK object.
- * Complexity: O(n).
+ * @brief Destroys the hashMapCK object, node pool is freed block by block. In concurrent
+ * mode also removed nodes waiting for a grace period are freed with the stripes' pools,
+ * no other thread may use the map anymore.
+ * Complexity: O(number of slots).
  * 
  * @param self Pointer to hashMapCK structure
  */
 void hashMapCK_destroy(hashMapCK_t * restrict self);
 /**
  * @brief Destroys the hashMapCK object, frees memory.
- * Complexity: O(n).
+ * Complexity: O(number of slots).
  * 
  * @param self Pointer to heap-allocated hashMapCK structure
  */
 void hashMapCK_free(hashMapCK_t * restrict self);
 
 
+/**
+ * @brief Zeros the memory of the hashMapOA structure.
+ * Complexity: O(1).
+ * 
+ * @param self Pointer to the hashMapOA structure
+ */
+void hashMapOA_zero(hashMapOA_t * restrict self);
+/**
+ * @brief Initialises hashMapOA structure with pre-determined capacity.
+ * Complexity: O(minSize).
+ * 
+ * @param self Pointer to the hashMapOA structure
+ * @param minSize Minimum number of items the hashtable can hold without resizing, the
+ * number of slots will be calculated to be a power of two
+ * @return true Success
+ * @return false Failure
+ */
+bool hashMapOA_init(hashMapOA_t * restrict self, size_t minSize);
+/**
+ * @brief Allocates memory for the hashMapOA structure on the heap and initialises
+ * hashMapOA structure with pre-determined capacity.
+ * Complexity: O(minSize).
+ * 
+ * @param minSize Minimum number of items the hashtable can hold without resizing
+ * @return hashMapOA_t* Pointer to the newly allocated hashMapOA, NULL on failure
+ */
+hashMapOA_t * hashMapOA_make(size_t minSize);
+
+/**
+ * @brief Copies the contents of one hashmap to another.
+ * Complexity: O(minSize + other->numSlots).
+ * 
+ * @param self Destination hashmap
+ * @param minSize Minimum number of items the new hashmap can hold without resizing
+ * @param other Source hashmap
+ * @return true Success copying
+ * @return false Failure
+ */
+bool hashMapOA_initCopy(hashMapOA_t * restrict self, size_t minSize, const hashMapOA_t * restrict other);
+/**
+ * @brief Heap-allocates memory for new hashmap, copies contents from existing hashmap.
+ * Complexity: O(minSize + other->numSlots).
+ *
+ * @param minSize Minimum number of items the new hashmap can hold without resizing
+ * @param other Source hashmap
+ * @return hashMapOA_t* Newly heap-allocated copy of other, NULL on failure
+ */
+hashMapOA_t * hashMapOA_makeCopy(size_t minSize, const hashMapOA_t * restrict other);
+
+/**
+ * @brief Resizes said hashMapOA structure's slot-array to hold at least minSize items.
+ * Reserves the original hashMapOA structure in case of failure.
+ * Complexity: O(minSize + numSlots).
+ * 
+ * @param self Pointer to hashMapOA structure to be resized
+ * @param minSize New minimum capacity, never less than the current number of items
+ * @return true Success resizing
+ * @return false Failure
+ */
+bool hashMapOA_resize(hashMapOA_t * restrict self, size_t minSize);
+
+/**
+ * @brief Inserts a new "key" with a pointer-sized value to the hashmap.
+ * Complexity: O(1) amortised.
+ * 
+ * @param self Pointer to the hashMapOA structure
+ * @param key Pointer to null-terminated character array of data's "key", key is not copied,
+ * thus it must be left "alive" for the entire lifetime of this newly inserted object
+ * @param value Pointer-sized "value"
+ * @return true Success inserting
+ * @return false Failure, the key already exists or memory ran out
+ */
+bool hashMapOA_insert(hashMapOA_t * restrict self, const char * key, void * value);
+/**
+ * @brief Finds corresponding entry with desired "key" from hashmap.
+ * Complexity: O(1).
+ * 
+ * @param self Pointer to hashMapOA structure
+ * @param key Pointer to null-terminated character array of desired "key"
+ * @return hashEntryOA_t* Pointer to the entry in the hashmap, stays valid until the
+ * next insertion or removal, NULL if an object with that "key" was not found
+ */
+hashEntryOA_t * hashMapOA_get(const hashMapOA_t * restrict self, const char * key);
+/**
+ * @brief Finds corresponding entry with desired length-delimited "key" from
+ * hashmap, allows looking up substrings without copying them.
+ * Complexity: O(1).
+ * 
+ * @param self Pointer to hashMapOA structure
+ * @param key Pointer to character array of desired "key", doesn't have to be null-terminated
+ * @param keyLen Length of the "key" in characters
+ * @return hashEntryOA_t* Pointer to the entry in the hashmap, stays valid until the
+ * next insertion or removal, NULL if an object with that "key" was not found
+ */
+hashEntryOA_t * hashMapOA_getLen(const hashMapOA_t * restrict self, const char * key, size_t keyLen);
+/**
+ * @brief Removes object from hashmap with desired "key".
+ * Complexity: O(1).
+ * 
+ * @param self Pointer to hashMapOA structure
+ * @param key Pointer to null-terminated character array of desired "key"
+ * @return void* "value" property previously held by the entry in the hashmap.
+ * NULL on failure while removing
+ */
+void * hashMapOA_remove(hashMapOA_t * restrict self, const char * key);
+
+/**
+ * @brief Destroys the hashMapOA object.
+ * Complexity: O(1).
+ * 
+ * @param self Pointer to hashMapOA structure
+ */
+void hashMapOA_destroy(hashMapOA_t * restrict self);
+/**
+ * @brief Destroys the hashMapOA object, frees memory.
+ * Complexity: O(1).
+ * 
+ * @param self Pointer to heap-allocated hashMapOA structure
+ */
+void hashMapOA_free(hashMapOA_t * restrict self);
+
+
+/**
+ * @brief Calculates the number of buckets of hashMapPH for given number of keys,
+ * keys are split to buckets of 4 on average.
+ * Complexity: O(1).
+ * 
+ * @param numKeys Number of keys
+ * @return size_t Number of buckets, at least 1
+ */
+size_t hashMapPH_numBuckets(size_t numKeys);
+/**
+ * @brief Calculates the number of slots of hashMapPH for given number of keys, about
+ * 6% of the slots stay empty to keep the pilot search short.
+ * Complexity: O(1).
+ * 
+ * @param numKeys Number of keys
+ * @return size_t Number of slots, at least 1
+ */
+size_t hashMapPH_numSlots(size_t numKeys);
+/**
+ * @brief Zeros the memory of the hashMapPH structure.
+ * Complexity: O(1).
+ * 
+ * @param self Pointer to the hashMapPH structure
+ */
+void hashMapPH_zero(hashMapPH_t * restrict self);
+/**
+ * @brief Builds perfect hash of the keys, the index of a key in the keys array is
+ * stored in its slot. Fails, if the keys contain duplicates or a pilot isn't found.
+ * Complexity: O(numKeys) expected.
+ * 
+ * @param self Pointer to the hashMapPH structure
+ * @param keys Array of pointers to null-terminated character arrays of "keys"
+ * @param numKeys Number of keys, less than HASHMAPPH_EMPTY
+ * @return true Success
+ * @return false Failure, self is left zeroed
+ */
+bool hashMapPH_build(hashMapPH_t * restrict self, const char * const * keys, size_t numKeys);
+/**
+ * @brief Initialises hashMapPH structure as a view to arrays made by hashMapPH_build,
+ * the arrays have to stay "alive" for the lifetime of the structure. Slots have to
+ * be checked by the caller, if they come from an untrusted source.
+ * Complexity: O(1).
+ * 
+ * @param self Pointer to the hashMapPH structure
+ * @param pilots Pointer to the pilots array of hashMapPH_numBuckets elements
+ * @param numBuckets Number of buckets
+ * @param slots Pointer to the slots array of hashMapPH_numSlots elements
+ * @param numSlots Number of slots
+ */
+void hashMapPH_initView(hashMapPH_t * restrict self, uint32_t * pilots, size_t numBuckets, uint32_t * slots, size_t numSlots);
+/**
+ * @brief Finds the index of a length-delimited "key" without branching on collisions:
+ * one bucket's pilot and one slot are read.
+ * Complexity: O(1) worst case.
+ * 
+ * @param self Pointer to built hashMapPH structure
+ * @param key Pointer to character array of desired "key", doesn't have to be null-terminated
+ * @param keyLen Length of the "key" in characters
+ * @return uint32_t Index of the key in the key set, if the key belongs to it, otherwise
+ * the index of some other key or HASHMAPPH_EMPTY
+ */
+uint32_t hashMapPH_get(const hashMapPH_t * restrict self, const char * key, size_t keyLen);
+/**
+ * @brief Destroys the hashMapPH object, views are only detached.
+ * Complexity: O(1).
+ * 
+ * @param self Pointer to hashMapPH structure
+ */
+void hashMapPH_destroy(hashMapPH_t * restrict self);
+
+
 #endif
@@ -6,6 +6,10 @@
 #include <string.h>
 #include <ctype.h>
 
+#if defined(__SSE2__)
+	#include <emmintrin.h>
+#endif
+
 
 bool g_ini_strAppendCh(char ** restrict pstr, size_t * restrict psize, size_t * restrict pcap, char ch)
 {
@@ -358,8 +362,9 @@ void iniString_zero(iniString_t * restrict pstr)
 	assert(pstr != NULL);
 
 	*pstr = (iniString_t){
-		.str = NULL,
-		.len = 0
+		.str   = NULL,
+		.len   = 0,
+		.owned = false
 	};
 }
 bool iniString_init(iniString_t * restrict pstr, const char * restrict str, intptr_t length)
@@ -381,7 +386,8 @@ bool iniString_init(iniString_t * restrict pstr, const char * restrict str, intp
 
 	memcpy(pstr->str, str, sizeof(char) * realLen);
 	pstr->str[realLen] = '\0';
-	pstr->len = realLen;
+	pstr->len   = realLen;
+	pstr->owned = true;
 	return true;
 }
 iniString_t * iniString_make(const char * restrict str, intptr_t length)
@@ -412,6 +418,7 @@ bool iniString_initEscape(iniString_t * restrict pstr, const char * restrict str
 	}
 	// Null-terminaator lahutatakse maha
 	--pstr->len;
+	pstr->owned = true;
 
 	return true;
 }
@@ -473,7 +480,8 @@ bool iniString_initCopy(iniString_t * restrict pstr, const iniString_t * restric
 		return false;
 	}
 	memcpy(pstr->str, src->str, sizeof(char) * (src->len + 1));
-	pstr->len = src->len;
+	pstr->len   = src->len;
+	pstr->owned = true;
 	
 	return true;
 }
@@ -495,15 +503,79 @@ iniString_t * iniString_makeCopy(const iniString_t * restrict src)
 	return mem;
 }
 
+void iniString_initView(iniString_t * restrict pstr, const iniString_t * restrict src)
+{
+	assert(pstr != NULL);
+	assert(src  != NULL);
+	assert(pstr != src);
+
+	*pstr = (iniString_t){
+		.str   = src->str,
+		.len   = src->len,
+		.owned = false
+	};
+}
+static inline bool s_iniString_initSource(
+	iniString_t * restrict pstr,
+	arena_t * restrict arena,
+	char * restrict str,
+	size_t length,
+	bool terminable,
+	bool lower
+)
+{
+	assert(pstr  != NULL);
+	assert(arena != NULL);
+	assert(str   != NULL);
+
+	// Vaate saab teha ainult siis, kui sõne järel on lähteandmetes veel märgend, mille
+	// asemele null-terminaator kirjutada, ning sõnes pole midagi, mida teisendada
+	bool view = terminable && (memchr(str, '\\', length) == NULL);
+	for (size_t i = 0; view && lower && (i < length); ++i)
+	{
+		view = !isupper((unsigned char)str[i]);
+	}
+	if (!view)
+	{
+		iniString_t temp;
+		if (!(lower ? iniString_initEscapeLower(&temp, str, (intptr_t)length) : iniString_initEscape(&temp, str, (intptr_t)length)))
+		{
+			return false;
+		}
+		// Teisendatud koopia tõstetakse areeni, et see elaks sama kaua kui vaated
+		char * mem = arena_alloc(arena, sizeof(char) * (temp.len + 1));
+		if (mem != NULL)
+		{
+			memcpy(mem, temp.str, sizeof(char) * (temp.len + 1));
+			*pstr = (iniString_t){
+				.str   = mem,
+				.len   = temp.len,
+				.owned = false
+			};
+		}
+		iniString_destroy(&temp);
+		return mem != NULL;
+	}
+
+	str[length] = '\0';
+	*pstr = (iniString_t){
+		.str   = str,
+		.len   = length,
+		.owned = false
+	};
+	return true;
+}
+
 void iniString_destroy(iniString_t * restrict pstr)
 {
 	assert(pstr != NULL);
-	// Mälu vabastatakse
-	if (pstr->str != NULL)
+	// Mälu vabastatakse ainult siis, kui sõne ei ole vaade
+	if ((pstr->str != NULL) && pstr->owned)
 	{
 		free(pstr->str);
-		pstr->str = NULL;
 	}
+	pstr->str   = NULL;
+	pstr->owned = false;
 }
 void iniString_free(iniString_t * restrict pstr)
 {
@@ -522,6 +594,7 @@ bool iniValue_init(
 {
 	assert(pval != NULL);
 	
+	pval->inArena = false;
 	// INI-failis olevad "võtmed" ei tohiks olla suurtähetundlikud ...
 	if (!iniString_initEscapeLower(&pval->key, keystr, keylen))
 	{
@@ -566,10 +639,69 @@ void iniValue_free(iniValue_t * restrict pval)
 	assert(pval != NULL);
 
 	iniValue_destroy(pval);
-	free(pval);
+	// Areenile kuuluv mälu vabastatakse koos areeniga
+	if (!pval->inArena)
+	{
+		free(pval);
+	}
 }
 
 
+static inline bool s_iniSection_initValues(iniSection_t * restrict psect)
+{
+	assert(psect != NULL);
+
+	psect->inArena = false;
+
+	psect->values    = NULL;
+	psect->numValues = 0;
+	psect->maxValues = 0;
+
+	// Räsitabel luuakse alles siis, kui sektsioonis on piisavalt väärtusi
+	hashMapOA_zero(&psect->valueMap);
+
+	return true;
+}
+/**
+ * @brief Finds value with given key from the values array of a section without the
+ * hash index
+ * 
+ */
+static inline iniValue_t * s_iniSection_findLinear(const iniSection_t * restrict psect, const char * restrict keystr)
+{
+	// Võtmeid võrreldakse nagu räsitabelis null-terminaatorini, eemaldatud väärtuste pesad on NULL
+	for (size_t i = 0; i < psect->numValues; ++i)
+	{
+		iniValue_t * val = psect->values[i];
+		if ((val != NULL) && (strcmp(val->key.str, keystr) == 0))
+		{
+			return val;
+		}
+	}
+	return NULL;
+}
+/**
+ * @brief Builds the hash index of the section's keys from its values array
+ * 
+ */
+static inline bool s_iniSection_buildIndex(iniSection_t * restrict psect)
+{
+	if (!hashMapOA_init(&psect->valueMap, psect->numValues + 1))
+	{
+		hashMapOA_zero(&psect->valueMap);
+		return false;
+	}
+	for (size_t i = 0; i < psect->numValues; ++i)
+	{
+		if ((psect->values[i] != NULL) && !hashMapOA_insert(&psect->valueMap, psect->values[i]->key.str, psect->values[i]))
+		{
+			hashMapOA_destroy(&psect->valueMap);
+			hashMapOA_zero(&psect->valueMap);
+			return false;
+		}
+	}
+	return true;
+}
 bool iniSection_init(iniSection_t * restrict psect, const char * sectname, intptr_t sectnameLen)
 {
 	assert(psect != NULL);
@@ -579,13 +711,7 @@ bool iniSection_init(iniSection_t * restrict psect, const char * sectname, intpt
 	{
 		return false;
 	}
-
-	psect->values    = NULL;
-	psect->numValues = 0;
-	psect->maxValues = 0;
-
-	// Initsialiseeritakse räsitabel konkreetse sektsiooni võtmeväärtuste jaoks
-	if (!hashMapCK_init(&psect->valueMap, 1))
+	else if (!s_iniSection_initValues(psect))
 	{
 		// Kui see ei õnnestunud, siis vabastatakse ka sektsiooni enda struktuur
 		iniString_destroy(&psect->section);
@@ -610,13 +736,10 @@ iniSection_t * iniSection_make(const char * sectname, intptr_t sectnameLen)
 	return mem;
 }
 
-bool iniSection_addValue(
-	iniSection_t * restrict psect,
-	const char * restrict keystr, intptr_t keylen,
-	const char * restrict valstr, intptr_t vallen
-)
+static inline bool s_iniSection_addValue(iniSection_t * restrict psect, iniValue_t * restrict val)
 {
 	assert(psect != NULL);
+	assert(val   != NULL);
 
 	// Vajadusel allokeeritakse mälu väärtuste massiivi jaoks juurde
 	if (psect->numValues >= psect->maxValues)
@@ -639,17 +762,22 @@ bool iniSection_addValue(
 		psect->maxValues = newcap;
 	}
 
-	// Initsialiseeritakse uus väärtus
-	iniValue_t * val = iniValue_make(keystr, keylen, valstr, vallen);
-	if (val == NULL)
+	// Piisavalt suure sektsiooni võtmetele ehitatakse räsitabel, väiksemates otsitakse
+	// duplikaate massiivist
+	if ((psect->valueMap.entries == NULL) && (psect->numValues >= INI_SECTION_INDEX_MIN) &&
+		!s_iniSection_buildIndex(psect))
 	{
 		return false;
 	}
-
-	// Väärtus lisatakse räsitabelisse
-	if (!hashMapCK_insert(&psect->valueMap, val->key.str, val))
+	if (psect->valueMap.entries != NULL)
+	{
+		if (!hashMapOA_insert(&psect->valueMap, val->key.str, val))
+		{
+			return false;
+		}
+	}
+	else if (s_iniSection_findLinear(psect, val->key.str) != NULL)
 	{
-		iniValue_free(val);
 		return false;
 	}
 
@@ -662,25 +790,52 @@ bool iniSection_addValue(
 
 	return true;
 }
+bool iniSection_addValue(
+	iniSection_t * restrict psect,
+	const char * restrict keystr, intptr_t keylen,
+	const char * restrict valstr, intptr_t vallen
+)
+{
+	assert(psect != NULL);
+
+	// Initsialiseeritakse uus väärtus
+	iniValue_t * val = iniValue_make(keystr, keylen, valstr, vallen);
+	if (val == NULL)
+	{
+		return false;
+	}
+	else if (!s_iniSection_addValue(psect, val))
+	{
+		iniValue_free(val);
+		return false;
+	}
+
+	return true;
+}
 iniValue_t * iniSection_getValue(iniSection_t * restrict psect, const char * restrict keystr)
 {
 	assert(psect  != NULL);
 	assert(keystr != NULL);
 
-	hashNodeCK_t * node = hashMapCK_get(&psect->valueMap, keystr);
-	if (node == NULL)
+	if (psect->valueMap.entries == NULL)
+	{
+		return s_iniSection_findLinear(psect, keystr);
+	}
+	hashEntryOA_t * entry = hashMapOA_get(&psect->valueMap, keystr);
+	if (entry == NULL)
 	{
 		return NULL;
 	}
-	return node->value;
+	return entry->value;
 }
 bool iniSection_removeValue(iniSection_t * restrict psect, const char * restrict keystr)
 {
 	assert(psect  != NULL);
 	assert(keystr != NULL);
 
-	// Esmalt proovitakse väärtus eemaldada räsitabelist
-	iniValue_t * val = hashMapCK_remove(&psect->valueMap, keystr);
+	// Esmalt proovitakse väärtus eemaldada räsitabelist, selle puudumisel leitakse massiivist
+	iniValue_t * val = (psect->valueMap.entries != NULL) ? hashMapOA_remove(&psect->valueMap, keystr) :
+		s_iniSection_findLinear(psect, keystr);
 	if (val == NULL)
 	{
 		return false;
@@ -717,25 +872,37 @@ void iniSection_destroy(iniSection_t * restrict psect)
 		free(psect->values);
 		psect->values = NULL;
 	}
-	hashMapCK_destroy(&psect->valueMap);
+	hashMapOA_destroy(&psect->valueMap);
 }
 void iniSection_free(iniSection_t * restrict psect)
 {
 	assert(psect != NULL);
 	iniSection_destroy(psect);
-	free(psect);
+	if (!psect->inArena)
+	{
+		free(psect);
+	}
 }
 
 
-bool ini_init(ini_t * restrict pini)
+void ini_zero(ini_t * restrict pini)
 {
 	assert(pini != NULL);
 
 	pini->sections    = NULL;
 	pini->numSections = 0;
 	pini->maxSections = 0;
+	hashMapOA_zero(&pini->sectionMap);
+
+	iniReader_zero(&pini->reader);
+}
+bool ini_init(ini_t * restrict pini)
+{
+	assert(pini != NULL);
 
-	if (!hashMapCK_init(&pini->sectionMap, 1))
+	ini_zero(pini);
+
+	if (!hashMapOA_init(&pini->sectionMap, 1))
 	{
 		return false;
 	}
@@ -764,9 +931,10 @@ ini_t * ini_make(void)
 	return mem;
 }
 
-bool ini_addSection(ini_t * restrict pini, const char * restrict secstr, intptr_t seclen)
+static inline bool s_ini_addSection(ini_t * restrict pini, iniSection_t * restrict sec)
 {
 	assert(pini != NULL);
+	assert(sec  != NULL);
 
 	// Vajadusel allokeerib mälu juurde
 	if (pini->numSections >= pini->maxSections)
@@ -787,25 +955,35 @@ bool ini_addSection(ini_t * restrict pini, const char * restrict secstr, intptr_
 		pini->maxSections = newcap;
 	}
 
+	// Lisab uue sektsiooni nii räsitabelisse kui ka massiivi, hoiab järjekorda meeles
+
+	if (!hashMapOA_insert(&pini->sectionMap, sec->section.str, sec))
+	{
+		return false;
+	}
+
+	sec->idx = pini->numSections;
+	pini->sections[pini->numSections] = sec;
+	++pini->numSections;
+
+	return true;
+}
+bool ini_addSection(ini_t * restrict pini, const char * restrict secstr, intptr_t seclen)
+{
+	assert(pini != NULL);
+
 	// Teeb uue sektsiooni
 	iniSection_t * sec = iniSection_make(secstr, seclen);
 	if (sec == NULL)
 	{
 		return false;
 	}
-
-	// Lisab uue sektsiooni nii räsitabelisse kui ka massiivi, hoiab järjekorda meeles
-
-	if (!hashMapCK_insert(&pini->sectionMap, sec->section.str, sec))
+	else if (!s_ini_addSection(pini, sec))
 	{
 		iniSection_free(sec);
 		return false;
 	}
 
-	sec->idx = pini->numSections;
-	pini->sections[pini->numSections] = sec;
-	++pini->numSections;
-
 	return true;
 }
 iniSection_t * ini_getSection(ini_t * restrict pini, const char * restrict secstr)
@@ -813,12 +991,12 @@ iniSection_t * ini_getSection(ini_t * restrict pini, const char * restrict secst
 	assert(pini   != NULL);
 	assert(secstr != NULL);
 
-	hashNodeCK_t * node = hashMapCK_get(&pini->sectionMap, secstr);
-	if (node == NULL)
+	hashEntryOA_t * entry = hashMapOA_get(&pini->sectionMap, secstr);
+	if (entry == NULL)
 	{
 		return NULL;
 	}
-	return node->value;
+	return entry->value;
 }
 bool ini_removeSection(ini_t * restrict pini, const char * restrict secstr)
 {
@@ -841,13 +1019,216 @@ bool ini_removeSection(ini_t * restrict pini, const char * restrict secstr)
 	return true;
 }
 
-iniErr_t ini_checkData(const char * restrict string, intptr_t length)
+#define INI_BLOCK_SIZE 64
+
+/**
+ * @brief Tokenizer contexts, each has its own set of structural characters that
+ * end the current token
+ * 
+ */
+typedef enum iniScan
 {
-	assert(string != NULL);
+	inisCOMMENT, // '\n', '\r'
+	inisSECTION, // '\\', ']'
+	inisKEY,     // '\\', ' ', '\t', '=', ':'
+	inisQUOTED,  // '\\', '"'
+	inisVALUE,   // '\\', ';', '#', '\n', '\r'
+
+	inisNUM_CONTEXTS
+
+} iniScan_t;
+
+/**
+ * @brief Structural index of INI data, built 64 bytes at a time similarly to the
+ * first stage of simdjson. Every context has a bitmask of the current block, bit i
+ * corresponds to byte i of the block, so the tokenizer jumps straight to the next
+ * structural character instead of testing every byte.
+ * 
+ */
+typedef struct iniScanner
+{
+	const char * begin, * end;
+	const char * block;
+	uint64_t masks[inisNUM_CONTEXTS];
 
-	size_t realLen = (length == -1) ? strlen(string) : strnlen_s(string, (size_t)length);
+} iniScanner_t;
 
-	for (const char * end = string + realLen; string != end;)
+static inline unsigned s_ini_ctz64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return (unsigned)__builtin_ctzll(x);
+#else
+	unsigned n = 0;
+	for (; (x & 1U) == 0; x >>= 1)
+	{
+		++n;
+	}
+	return n;
+#endif
+}
+static inline void s_iniScanner_classify(iniScanner_t * restrict sc, const char * block)
+{
+	sc->block = block;
+
+	// Viimane osaline plokk kopeeritakse nullidega täidetud puhvrisse, null-märk ei
+	// kuulu ühtegi klassi
+	const char * data = block;
+	char tail[INI_BLOCK_SIZE];
+	const size_t avail = (size_t)(sc->end - block);
+	if (avail < INI_BLOCK_SIZE)
+	{
+		memset(tail, 0, sizeof(tail));
+		memcpy(tail, block, avail);
+		data = tail;
+	}
+
+	// Märgiklassid: '\\', tühik, omistus, kommentaar, reavahetus, jutumärk, ']'
+	uint64_t esc = 0, space = 0, assign = 0, comment = 0, newline = 0, quote = 0, close = 0;
+#if defined(__SSE2__)
+	// 16 baiti korraga, iga võrdluse tulemus pakitakse bitimaskiks
+	for (size_t i = 0; i < INI_BLOCK_SIZE; i += 16)
+	{
+		const __m128i v = _mm_loadu_si128((const __m128i *)(const void *)(data + i));
+		#define INI_MASK(x) ((uint64_t)(uint32_t)_mm_movemask_epi8(x) << i)
+		#define INI_EQ(ch) _mm_cmpeq_epi8(v, _mm_set1_epi8(ch))
+		esc     |= INI_MASK(INI_EQ('\\'));
+		space   |= INI_MASK(_mm_or_si128(INI_EQ(' '), INI_EQ('\t')));
+		assign  |= INI_MASK(_mm_or_si128(INI_EQ('='), INI_EQ(':')));
+		comment |= INI_MASK(_mm_or_si128(INI_EQ(';'), INI_EQ('#')));
+		newline |= INI_MASK(_mm_or_si128(INI_EQ('\n'), INI_EQ('\r')));
+		quote   |= INI_MASK(INI_EQ('"'));
+		close   |= INI_MASK(INI_EQ(']'));
+		#undef INI_EQ
+		#undef INI_MASK
+	}
+#else
+	for (size_t i = 0; i < INI_BLOCK_SIZE; ++i)
+	{
+		const uint64_t bit = UINT64_C(1) << i;
+		switch (data[i])
+		{
+		case '\\':
+			esc |= bit;
+			break;
+		case ' ':
+		case '\t':
+			space |= bit;
+			break;
+		case '=':
+		case ':':
+			assign |= bit;
+			break;
+		case ';':
+		case '#':
+			comment |= bit;
+			break;
+		case '\n':
+		case '\r':
+			newline |= bit;
+			break;
+		case '"':
+			quote |= bit;
+			break;
+		case ']':
+			close |= bit;
+			break;
+		default:
+			break;
+		}
+	}
+#endif
+	sc->masks[inisCOMMENT] = newline;
+	sc->masks[inisSECTION] = esc | close;
+	sc->masks[inisKEY]     = esc | space | assign;
+	sc->masks[inisQUOTED]  = esc | quote;
+	sc->masks[inisVALUE]   = esc | comment | newline;
+}
+/**
+ * @brief Finds the first structural character of the context at or after str,
+ * returns the end of data, if there is none
+ * 
+ */
+static inline const char * s_iniScanner_find(iniScanner_t * restrict sc, const char * str, iniScan_t context)
+{
+	while (str < sc->end)
+	{
+		// Plokid on joondatud andmete algusest, iga plokk klassifitseeritakse üks kord
+		const char * block = sc->begin + ((size_t)(str - sc->begin) & ~(size_t)(INI_BLOCK_SIZE - 1));
+		if (block != sc->block)
+		{
+			s_iniScanner_classify(sc, block);
+		}
+		const uint64_t mask = sc->masks[context] >> (size_t)(str - block);
+		if (mask != 0)
+		{
+			return str + s_ini_ctz64(mask);
+		}
+		else if ((size_t)(sc->end - block) <= INI_BLOCK_SIZE)
+		{
+			break;
+		}
+		str = block + INI_BLOCK_SIZE;
+	}
+	return sc->end;
+}
+/**
+ * @brief Same as s_iniScanner_find, but skips characters escaped with a backslash,
+ * returns NULL, if data ends with an unfinished escape. The context must contain
+ * the backslash
+ * 
+ */
+static inline const char * s_iniScanner_findUnescaped(iniScanner_t * restrict sc, const char * str, iniScan_t context)
+{
+	for (;;)
+	{
+		str = s_iniScanner_find(sc, str, context);
+		if ((str == sc->end) || (*str != '\\'))
+		{
+			return str;
+		}
+		else if ((str + 1) == sc->end)
+		{
+			return NULL;
+		}
+		// Paomärgile järgnev märk jäetakse vahele
+		str += 2;
+	}
+}
+
+static inline iniErr_t s_ini_parse(
+	const char * string,
+	size_t length,
+	char * source,
+	bool padded,
+	arena_t * restrict arena,
+	iniCallback_t callback,
+	void * userData
+)
+{
+	assert(string != NULL);
+	assert((callback == NULL) || ((source != NULL) && (arena != NULL)));
+
+	// Kontroll ja parsimine toimuvad samal läbimisel, callback == NULL korral
+	// ainult kontrollitakse, sõnesid ei tehta
+	// Sõned on vaated source puhvrisse, millel on sama sisu mis string'il,
+	// padded tähendab, et puhvri lõpus on veel üks kirjutatav bait. Puhvrid võivad
+	// kattuda, kirjutatakse ainult juba läbitud eraldajate asemele
+	const char * const begin = string;
+	char emptyStr[1] = { '\0' };
+	iniString_t cursect = {
+		.str   = emptyStr,
+		.len   = 0,
+		.owned = false
+	};
+	iniErr_t code = inieOK;
+	const char * const end = string + length;
+	// Eraldajad leitakse plokkide kaupa, üksikuid märke võrreldakse ainult nende vahel
+	iniScanner_t sc = {
+		.begin = string,
+		.end   = end,
+		.block = NULL
+	};
+	while (string != end)
 	{
 		if ((*string == ' ') || (*string == '\t') || (*string == '\n') || (*string == '\r'))
 		{
@@ -855,76 +1236,62 @@ iniErr_t ini_checkData(const char * restrict string, intptr_t length)
 			++string;
 			continue;
 		}
+		else if (*string == '\0')
+		{
+			// Null-terminaator lõpetab andmed
+			break;
+		}
 		else if ((*string == ';') || (*string == '#'))
 		{
 			// Ignoreerib kommentaare INI-failis
 			// Liigub rea lõppu
-			++string;
-			for (; string != end; ++string)
-			{
-				if ((*string == '\n') || (*string == '\r'))
-				{
-					++string;
-					break;
-				}
-			}
+			string = s_iniScanner_find(&sc, string + 1, inisCOMMENT);
+			string += (string != end);
 		}
 		else if (*string == '[')
 		{
 			// Leidis sektsiooni
 			++string;
-			bool found = false;
 			// Otsib üles sektsiooni nime lõpu
-			for (; string != end; ++string)
+			const char * secend = s_iniScanner_findUnescaped(&sc, string, inisSECTION);
+			if (secend == NULL)
 			{
-				if (*string == '\\')
-				{
-					++string;
-					if (string == end)
-					{
-						return inieESCAPE;
-					}
-					continue;
-				}
-				else if (*string == ']')
-				{
-					++string;
-					found = true;
-					break;
-				}
+				code = inieESCAPE;
+				break;
 			}
-			if (!found)
+			else if (secend == end)
 			{
-				return inieSECTION;
+				code = inieSECTION;
+				break;
 			}
-			for (; string != end; ++string)
+			// Teatab uuest sektsioonist, nime järel on alati ']', selle asemele saab
+			// null-terminaatori kirjutada
+			if (callback != NULL)
 			{
-				if ((*string == '\n') || (*string == '\r'))
+				if (!s_iniString_initSource(&cursect, arena, source + (string - begin), (size_t)(secend - string), true, true))
 				{
-					++string;
+					code = inieMEM;
+					break;
+				}
+				else if (!callback(userData, &cursect, NULL, NULL))
+				{
+					code = inieABORT;
 					break;
 				}
 			}
+			string = secend + 1;
 		}
 		else
 		{
 			// Key-value pair
-			for (; string != end; ++string)
+			const char * keystart = string, * keyend = s_iniScanner_findUnescaped(&sc, string, inisKEY);
+			if (keyend == NULL)
 			{
-				if (*string == '\\')
-				{
-					++string;
-					if (string == end)
-					{
-						return inieESCAPE;
-					}
-					continue;
-				}
-				else if ((*string == ' ') || (*string == '\t') || (*string == '=') || (*string == ':'))
-				{
-					break;
-				}
+				code = inieESCAPE;
+				break;
 			}
+			string = keyend;
+
 			bool found = false;
 			for (; string != end; ++string)
 			{
@@ -936,17 +1303,15 @@ iniErr_t ini_checkData(const char * restrict string, intptr_t length)
 				{
 					++string;
 					found = true;
-					break;
-				}
-				else
-				{
-					return inieVALUE;
 				}
+				break;
 			}
-			if (found == false)
+			if (!found)
 			{
-				return inieVALUE;
+				code = inieVALUE;
+				break;
 			}
+
 			for (; string != end; ++string)
 			{
 				if ((*string != ' ') && (*string != '\t'))
@@ -954,275 +1319,399 @@ iniErr_t ini_checkData(const char * restrict string, intptr_t length)
 					break;
 				}
 			}
-			if (*string == '"')
+			const char * valstart = string, * valend = end;
+			// Puhver ei pruugi olla null-terminaatoriga lõpetatud
+			if ((string != end) && (*string == '"'))
 			{
 				++string;
-				found = false;
-				for (; string != end; ++string)
+				valstart = string;
+				const char * quote = s_iniScanner_findUnescaped(&sc, string, inisQUOTED);
+				if (quote == NULL)
 				{
-					if (*string == '\\')
-					{
-						++string;
-						if (string == end)
-						{
-							return inieESCAPE;
-						}
-						continue;
-					}
-					else if (*string == '"')
-					{
-						++string;
-						found = true;
-						break;
-					}
+					code = inieESCAPE;
+					break;
 				}
-				if (found == false)
+				else if (quote == end)
 				{
-					return inieQUOTE;
+					code = inieQUOTE;
+					break;
 				}
+				valend = quote;
+				string = quote + 1;
 			}
 			else
 			{
-				for (; string != end; ++string)
+				string = s_iniScanner_findUnescaped(&sc, string, inisVALUE);
+				if (string == NULL)
+				{
+					code = inieESCAPE;
+					break;
+				}
+				else if (string != end)
 				{
-					if (*string == '\\')
+					valend = string;
+					// Eemaldab väärtuse lõpust whitespace'i
+					while ((valend != valstart) && ((*(valend - 1) == ' ') || (*(valend - 1) == '\t')))
 					{
-						++string;
-						if (string == end)
-						{
-							return inieESCAPE;
-						}
-						continue;
+						--valend;
 					}
-					else if ((*string == ';') || (*string == '#') || (*string == '\n') || (*string == '\r'))
+					// Vahetult väärtuse järel olev kommentaar jäetakse kohe vahele, sest
+					// väärtuse null-terminaator võib kirjutada üle kommentaari alguse
+					if ((*string == ';') || (*string == '#'))
 					{
-						string += (*string != ';') && (*string != '#');
-						break;
+						string = s_iniScanner_find(&sc, string + 1, inisCOMMENT);
 					}
+					string += (string != end);
+				}
+			}
+
+			// Teatab võtmest ja väärtusest praeguses sektsioonis, võtme järel on alati
+			// eraldaja, väärtus võib aga lõppeda andmete lõpus
+			if (callback != NULL)
+			{
+				iniString_t key, value;
+				if (!s_iniString_initSource(&key, arena, source + (keystart - begin), (size_t)(keyend - keystart), true, true) ||
+					!s_iniString_initSource(&value, arena, source + (valstart - begin), (size_t)(valend - valstart), padded || (valend != end), false))
+				{
+					code = inieMEM;
+					break;
+				}
+				else if (!callback(userData, &cursect, &key, &value))
+				{
+					code = inieABORT;
+					break;
 				}
 			}
 		}
 	}
-	
-	return inieOK;
+
+	return code;
+}
+
+iniErr_t ini_checkData(const char * restrict string, intptr_t length)
+{
+	assert(string != NULL);
+
+	return s_ini_parse(string, (length == -1) ? strlen(string) : (size_t)length, NULL, false, NULL, NULL, NULL);
 }
 iniErr_t ini_checkFile(const char * restrict fileName)
 {
 	assert(fileName != NULL);
-	
-	size_t sz;
-	char * str = fhelper_read(fileName, &sz);
-	
-	if (str == NULL)
+
+	// Fail loetakse otse mälukuvandist, koopiat ei tehta
+	fhelperMap_t map;
+	if (!fhelper_map(&map, fileName))
 	{
 		return inieMEM;
 	}
-	iniErr_t code = ini_checkData(str, (intptr_t)(sz - 1));
-	free(str);
+	iniErr_t code = ini_checkData(map.data, (intptr_t)map.length);
+	fhelper_unmap(&map);
 	return code;
 }
 
-iniErr_t ini_initData(ini_t * restrict pini, const char * restrict string, intptr_t length)
+
+void iniReader_zero(iniReader_t * restrict reader)
 {
-	assert(string != NULL);
-	assert(pini != NULL);
-	
-	size_t realLen = (length == -1) ? strlen(string) : strnlen_s(string, (size_t)length);
+	assert(reader != NULL);
+
+	reader->sourceMap = (fhelperMap_t){
+		.data   = NULL,
+		.length = 0,
+		.view   = NULL
+	};
+	reader->sourceData = NULL;
+	reader->length     = 0;
+
+	arena_init(&reader->arena, 0);
+}
+iniErr_t iniReader_initData(
+	iniReader_t * restrict reader,
+	const char * restrict string,
+	intptr_t length,
+	iniCallback_t callback,
+	void * userData
+)
+{
+	assert(reader   != NULL);
+	assert(string   != NULL);
+	assert(callback != NULL);
+
+	iniReader_zero(reader);
+
+	// Andmetest tehakse üks koopia, millesse sõnede vaated viitavad, lõpus on ruumi
+	// ka viimase sõne null-terminaatorile
+	size_t realLen = (length == -1) ? strlen(string) : (size_t)length;
+	reader->sourceData = malloc(sizeof(char) * (realLen + 1));
+	if (reader->sourceData == NULL)
+	{
+		return inieMEM;
+	}
+	memcpy(reader->sourceData, string, sizeof(char) * realLen);
+	reader->sourceData[realLen] = '\0';
+	reader->length = realLen;
+	// Areeni esimene plokk on lähteandmetega samas suurusjärgus
+	arena_init(&reader->arena, realLen);
+
+	// Andmed kontrollitakse parsimise käigus, eraldi kontrollimist ei tehta
+	return iniReader_parse(reader, 0, realLen, NULL, callback, userData);
+}
+iniErr_t iniReader_initFile(
+	iniReader_t * restrict reader,
+	const char * restrict fileName,
+	iniCallback_t callback,
+	void * userData
+)
+{
+	assert(reader   != NULL);
+	assert(fileName != NULL);
+	assert(callback != NULL);
 
-	// Check
-	iniErr_t code = ini_checkData(string, (intptr_t)realLen);
+	iniErr_t code = iniReader_openFile(reader, fileName);
 	if (code != inieOK)
 	{
 		return code;
 	}
+	return iniReader_parse(reader, 0, reader->length, NULL, callback, userData);
+}
+iniErr_t iniReader_openFile(iniReader_t * restrict reader, const char * restrict fileName)
+{
+	assert(reader   != NULL);
+	assert(fileName != NULL);
 
-	if (!ini_init(pini))
+	iniReader_zero(reader);
+
+	// Fail loetakse otse mälukuvandist, koopiat ei tehta. Null-terminaatorite
+	// kirjutamisel kopeeritakse ainult puudutatud lehed
+	if (!fhelper_mapCopy(&reader->sourceMap, fileName))
 	{
 		return inieMEM;
 	}
+	reader->length = reader->sourceMap.length;
+	arena_init(&reader->arena, reader->sourceMap.length);
 
-	// Parse
-	for (const char * end = string + realLen; string != end;)
+	writeLogger("File contents: %.*s", (int)reader->sourceMap.length, reader->sourceMap.data);
+
+	return inieOK;
+}
+iniErr_t iniReader_parse(
+	iniReader_t * restrict reader,
+	size_t offset,
+	size_t length,
+	arena_t * arena,
+	iniCallback_t callback,
+	void * userData
+)
+{
+	assert(reader   != NULL);
+	assert(callback != NULL);
+	assert(offset <= reader->length);
+	assert(length <= (reader->length - offset));
+
+	if (length == 0)
 	{
-		if ((*string == ' ') || (*string == '\t') || (*string == '\n') || (*string == '\r'))
+		return inieOK;
+	}
+
+	// Koopia lõpus on null-terminaatori jaoks ruumi, vahemiku järel olevad baidid
+	// kuuluvad aga teistele vahemikele
+	const bool copy = (reader->sourceData != NULL);
+	const char * data = copy ? reader->sourceData : reader->sourceMap.data;
+	char * source = copy ? reader->sourceData : reader->sourceMap.view;
+	return s_ini_parse(
+		data + offset,
+		length,
+		source + offset,
+		copy && ((offset + length) == reader->length),
+		(arena != NULL) ? arena : &reader->arena,
+		callback,
+		userData
+	);
+}
+static inline bool s_iniReader_isLineStart(const char * restrict data, size_t offset)
+{
+	// Paoga reavahetus kommentaaris lõpetab siiski rea, väärtustes ja võtmetes aga
+	// pole see lubatud, seega algab rida alati pärast reavahetust
+	return (offset == 0) || (data[offset - 1] == '\n') || (data[offset - 1] == '\r');
+}
+size_t iniReader_nextLine(const iniReader_t * restrict reader, size_t offset)
+{
+	assert(reader != NULL);
+
+	const char * data = (reader->sourceData != NULL) ? reader->sourceData : reader->sourceMap.data;
+	for (; offset < reader->length; ++offset)
+	{
+		if (s_iniReader_isLineStart(data, offset))
 		{
-			++string;
-			continue;
+			return offset;
 		}
-		else if ((*string == ';') || (*string == '#'))
+	}
+	return reader->length;
+}
+size_t iniReader_nextSection(const iniReader_t * restrict reader, size_t offset)
+{
+	assert(reader != NULL);
+
+	const char * data = (reader->sourceData != NULL) ? reader->sourceData : reader->sourceMap.data;
+	while (offset < reader->length)
+	{
+		const char * bracket = memchr(data + offset, '[', reader->length - offset);
+		if (bracket == NULL)
 		{
-			// Skip till end of line
-			++string;
-			for (; string != end; ++string)
-			{
-				if ((*string == '\n') || (*string == '\r'))
-				{
-					++string;
-					break;
-				}
-			}
+			break;
 		}
-		else if (*string == '[')
+		// Sulg alustab sektsiooni ainult siis, kui selle ees real on vaid whitespace
+		size_t start = (size_t)(bracket - data);
+		while ((start > 0) && ((data[start - 1] == ' ') || (data[start - 1] == '\t')))
 		{
-			// Add section
-			++string;
-			for (const char * secend = string; secend != end; ++secend)
-			{
-				if (*secend == '\\')
-				{
-					++secend;
-					if (secend == end)
-					{
-						return inieESCAPE;
-					}
-					continue;
-				}
-				else if (*secend == ']')
-				{
-					// Add section to list
-					if (!ini_addSection(pini, string, secend - string))
-					{
-						ini_destroy(pini);
-						return inieMEM;
-					}
-
-					// Go on
-					string = secend;
-					++string;
-					break;
-				}
-			}
+			--start;
 		}
-		else
+		if ((start >= offset) && s_iniReader_isLineStart(data, start))
 		{
-			const char * keystart = string, * keyend = string + 1;
-			// Add key-value pair to last (current) section
-			for (; string != end; ++string)
-			{
-				if (*string == '\\')
-				{
-					++string;
-					if (string == end)
-					{
-						ini_destroy(pini);
-						return inieESCAPE;
-					}
-					continue;
-				}
-				else if ((*string == ' ') || (*string == '\t') || (*string == '=') || (*string == ':'))
-				{
-					keyend = string;
-					break;
-				}
-			}
-			for (; string != end; ++string)
-			{
-				if ((*string == ' ') || (*string == '\t'))
-				{
-					continue;
-				}
-				else if ((*string == '=') || (*string == ':'))
-				{
-					++string;
-					break;
-				}
-			}
-			const char * valstart = string, * valend = end;
-			for (; string != end; ++string)
-			{
-				if ((*string != ' ') && (*string != '\t'))
-				{
-					valstart = string;
-					break;
-				}
-			}
-			if (*valstart == '"')
-			{
-				++valstart;
-				for (string = valstart; string != end; ++string)
-				{
-					if (*string == '\\')
-					{
-						++string;
-						if (string == end)
-						{
-							ini_destroy(pini);
-							return inieESCAPE;
-						}
-						continue;
-					}
-					else if (*string == '"')
-					{
-						valend = string;
-						++string;
-						break;
-					}
-				}
-			}
-			else
-			{
-				for (; string != end; ++string)
-				{
-					if (*string == '\\')
-					{
-						++string;
-						if (string == end)
-						{
-							ini_destroy(pini);
-							return inieESCAPE;
-						}
-						continue;
-					}
-					else if ((*string == ';') || (*string == '#') || (*string == '\n') || (*string == '\r'))
-					{
-						valend = string;
-						if ((*(valend - 1) == ' ') || (*(valend - 1) == '\t'))
-						{
-							--valend;
-							for (; valend != valstart; --valend)
-							{
-								if ((*valend != ' ') && (*valend != '\t'))
-								{
-									break;
-								}
-							}
-							++valend;
-						}
-						string += (*string != ';') & (*string != '#');
-						break;
-					}
-				}
-			}
+			return start;
+		}
+		offset = (size_t)(bracket - data) + 1;
+	}
+	return reader->length;
+}
+size_t iniReader_findSection(const iniReader_t * restrict reader, const char * restrict name, size_t * restrict plength)
+{
+	assert(reader != NULL);
+	assert(name != NULL);
+	assert(plength != NULL);
+
+	const char * data = (reader->sourceData != NULL) ? reader->sourceData : reader->sourceMap.data;
+	const size_t nameLen = strlen(name);
+	size_t header = iniReader_nextSection(reader, 0);
+	while (header < reader->length)
+	{
+		const size_t body = iniReader_nextLine(reader, header + 1);
+		const size_t next = iniReader_nextSection(reader, body);
+		// Päis on kujul [nimi], sulgude ees võib olla whitespace
+		size_t start = header;
+		while (data[start] != '[')
+		{
+			++start;
+		}
+		++start;
+		if (((start + nameLen) < reader->length) && (memcmp(data + start, name, nameLen) == 0) &&
+			(data[start + nameLen] == ']'))
+		{
+			*plength = next - body;
+			return body;
+		}
+		header = next;
+	}
+	*plength = 0;
+	return reader->length;
+}
+size_t iniReader_countLines(const iniReader_t * restrict reader, size_t offset, size_t length)
+{
+	assert(reader != NULL);
+	assert((offset + length) <= reader->length);
 
-			// Get current section
-			iniSection_t * cursect = pini->sections[pini->numSections - 1];
-			if (!iniSection_addValue(cursect, keystart, keyend - keystart, valstart, valend - valstart))
-			{
-				ini_destroy(pini);
-				return inieMEM;
-			}
+	if (length == 0)
+	{
+		return 0;
+	}
+	const char * data = (reader->sourceData != NULL) ? reader->sourceData : reader->sourceMap.data;
+	const char * end  = data + offset + length;
+	// Read lõpevad \n-iga, ainult \r-iga failides loetakse \r-e
+	const char sep = (memchr(data + offset, '\n', length) != NULL) ? '\n' : '\r';
+	size_t lines = 1;
+	for (const char * p = data + offset; (p = memchr(p, sep, (size_t)(end - p))) != NULL; ++p)
+	{
+		++lines;
+	}
+	return lines;
+}
+void iniReader_destroy(iniReader_t * restrict reader)
+{
+	assert(reader != NULL);
+
+	arena_destroy(&reader->arena);
+	fhelper_unmap(&reader->sourceMap);
+	if (reader->sourceData != NULL)
+	{
+		free(reader->sourceData);
+		reader->sourceData = NULL;
+	}
+}
+
+
+static bool s_ini_treeCallback(void * userData, const iniString_t * section, const iniString_t * key, const iniString_t * value)
+{
+	ini_t * pini = userData;
+	assert(pini    != NULL);
+	assert(section != NULL);
+
+	// Sektsioonid ja väärtused võetakse lugeja areenist, sõned jäävad vaadeteks.
+	// Ebaõnnestumisel jääb areeni mälu lihtsalt kasutamata
+	if (key == NULL)
+	{
+		iniSection_t * sec = arena_alloc(&pini->reader.arena, sizeof(iniSection_t));
+		if ((sec == NULL) || !s_iniSection_initValues(sec))
+		{
+			return false;
 		}
+		iniString_initView(&sec->section, section);
+		sec->inArena = true;
+		if (!s_ini_addSection(pini, sec))
+		{
+			iniSection_free(sec);
+			return false;
+		}
+		return true;
 	}
 
-	return inieOK;
+	assert(value != NULL);
+	iniValue_t * val = arena_alloc(&pini->reader.arena, sizeof(iniValue_t));
+	if (val == NULL)
+	{
+		return false;
+	}
+	iniString_initView(&val->key, key);
+	iniString_initView(&val->value, value);
+	val->inArena = true;
+
+	// Lisab väärtuse viimasesse (praegusesse) sektsiooni
+	return s_iniSection_addValue(pini->sections[pini->numSections - 1], val);
+}
+
+iniErr_t ini_initData(ini_t * restrict pini, const char * restrict string, intptr_t length)
+{
+	assert(string != NULL);
+	assert(pini != NULL);
+
+	if (!ini_init(pini))
+	{
+		return inieMEM;
+	}
+
+	// Puu ehitatakse voogedastava lugeja tagasikutsete abil
+	iniErr_t code = iniReader_initData(&pini->reader, string, length, &s_ini_treeCallback, pini);
+	if (code != inieOK)
+	{
+		ini_destroy(pini);
+	}
+	return (code == inieABORT) ? inieMEM : code;
 }
 iniErr_t ini_initFile(ini_t * restrict pini, const char * restrict fileName)
 {
 	assert(fileName != NULL);
 	assert(pini != NULL);
-	
-	size_t sz;
-	char * str = fhelper_read(fileName, &sz);
-	if (str == NULL)
+
+	if (!ini_init(pini))
 	{
 		return inieMEM;
 	}
 
-	writeLogger("File contents: %s", str);
-
-	iniErr_t code = ini_initData(pini, str, (intptr_t)(sz - 1));
-	free(str);
-	return code;
+	// Fail jääb mälukuvandina ini struktuurile
+	iniErr_t code = iniReader_initFile(&pini->reader, fileName, &s_ini_treeCallback, pini);
+	if (code != inieOK)
+	{
+		ini_destroy(pini);
+	}
+	return (code == inieABORT) ? inieMEM : code;
 }
 
 void ini_destroy(ini_t * restrict pini)
@@ -1241,7 +1730,13 @@ void ini_destroy(ini_t * restrict pini)
 		free(pini->sections);
 		pini->sections = NULL;
 	}
-	hashMapCK_destroy(&pini->sectionMap);
+	pini->numSections = 0;
+	pini->maxSections = 0;
+	hashMapOA_destroy(&pini->sectionMap);
+	hashMapOA_zero(&pini->sectionMap);
+
+	// Lugeja vabastatakse viimasena, sest sektsioonid ja sõned asuvad selle mälus
+	iniReader_destroy(&pini->reader);
 }
 void ini_free(ini_t * restrict pini)
 {
@@ -2,6 +2,8 @@
 #define INI_FILE_H
 
 #include "hashmap.h"
+#include "fileHelper.h"
+#include "arena.h"
 
 #include <stdint.h>
 #include <stdbool.h>
@@ -9,21 +11,32 @@
 
 #define FORBIDDEN_CODEPOINT 0xFFFF
 
+/**
+ * @brief Number of values, from which on a section gets a hash index of its keys,
+ * smaller sections are searched linearly
+ * 
+ */
+#define INI_SECTION_INDEX_MIN 8
+
 
 /**
  * @brief Data structure to remember string length associated with character array.
+ * String is either owned (heap-allocated) or a view to memory owned by someone else,
+ * e.g. the source buffer of an ini structure. Both are always null-terminated.
  * 
  */
 typedef struct iniString
 {
 	char * str;
 	size_t len;
+	bool owned;
 	
 } iniString_t;
 
 /**
  * @brief Data structure for INI file key-value pair, also holds index to remember
- * place in key-value ordered array.
+ * place in key-value ordered array. Structure's memory may belong to the arena of
+ * an ini structure, then iniValue_free only destroys the contents.
  * 
  */
 typedef struct iniValue_t
@@ -31,12 +44,16 @@ typedef struct iniValue_t
 	iniString_t key, value;
 
 	size_t idx;
+	bool inArena;
 
 } iniValue_t;
 
 /**
  * @brief Data structure for INI file section structure, also holds index to remember
- * place in sections' ordered array. Holds hashmap of value key's.
+ * place in sections' ordered array. Sections with at least INI_SECTION_INDEX_MIN
+ * values hold hashmap of value key's, smaller ones only the values array. Structure's
+ * memory may belong to the arena of an ini structure, then iniSection_free only
+ * destroys the contents.
  * 
  */
 typedef struct iniSection
@@ -46,15 +63,54 @@ typedef struct iniSection
 	iniValue_t ** values;
 	size_t numValues, maxValues;
 
-	hashMapCK_t valueMap;
+	// Hash index of keys, empty until the section reaches INI_SECTION_INDEX_MIN values
+	hashMapOA_t valueMap;
 
 	size_t idx;
+	bool inArena;
 
 } iniSection_t;
 
+/**
+ * @brief Callback for streaming INI reader. Called with key == value == NULL when
+ * a section starts, otherwise with a key-value pair of the current section. Keys
+ * outside any section belong to the section "" that has no start event. Strings
+ * are views that stay valid until the reader is destroyed.
+ * 
+ * @param userData User data pointer given to the reader
+ * @param section Name of the current section
+ * @param key Key of the value, NULL for section start
+ * @param value Value, NULL for section start
+ * @return true Continue reading
+ * @return false Abort reading, reader returns inieABORT
+ */
+typedef bool (*iniCallback_t)(
+	void * userData,
+	const iniString_t * section,
+	const iniString_t * key,
+	const iniString_t * value
+);
+
+/**
+ * @brief Streaming INI reader, owns the parsed source, either as a file view or as
+ * a heap copy, that unescaped keys, values and section names point to. Strings that
+ * can't be views are allocated from the arena, which is released at once.
+ * 
+ */
+typedef struct iniReader
+{
+	fhelperMap_t sourceMap;
+	char * sourceData;
+	size_t length;
+
+	arena_t arena;
+
+} iniReader_t;
+
 /**
  * @brief Data structure for INI file, holds memory for iniSection structure array.
- * Holds hashmap of section names.
+ * Holds hashmap of section names. Built on top of the streaming reader, parsed
+ * sections and values are allocated from the reader's arena.
  * 
  */
 typedef struct ini
@@ -62,7 +118,9 @@ typedef struct ini
 	iniSection_t ** sections;
 	size_t numSections, maxSections;
 
-	hashMapCK_t sectionMap;
+	hashMapOA_t sectionMap;
+
+	iniReader_t reader;
 
 } ini_t;
 
@@ -77,7 +135,8 @@ typedef enum iniErr
 	inieSECTION,
 	inieESCAPE,
 	inieVALUE,
-	inieQUOTE
+	inieQUOTE,
+	inieABORT
 
 } iniErr_t;
 
@@ -253,9 +312,18 @@ bool iniString_initCopy(iniString_t * restrict pstr, const iniString_t * restric
  * @return iniString_t* Resulting heap-allocated copy of src, NULL on failure
  */
 iniString_t * iniString_makeCopy(const iniString_t * restrict src);
+/**
+ * @brief Initialises iniString structure as a view to another string, nothing is
+ * copied or allocated. Source string's memory must outlive the view.
+ * 
+ * @param pstr Pointer to destination iniString structure
+ * @param src Pointer to source iniString structure
+ */
+void iniString_initView(iniString_t * restrict pstr, const iniString_t * restrict src);
 
 /**
- * @brief Destroys iniString object, frees memory allocated by string
+ * @brief Destroys iniString object, frees memory allocated by string, views are
+ * only reset
  * 
  * @param pstr Pointer to iniString structure
  */
@@ -381,7 +449,13 @@ void iniSection_free(iniSection_t * restrict psect);
 
 
 /**
- * @brief Initialises ini structure
+ * @brief Zeros the memory of ini structure, zeroed structure is safe to destroy
+ * 
+ * @param pini Pointer to ini structure
+ */
+void ini_zero(ini_t * restrict pini);
+/**
+ * @brief Initialises ini structure with an empty global section
  * 
  * @param pini Pointer to ini structure
  * @return true Success
@@ -424,10 +498,12 @@ iniSection_t * ini_getSection(ini_t * restrict pini, const char * restrict secst
 bool ini_removeSection(ini_t * restrict pini, const char * restrict secstr);
 
 /**
- * @brief Checks the validity of INI file data string
+ * @brief Checks the validity of INI file data string, runs the same single-pass
+ * parser as ini_initData without building the structure
  * 
  * @param string Pointer to character array of INI file data string to be checked
- * @param length Length of string, can be -1, if null-terminated
+ * @param length Length of string, can be -1, if null-terminated, data also ends at
+ * the first null-terminator outside of keys and values
  * @return iniErr_t Error code from checker, inieOK if INI string is valid
  */
 iniErr_t ini_checkData(const char * restrict string, intptr_t length);
@@ -440,20 +516,150 @@ iniErr_t ini_checkData(const char * restrict string, intptr_t length);
 iniErr_t ini_checkFile(const char * restrict fileName);
 
 /**
- * @brief Checks the validity of INI file data string, parses it to ini structure if valid
+ * @brief Zeros the memory of reader structure, zeroed structure is safe to destroy
+ *
+ * @param reader Pointer to reader structure
+ */
+void iniReader_zero(iniReader_t * restrict reader);
+/**
+ * @brief Streams INI file data string through a callback, validity is checked during
+ * the same pass, no tree is built. Data is copied once to a buffer owned by the reader.
+ *
+ * @param reader Pointer to reader structure, has to be destroyed also on error
+ * @param string Pointer to character array of INI file data string
+ * @param length Length of string, can be -1, if null-terminated, data also ends at
+ * the first null-terminator outside of keys and values
+ * @param callback Function called for every section start and key-value pair
+ * @param userData Pointer passed to callback
+ * @return iniErr_t Error code from parser, inieABORT if callback aborted reading
+ */
+iniErr_t iniReader_initData(
+	iniReader_t * restrict reader,
+	const char * restrict string,
+	intptr_t length,
+	iniCallback_t callback,
+	void * userData
+);
+/**
+ * @brief Streams INI file through a callback. File is kept mapped as a copy-on-write
+ * view until the reader is destroyed.
+ *
+ * @param reader Pointer to reader structure, has to be destroyed also on error
+ * @param fileName Pointer to null-terminated character array of INI file's name
+ * @param callback Function called for every section start and key-value pair
+ * @param userData Pointer passed to callback
+ * @return iniErr_t Error code from parser, inieABORT if callback aborted reading
+ */
+iniErr_t iniReader_initFile(
+	iniReader_t * restrict reader,
+	const char * restrict fileName,
+	iniCallback_t callback,
+	void * userData
+);
+/**
+ * @brief Opens INI file for parsing in parts with iniReader_parse, nothing is parsed
+ * yet. File is kept mapped as a copy-on-write view until the reader is destroyed.
+ *
+ * @param reader Pointer to reader structure, has to be destroyed also on error
+ * @param fileName Pointer to null-terminated character array of INI file's name
+ * @return iniErr_t inieOK on success, inieMEM if the file can't be opened
+ */
+iniErr_t iniReader_openFile(iniReader_t * restrict reader, const char * restrict fileName);
+/**
+ * @brief Streams a range of the reader's data through a callback. Range has to start
+ * at a line start given by iniReader_nextLine outside of any multi-line value and has
+ * to be parsed only once, keys before the first section header of the range belong to
+ * the section "". Null-terminators are written only inside the range, so disjoint
+ * ranges can be parsed concurrently, if every thread uses its own arena.
+ *
+ * @param reader Pointer to opened reader structure
+ * @param offset Offset of the range in bytes from the start of the data
+ * @param length Length of the range in bytes
+ * @param arena Pointer to arena for strings that can't be views, NULL uses the reader's
+ * own arena, the arena has to outlive the strings passed to callback
+ * @param callback Function called for every section start and key-value pair
+ * @param userData Pointer passed to callback
+ * @return iniErr_t Error code from parser, inieABORT if callback aborted reading
+ */
+iniErr_t iniReader_parse(
+	iniReader_t * restrict reader,
+	size_t offset,
+	size_t length,
+	arena_t * arena,
+	iniCallback_t callback,
+	void * userData
+);
+/**
+ * @brief Finds the first line start at or after offset. Scanning has to be done before
+ * the preceding range is parsed, as parsing replaces separators with null-terminators.
+ * Complexity: O(length of the line).
+ *
+ * @param reader Pointer to opened reader structure
+ * @param offset Offset in bytes from the start of the data
+ * @return size_t Offset of the line start, data length if there are no more lines
+ */
+size_t iniReader_nextLine(const iniReader_t * restrict reader, size_t offset);
+/**
+ * @brief Finds the first line at or after offset, which starts with a section header.
+ * Lines are scanned without parsing, so a header-like line inside a multi-line quoted
+ * value is also found, parsing the ranges reveals such cases as errors. Scanning has
+ * to be done before the preceding range is parsed.
+ *
+ * @param reader Pointer to opened reader structure
+ * @param offset Offset in bytes from the start of the data, should be a line start
+ * @return size_t Offset of the header line's start, data length if there are no more headers
+ */
+size_t iniReader_nextSection(const iniReader_t * restrict reader, size_t offset);
+/**
+ * @brief Finds the body of the first section with given name by scanning the section
+ * headers without parsing. Name is compared literally, headers with escape sequences
+ * aren't matched. Scanning has to be done before the data is parsed.
+ *
+ * @param reader Pointer to opened reader structure
+ * @param name Pointer to null-terminated character array of section's name
+ * @param plength Pointer to receive the body length in bytes, up to the next header
+ * @return size_t Offset of the body's first line, data length if section wasn't found
+ */
+size_t iniReader_findSection(const iniReader_t * restrict reader, const char * restrict name, size_t * restrict plength);
+/**
+ * @brief Counts lines in a range of the reader's data, gives an upper bound for the
+ * number of values in a section body before parsing it. Complexity: O(length).
+ *
+ * @param reader Pointer to opened reader structure
+ * @param offset Offset in bytes from the start of the data
+ * @param length Length of the range in bytes
+ * @return size_t Number of lines, a non-empty range without line breaks has 1 line
+ */
+size_t iniReader_countLines(const iniReader_t * restrict reader, size_t offset, size_t length);
+/**
+ * @brief Destroys reader structure, invalidates all strings passed to callbacks
+ *
+ * @param reader Pointer to reader structure
+ */
+void iniReader_destroy(iniReader_t * restrict reader);
+
+/**
+ * @brief Parses INI file data string to ini structure, validity is checked during
+ * the same pass, input is read only once. Data is copied once to a buffer owned by
+ * the ini structure, strings without escapes are views to that buffer.
  * 
  * @param pini Pointer to ini structure to be filled
  * @param string Pointer to character array of INI file data string to be checked
- * @param length Length of string, can be -1, if null-terminated
- * @return iniErr_t Error code from parser, inieOK if INI file is valid
+ * @param length Length of string, can be -1, if null-terminated, data also ends at
+ * the first null-terminator outside of keys and values
+ * @return iniErr_t Error code from parser, inieOK if INI file is valid, on error
+ * the ini structure is already destroyed
  */
 iniErr_t ini_initData(ini_t * restrict pini, const char * restrict string, intptr_t length);
 /**
- * @brief Checks the validity of INI file, parses it to ini structure if valid
+ * @brief Checks the validity of INI file, parses it to ini structure if valid. File
+ * is kept mapped as a copy-on-write view for the lifetime of the ini structure, strings
+ * without escapes are views to the mapping.
  * 
  * @param pini Pointer to ini structure to be filled
  * @param fileName Pointer to null-terminated character array of INI file's name to be checked
- * @return iniErr_t Error code from parser, inieOK if INI file is valid
+ * @return iniErr_t Error code from parser, inieOK if INI file is valid, on error
+ * the ini structure is already destroyed
  */
 iniErr_t ini_initFile(ini_t * restrict pini, const char * restrict fileName);
 
@@ -18,15 +18,65 @@ int main(int argc, char ** argv)
 	// Logger initsialiseeritakse, avatakse logifail, see toimub ainult debug-režiimis kompileerides
 	initLogger();
 
-	if (argc < 2)
+	// Valikulised lipud, ülejäänud argumendid on positsioonilised
+	const char * args[2] = { NULL, NULL };
+	const char * compileName = NULL, * stopsName = NULL;
+	dmLoadOptions_t opts = { .mergeTolerance = 0.0f, .numThreads = 0 };
+	size_t numArgs = 0;
+	for (int i = 1; i < argc; ++i)
 	{
-		fprintf(stderr, "Kasutus: %s [info fail.ini] ([v2ljund-pilt.svg])\n", argv[0]);
+		if ((strcmp(argv[i], "-t") == 0) && ((i + 1) < argc))
+		{
+			// Ristmike ühendamise tolerants
+			opts.mergeTolerance = mh_strtof(argv[i + 1], NULL);
+			++i;
+		}
+		else if ((strcmp(argv[i], "-j") == 0) && ((i + 1) < argc))
+		{
+			// Andmefaili lugemise lõimede arv, 0 tähendab protsessorite arvu
+			opts.numThreads = (size_t)strtoul(argv[i + 1], NULL, 10);
+			++i;
+		}
+		else if ((strcmp(argv[i], "-c") == 0) && ((i + 1) < argc))
+		{
+			// Teedevõrk kompileeritakse binaarseks kaardiks
+			compileName = argv[i + 1];
+			++i;
+		}
+		else if ((strcmp(argv[i], "-s") == 0) && ((i + 1) < argc))
+		{
+			// Peatuste fail, esimene argument on siis kompileeritud kaart
+			stopsName = argv[i + 1];
+			++i;
+		}
+		else if (numArgs < 2)
+		{
+			args[numArgs] = argv[i];
+			++numArgs;
+		}
+	}
+
+	if (numArgs < 1)
+	{
+		fprintf(stderr, "Kasutus: %s [-t tolerants] [-j l6imed] [-c kaart.bin] [-s peatused.ini] [info fail.ini | kaart.bin] ([v2ljund-pilt.svg])\n", argv[0]);
 		return 1;
 	}
 
+	if (compileName != NULL)
+	{
+		// Kompileeritakse ainult teedevõrk, peatused antakse igal käivitusel eraldi
+		if (dm_compileDataFile(args[0], compileName, &opts) != dmeOK)
+		{
+			fprintf(stderr, "Kaardi kompileerimine nurjus!\n");
+			return 1;
+		}
+		printf("Valmis: %s\n", compileName);
+		return 0;
+	}
+
 	// Andmed loetakse failist sisse
 	dataModel_t dm;
-	dmErr_t code = dm_initDataFile(&dm, argv[1]);
+	dmErr_t code = (stopsName != NULL) ? dm_initCompiled(&dm, args[0], stopsName) : dm_initDataFile(&dm, args[0], &opts);
 	const size_t totalStops = dm.numMidPoints + 2;
 
 	if (code != dmeOK)
@@ -35,6 +85,28 @@ int main(int argc, char ** argv)
 		return 1;
 	}
 
+	// Kontrollitakse enne otsinguid, kas kõik peatused on alguspunktist kättesaadavad
+	code = dm_checkConnectivity(&dm);
+	if (code == dmeUNREACHABLE)
+	{
+		fprintf(stderr, "Peatused, kuhu pole v6imalik j6uda:\n");
+		for (size_t i = 0; i < totalStops; ++i)
+		{
+			if (!dm.reachable[i])
+			{
+				fprintf(stderr, "  %s\n", dm.points[i].id.str);
+			}
+		}
+		dm_destroy(&dm);
+		return 1;
+	}
+	else if (code != dmeOK)
+	{
+		fprintf(stderr, "Viga teedev6rgu sidususe kontrollimisel!\n");
+		dm_destroy(&dm);
+		return 1;
+	}
+
 	// Tehakse naabrusmaatriks, teede "hindade" maatriks ning ristmike/punktide massiiv
 	// Tehakse ka optimaalsetest peatuste omavahelistest kaugustest maatriks
 	if (!dm_createMatrices(&dm))
@@ -103,11 +175,11 @@ int main(int argc, char ** argv)
 	putchar('\n');
 
 
-	if (argc > 2)
+	if (args[1] != NULL)
 	{
 		// SVG failinimi on antud, avatakse tekstikirjutamise režiimis, sest SVG on sarnane
 		// teistele XML-perekonna keeltele nagu näiteks HTML
-		FILE * fsvg = fopen(argv[2], "w");
+		FILE * fsvg = fopen(args[1], "w");
 		if (fsvg == NULL)
 		{
 			fprintf(stderr, "SVG faili avamine eba6nnestus!\n");
@@ -123,7 +195,7 @@ int main(int argc, char ** argv)
 
 		fclose(fsvg);
 
-		printf("Valmis: %s\n", argv[2]);
+		printf("Valmis: %s\n", args[1]);
 	}
 
 	// Andmemudel vabastatakse
@@ -1,5 +1,11 @@
 #include "mathHelper.h"
 
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <stdbool.h>
+#include <assert.h>
+
 int8_t mh_i8min(int8_t a, int8_t b)
 {
 	return (a < b) ? a : b;
@@ -136,3 +142,685 @@ long double mh_clampUnil(long double value, long double a, long double b)
 {
 	return (a < b) ? mh_clampl(value, a, b) : mh_clampl(value, b, a);
 }
+
+uint64_t mh_hilbertIdx(uint32_t x, uint32_t y, uint8_t order)
+{
+	const uint32_t maxCoord = (order >= 32) ? UINT32_MAX : (uint32_t)(((uint64_t)1 << order) - 1);
+
+	uint64_t d = 0;
+	for (uint64_t s = (order > 0) ? ((uint64_t)1 << (order - 1)) : 0; s > 0; s /= 2)
+	{
+		const uint64_t rx = (x & s) > 0, ry = (y & s) > 0;
+		d += s * s * ((3 * rx) ^ ry);
+		// Veerandi pööramine, et alamkõver algaks ja lõppeks õiges nurgas
+		if (ry == 0)
+		{
+			if (rx == 1)
+			{
+				x = maxCoord - x;
+				y = maxCoord - y;
+			}
+			const uint32_t t = x;
+			x = y;
+			y = t;
+		}
+	}
+	return d;
+}
+
+
+#define MH_FLOAT_MANTISSA_BITS 23
+#define MH_FLOAT_INF_BITS      UINT32_C(0x7F800000)
+#define MH_FLOAT_NAN_BITS      UINT32_C(0x7FC00000)
+
+// Clingeri kiirtee: täpselt esitatavad kümne astmed
+static const float s_mh_pow10f[] = {
+	1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+// Viie astmete 128-bitised normaliseeritud lähendid 5^MH_POW5_MIN ... 5^MH_POW5_MAX,
+// Eisel-Lemire'i algoritmi jaoks, kõrgem pool esimesena
+#define MH_POW5_MIN (-65)
+#define MH_POW5_MAX 38
+static const uint64_t s_mh_pow5[][2] = {
+	{ UINT64_C(0x86CCBB52EA94BAEA), UINT64_C(0x98E947129FC2B4E9) }, // 5^-65
+	{ UINT64_C(0xA87FEA27A539E9A5), UINT64_C(0x3F2398D747B36224) }, // 5^-64
+	{ UINT64_C(0xD29FE4B18E88640E), UINT64_C(0x8EEC7F0D19A03AAD) }, // 5^-63
+	{ UINT64_C(0x83A3EEEEF9153E89), UINT64_C(0x1953CF68300424AC) }, // 5^-62
+	{ UINT64_C(0xA48CEAAAB75A8E2B), UINT64_C(0x5FA8C3423C052DD7) }, // 5^-61
+	{ UINT64_C(0xCDB02555653131B6), UINT64_C(0x3792F412CB06794D) }, // 5^-60
+	{ UINT64_C(0x808E17555F3EBF11), UINT64_C(0xE2BBD88BBEE40BD0) }, // 5^-59
+	{ UINT64_C(0xA0B19D2AB70E6ED6), UINT64_C(0x5B6ACEAEAE9D0EC4) }, // 5^-58
+	{ UINT64_C(0xC8DE047564D20A8B), UINT64_C(0xF245825A5A445275) }, // 5^-57
+	{ UINT64_C(0xFB158592BE068D2E), UINT64_C(0xEED6E2F0F0D56712) }, // 5^-56
+	{ UINT64_C(0x9CED737BB6C4183D), UINT64_C(0x55464DD69685606B) }, // 5^-55
+	{ UINT64_C(0xC428D05AA4751E4C), UINT64_C(0xAA97E14C3C26B886) }, // 5^-54
+	{ UINT64_C(0xF53304714D9265DF), UINT64_C(0xD53DD99F4B3066A8) }, // 5^-53
+	{ UINT64_C(0x993FE2C6D07B7FAB), UINT64_C(0xE546A8038EFE4029) }, // 5^-52
+	{ UINT64_C(0xBF8FDB78849A5F96), UINT64_C(0xDE98520472BDD033) }, // 5^-51
+	{ UINT64_C(0xEF73D256A5C0F77C), UINT64_C(0x963E66858F6D4440) }, // 5^-50
+	{ UINT64_C(0x95A8637627989AAD), UINT64_C(0xDDE7001379A44AA8) }, // 5^-49
+	{ UINT64_C(0xBB127C53B17EC159), UINT64_C(0x5560C018580D5D52) }, // 5^-48
+	{ UINT64_C(0xE9D71B689DDE71AF), UINT64_C(0xAAB8F01E6E10B4A6) }, // 5^-47
+	{ UINT64_C(0x9226712162AB070D), UINT64_C(0xCAB3961304CA70E8) }, // 5^-46
+	{ UINT64_C(0xB6B00D69BB55C8D1), UINT64_C(0x3D607B97C5FD0D22) }, // 5^-45
+	{ UINT64_C(0xE45C10C42A2B3B05), UINT64_C(0x8CB89A7DB77C506A) }, // 5^-44
+	{ UINT64_C(0x8EB98A7A9A5B04E3), UINT64_C(0x77F3608E92ADB242) }, // 5^-43
+	{ UINT64_C(0xB267ED1940F1C61C), UINT64_C(0x55F038B237591ED3) }, // 5^-42
+	{ UINT64_C(0xDF01E85F912E37A3), UINT64_C(0x6B6C46DEC52F6688) }, // 5^-41
+	{ UINT64_C(0x8B61313BBABCE2C6), UINT64_C(0x2323AC4B3B3DA015) }, // 5^-40
+	{ UINT64_C(0xAE397D8AA96C1B77), UINT64_C(0xABEC975E0A0D081A) }, // 5^-39
+	{ UINT64_C(0xD9C7DCED53C72255), UINT64_C(0x96E7BD358C904A21) }, // 5^-38
+	{ UINT64_C(0x881CEA14545C7575), UINT64_C(0x7E50D64177DA2E54) }, // 5^-37
+	{ UINT64_C(0xAA242499697392D2), UINT64_C(0xDDE50BD1D5D0B9E9) }, // 5^-36
+	{ UINT64_C(0xD4AD2DBFC3D07787), UINT64_C(0x955E4EC64B44E864) }, // 5^-35
+	{ UINT64_C(0x84EC3C97DA624AB4), UINT64_C(0xBD5AF13BEF0B113E) }, // 5^-34
+	{ UINT64_C(0xA6274BBDD0FADD61), UINT64_C(0xECB1AD8AEACDD58E) }, // 5^-33
+	{ UINT64_C(0xCFB11EAD453994BA), UINT64_C(0x67DE18EDA5814AF2) }, // 5^-32
+	{ UINT64_C(0x81CEB32C4B43FCF4), UINT64_C(0x80EACF948770CED7) }, // 5^-31
+	{ UINT64_C(0xA2425FF75E14FC31), UINT64_C(0xA1258379A94D028D) }, // 5^-30
+	{ UINT64_C(0xCAD2F7F5359A3B3E), UINT64_C(0x096EE45813A04330) }, // 5^-29
+	{ UINT64_C(0xFD87B5F28300CA0D), UINT64_C(0x8BCA9D6E188853FC) }, // 5^-28
+	{ UINT64_C(0x9E74D1B791E07E48), UINT64_C(0x775EA264CF55347E) }, // 5^-27
+	{ UINT64_C(0xC612062576589DDA), UINT64_C(0x95364AFE032A819E) }, // 5^-26
+	{ UINT64_C(0xF79687AED3EEC551), UINT64_C(0x3A83DDBD83F52205) }, // 5^-25
+	{ UINT64_C(0x9ABE14CD44753B52), UINT64_C(0xC4926A9672793543) }, // 5^-24
+	{ UINT64_C(0xC16D9A0095928A27), UINT64_C(0x75B7053C0F178294) }, // 5^-23
+	{ UINT64_C(0xF1C90080BAF72CB1), UINT64_C(0x5324C68B12DD6339) }, // 5^-22
+	{ UINT64_C(0x971DA05074DA7BEE), UINT64_C(0xD3F6FC16EBCA5E04) }, // 5^-21
+	{ UINT64_C(0xBCE5086492111AEA), UINT64_C(0x88F4BB1CA6BCF585) }, // 5^-20
+	{ UINT64_C(0xEC1E4A7DB69561A5), UINT64_C(0x2B31E9E3D06C32E6) }, // 5^-19
+	{ UINT64_C(0x9392EE8E921D5D07), UINT64_C(0x3AFF322E62439FD0) }, // 5^-18
+	{ UINT64_C(0xB877AA3236A4B449), UINT64_C(0x09BEFEB9FAD487C3) }, // 5^-17
+	{ UINT64_C(0xE69594BEC44DE15B), UINT64_C(0x4C2EBE687989A9B4) }, // 5^-16
+	{ UINT64_C(0x901D7CF73AB0ACD9), UINT64_C(0x0F9D37014BF60A11) }, // 5^-15
+	{ UINT64_C(0xB424DC35095CD80F), UINT64_C(0x538484C19EF38C95) }, // 5^-14
+	{ UINT64_C(0xE12E13424BB40E13), UINT64_C(0x2865A5F206B06FBA) }, // 5^-13
+	{ UINT64_C(0x8CBCCC096F5088CB), UINT64_C(0xF93F87B7442E45D4) }, // 5^-12
+	{ UINT64_C(0xAFEBFF0BCB24AAFE), UINT64_C(0xF78F69A51539D749) }, // 5^-11
+	{ UINT64_C(0xDBE6FECEBDEDD5BE), UINT64_C(0xB573440E5A884D1C) }, // 5^-10
+	{ UINT64_C(0x89705F4136B4A597), UINT64_C(0x31680A88F8953031) }, // 5^-9
+	{ UINT64_C(0xABCC77118461CEFC), UINT64_C(0xFDC20D2B36BA7C3E) }, // 5^-8
+	{ UINT64_C(0xD6BF94D5E57A42BC), UINT64_C(0x3D32907604691B4D) }, // 5^-7
+	{ UINT64_C(0x8637BD05AF6C69B5), UINT64_C(0xA63F9A49C2C1B110) }, // 5^-6
+	{ UINT64_C(0xA7C5AC471B478423), UINT64_C(0x0FCF80DC33721D54) }, // 5^-5
+	{ UINT64_C(0xD1B71758E219652B), UINT64_C(0xD3C36113404EA4A9) }, // 5^-4
+	{ UINT64_C(0x83126E978D4FDF3B), UINT64_C(0x645A1CAC083126EA) }, // 5^-3
+	{ UINT64_C(0xA3D70A3D70A3D70A), UINT64_C(0x3D70A3D70A3D70A4) }, // 5^-2
+	{ UINT64_C(0xCCCCCCCCCCCCCCCC), UINT64_C(0xCCCCCCCCCCCCCCCD) }, // 5^-1
+	{ UINT64_C(0x8000000000000000), UINT64_C(0x0000000000000000) }, // 5^0
+	{ UINT64_C(0xA000000000000000), UINT64_C(0x0000000000000000) }, // 5^1
+	{ UINT64_C(0xC800000000000000), UINT64_C(0x0000000000000000) }, // 5^2
+	{ UINT64_C(0xFA00000000000000), UINT64_C(0x0000000000000000) }, // 5^3
+	{ UINT64_C(0x9C40000000000000), UINT64_C(0x0000000000000000) }, // 5^4
+	{ UINT64_C(0xC350000000000000), UINT64_C(0x0000000000000000) }, // 5^5
+	{ UINT64_C(0xF424000000000000), UINT64_C(0x0000000000000000) }, // 5^6
+	{ UINT64_C(0x9896800000000000), UINT64_C(0x0000000000000000) }, // 5^7
+	{ UINT64_C(0xBEBC200000000000), UINT64_C(0x0000000000000000) }, // 5^8
+	{ UINT64_C(0xEE6B280000000000), UINT64_C(0x0000000000000000) }, // 5^9
+	{ UINT64_C(0x9502F90000000000), UINT64_C(0x0000000000000000) }, // 5^10
+	{ UINT64_C(0xBA43B74000000000), UINT64_C(0x0000000000000000) }, // 5^11
+	{ UINT64_C(0xE8D4A51000000000), UINT64_C(0x0000000000000000) }, // 5^12
+	{ UINT64_C(0x9184E72A00000000), UINT64_C(0x0000000000000000) }, // 5^13
+	{ UINT64_C(0xB5E620F480000000), UINT64_C(0x0000000000000000) }, // 5^14
+	{ UINT64_C(0xE35FA931A0000000), UINT64_C(0x0000000000000000) }, // 5^15
+	{ UINT64_C(0x8E1BC9BF04000000), UINT64_C(0x0000000000000000) }, // 5^16
+	{ UINT64_C(0xB1A2BC2EC5000000), UINT64_C(0x0000000000000000) }, // 5^17
+	{ UINT64_C(0xDE0B6B3A76400000), UINT64_C(0x0000000000000000) }, // 5^18
+	{ UINT64_C(0x8AC7230489E80000), UINT64_C(0x0000000000000000) }, // 5^19
+	{ UINT64_C(0xAD78EBC5AC620000), UINT64_C(0x0000000000000000) }, // 5^20
+	{ UINT64_C(0xD8D726B7177A8000), UINT64_C(0x0000000000000000) }, // 5^21
+	{ UINT64_C(0x878678326EAC9000), UINT64_C(0x0000000000000000) }, // 5^22
+	{ UINT64_C(0xA968163F0A57B400), UINT64_C(0x0000000000000000) }, // 5^23
+	{ UINT64_C(0xD3C21BCECCEDA100), UINT64_C(0x0000000000000000) }, // 5^24
+	{ UINT64_C(0x84595161401484A0), UINT64_C(0x0000000000000000) }, // 5^25
+	{ UINT64_C(0xA56FA5B99019A5C8), UINT64_C(0x0000000000000000) }, // 5^26
+	{ UINT64_C(0xCECB8F27F4200F3A), UINT64_C(0x0000000000000000) }, // 5^27
+	{ UINT64_C(0x813F3978F8940984), UINT64_C(0x4000000000000000) }, // 5^28
+	{ UINT64_C(0xA18F07D736B90BE5), UINT64_C(0x5000000000000000) }, // 5^29
+	{ UINT64_C(0xC9F2C9CD04674EDE), UINT64_C(0xA400000000000000) }, // 5^30
+	{ UINT64_C(0xFC6F7C4045812296), UINT64_C(0x4D00000000000000) }, // 5^31
+	{ UINT64_C(0x9DC5ADA82B70B59D), UINT64_C(0xF020000000000000) }, // 5^32
+	{ UINT64_C(0xC5371912364CE305), UINT64_C(0x6C28000000000000) }, // 5^33
+	{ UINT64_C(0xF684DF56C3E01BC6), UINT64_C(0xC732000000000000) }, // 5^34
+	{ UINT64_C(0x9A130B963A6C115C), UINT64_C(0x3C7F400000000000) }, // 5^35
+	{ UINT64_C(0xC097CE7BC90715B3), UINT64_C(0x4B9F100000000000) }, // 5^36
+	{ UINT64_C(0xF0BDC21ABB48DB20), UINT64_C(0x1E86D40000000000) }, // 5^37
+	{ UINT64_C(0x96769950B50D88F4), UINT64_C(0x1314448000000000) }  // 5^38
+};
+
+static inline unsigned s_mh_clz64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return (unsigned)__builtin_clzll(x);
+#else
+	unsigned n = 0;
+	for (; (x & (UINT64_C(1) << 63)) == 0; x <<= 1)
+	{
+		++n;
+	}
+	return n;
+#endif
+}
+#ifdef __SIZEOF_INT128__
+__extension__ typedef unsigned __int128 mhU128_t;
+#endif
+static inline void s_mh_mul128(uint64_t a, uint64_t b, uint64_t * restrict hi, uint64_t * restrict lo)
+{
+#ifdef __SIZEOF_INT128__
+	const mhU128_t r = (mhU128_t)a * b;
+	*hi = (uint64_t)(r >> 64);
+	*lo = (uint64_t)r;
+#else
+	// Neli 32x32-bitist korrutist
+	const uint64_t aLo = a & UINT32_MAX, aHi = a >> 32, bLo = b & UINT32_MAX, bHi = b >> 32;
+	const uint64_t ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+	const uint64_t mid = (ll >> 32) + (lh & UINT32_MAX) + (hl & UINT32_MAX);
+	*lo = (mid << 32) | (ll & UINT32_MAX);
+	*hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+/**
+ * @brief Eisel-Lemire algorithm, converts w * 10^q exactly to the nearest binary32
+ * value, rounding ties to even
+ * 
+ * @return uint32_t Bit pattern of the positive result
+ */
+static inline uint32_t s_mh_eiselLemire(uint64_t w, int64_t q)
+{
+	if ((w == 0) || (q < MH_POW5_MIN))
+	{
+		return 0;
+	}
+	else if (q > MH_POW5_MAX)
+	{
+		return MH_FLOAT_INF_BITS;
+	}
+
+	const unsigned lz = s_mh_clz64(w);
+	w <<= lz;
+
+	// Korrutis viie astmega, vajadusel täpsustatakse alumise poolega
+	const uint64_t * pow5 = s_mh_pow5[q - MH_POW5_MIN];
+	uint64_t hi, lo;
+	s_mh_mul128(w, pow5[0], &hi, &lo);
+	const uint64_t precisionMask = UINT64_MAX >> (MH_FLOAT_MANTISSA_BITS + 3);
+	if ((hi & precisionMask) == precisionMask)
+	{
+		uint64_t hi2, lo2;
+		s_mh_mul128(w, pow5[1], &hi2, &lo2);
+		lo += hi2;
+		hi += (hi2 > lo);
+	}
+
+	const unsigned upperBit = (unsigned)(hi >> 63);
+	const unsigned shift = upperBit + 64 - MH_FLOAT_MANTISSA_BITS - 3;
+	uint64_t mantissa = hi >> shift;
+	// floor(q * log2(10)) + 63, jagamine ümardab alla ka negatiivsete q korral
+	const int64_t qlog2 = (INT64_C(217706) * q - ((q < 0) ? INT64_C(65535) : 0)) / INT64_C(65536);
+	int64_t power2 = qlog2 + 63 + (int64_t)upperBit - (int64_t)lz + 127;
+
+	if (power2 <= 0)
+	{
+		// Subnormaalne tulemus
+		if ((-power2 + 1) >= 64)
+		{
+			return 0;
+		}
+		mantissa >>= -power2 + 1;
+		mantissa += mantissa & 1;
+		mantissa >>= 1;
+		// Ümardamisel võib tulemus saada vähim normaalne arv, mantissi bitt on siis ka astendaja bitt
+		return (uint32_t)mantissa;
+	}
+
+	// Täpselt kahe võimaluse vahel olev väärtus ümardatakse paarisarvuks
+	if ((lo <= 1) && (q >= -17) && (q <= 10) && ((mantissa & 3) == 1) && ((mantissa << shift) == hi))
+	{
+		mantissa &= ~UINT64_C(1);
+	}
+	mantissa += mantissa & 1;
+	mantissa >>= 1;
+	if (mantissa >= (UINT64_C(2) << MH_FLOAT_MANTISSA_BITS))
+	{
+		mantissa = UINT64_C(1) << MH_FLOAT_MANTISSA_BITS;
+		++power2;
+	}
+	mantissa &= ~(UINT64_C(1) << MH_FLOAT_MANTISSA_BITS);
+	if (power2 >= 0xFF)
+	{
+		return MH_FLOAT_INF_BITS;
+	}
+	return ((uint32_t)power2 << MH_FLOAT_MANTISSA_BITS) | (uint32_t)mantissa;
+}
+
+// Suur täisarv pikkade kümnendsisendite täpseks ümardamiseks. Võrreldavad arvud on
+// kuni ~720 bitti: 129 tüvenumbrit, 5^175 ja kahe astmed vahemikus 2^-150 ... 2^104
+#define MH_BIG_LIMBS      40
+#define MH_DECIMAL_DIGITS 128
+
+typedef struct mhBig
+{
+	uint32_t limbs[MH_BIG_LIMBS];
+	size_t len;
+
+} mhBig_t;
+
+static inline void s_mh_bigMulAdd(mhBig_t * restrict b, uint32_t mul, uint32_t add)
+{
+	uint64_t carry = add;
+	for (size_t i = 0; i < b->len; ++i)
+	{
+		carry += (uint64_t)b->limbs[i] * mul;
+		b->limbs[i] = (uint32_t)carry;
+		carry >>= 32;
+	}
+	if (carry != 0)
+	{
+		assert(b->len < MH_BIG_LIMBS);
+		b->limbs[b->len] = (uint32_t)carry;
+		++b->len;
+	}
+}
+static inline void s_mh_bigMulPow5(mhBig_t * restrict b, int64_t n)
+{
+	// 5^13 mahub 32 bitti
+	for (; n >= 13; n -= 13)
+	{
+		s_mh_bigMulAdd(b, UINT32_C(1220703125), 0);
+	}
+	uint32_t rest = 1;
+	for (; n > 0; --n)
+	{
+		rest *= 5;
+	}
+	s_mh_bigMulAdd(b, rest, 0);
+}
+static inline void s_mh_bigShift(mhBig_t * restrict b, int64_t n)
+{
+	if (b->len == 0)
+	{
+		return;
+	}
+	const size_t words = (size_t)(n / 32), bits = (size_t)(n % 32);
+	assert((b->len + words + 1) <= MH_BIG_LIMBS);
+
+	b->limbs[b->len + words] = 0;
+	for (size_t i = b->len; i-- > 0;)
+	{
+		const uint64_t v = (uint64_t)b->limbs[i] << bits;
+		b->limbs[i + words + 1] |= (uint32_t)(v >> 32);
+		b->limbs[i + words] = (uint32_t)v;
+	}
+	for (size_t i = 0; i < words; ++i)
+	{
+		b->limbs[i] = 0;
+	}
+	b->len += words + 1;
+	while ((b->len > 0) && (b->limbs[b->len - 1] == 0))
+	{
+		--b->len;
+	}
+}
+static inline int s_mh_bigCmp(const mhBig_t * restrict a, const mhBig_t * restrict b)
+{
+	if (a->len != b->len)
+	{
+		return (a->len > b->len) ? 1 : -1;
+	}
+	for (size_t i = a->len; i-- > 0;)
+	{
+		if (a->limbs[i] != b->limbs[i])
+		{
+			return (a->limbs[i] > b->limbs[i]) ? 1 : -1;
+		}
+	}
+	return 0;
+}
+/**
+ * @brief Rounds a long decimal input exactly, the result is either bits or the next
+ * float. The decimal value is compared to the midpoint between the two as big integers.
+ * 
+ * @param digits Pointer to the first digit or the decimal point of the input
+ * @param expPart Value of the exponent part of the input
+ * @param bits Bit pattern of the positive result rounded from the truncated digits
+ * @return uint32_t Bit pattern of the positive correctly rounded result
+ */
+static inline uint32_t s_mh_roundDecimal(const char * restrict digits, int64_t expPart, uint32_t bits)
+{
+	// Esimesed MH_DECIMAL_DIGITS tüvenumbrit täisarvuna, ülejäänud nullist erinevad
+	// numbrid asendatakse ühe lisanumbriga, mis on alati väiksem kui vahe poolpunktini
+	mhBig_t dec = { .len = 0 }, mid = { .len = 0 };
+	int64_t exp10 = expPart;
+	unsigned numDigits = 0;
+	bool frac = false, sticky = false;
+	for (const char * p = digits; ; ++p)
+	{
+		if ((*p == '.') && !frac)
+		{
+			frac = true;
+			continue;
+		}
+		else if ((*p < '0') || (*p > '9'))
+		{
+			break;
+		}
+
+		if (numDigits < MH_DECIMAL_DIGITS)
+		{
+			s_mh_bigMulAdd(&dec, 10, (uint32_t)(*p - '0'));
+			numDigits += (dec.len != 0);
+			exp10 -= frac;
+		}
+		else
+		{
+			sticky |= (*p != '0');
+			exp10 += !frac;
+		}
+	}
+	if (sticky)
+	{
+		s_mh_bigMulAdd(&dec, 10, 1);
+		--exp10;
+	}
+
+	// Poolpunkt bits ja järgmise floati vahel on (2m + 1) * 2^(e - 1)
+	const uint32_t expField = bits >> MH_FLOAT_MANTISSA_BITS;
+	const uint32_t m = (bits & ((UINT32_C(1) << MH_FLOAT_MANTISSA_BITS) - 1)) | ((expField != 0) ? (UINT32_C(1) << MH_FLOAT_MANTISSA_BITS) : 0);
+	int64_t midExp2 = ((expField != 0) ? ((int64_t)expField - 150) : -149) - 1, decExp2 = 0;
+	s_mh_bigMulAdd(&mid, 1, 2 * m + 1);
+
+	// 10^e = 5^e * 2^e, negatiivsed astendajad viiakse teisele poole
+	if (exp10 >= 0)
+	{
+		s_mh_bigMulPow5(&dec, exp10);
+		decExp2 += exp10;
+	}
+	else
+	{
+		s_mh_bigMulPow5(&mid, -exp10);
+		midExp2 -= exp10;
+	}
+	if (decExp2 > midExp2)
+	{
+		s_mh_bigShift(&dec, decExp2 - midExp2);
+	}
+	else
+	{
+		s_mh_bigShift(&mid, midExp2 - decExp2);
+	}
+
+	// Täpselt poolpunktis ümardatakse paarisarvuks
+	const int cmp = s_mh_bigCmp(&dec, &mid);
+	return bits + (uint32_t)((cmp > 0) || ((cmp == 0) && ((bits & 1) != 0)));
+}
+static inline int s_mh_hexDigit(char c)
+{
+	if ((c >= '0') && (c <= '9'))
+	{
+		return c - '0';
+	}
+	// ASCII suur- ja väiketähed erinevad ühe bitiga, lokaadist sõltumatult
+	const char lower = (char)(c | 0x20);
+	return ((lower >= 'a') && (lower <= 'f')) ? (lower - 'a' + 10) : -1;
+}
+/**
+ * @brief Parses the optional exponent part of a number, exponents beyond 100000 are
+ * clamped, as they give zero or infinity anyway
+ * 
+ * @param p Pointer to the possible exponent marker
+ * @param marker Lowercase exponent marker, 'e' or 'p'
+ * @param pexp Pointer to receive the exponent, 0 if there is none
+ * @return const char* End of the exponent part, p if there is none
+ */
+static inline const char * s_mh_parseExp(const char * restrict p, char marker, int64_t * restrict pexp)
+{
+	*pexp = 0;
+	if ((char)(*p | 0x20) != marker)
+	{
+		return p;
+	}
+
+	const char * e = p + 1;
+	const bool expNeg = (*e == '-');
+	e += (*e == '-') || (*e == '+');
+	if ((*e < '0') || (*e > '9'))
+	{
+		return p;
+	}
+	int64_t expValue = 0;
+	for (; (*e >= '0') && (*e <= '9'); ++e)
+	{
+		if (expValue < 100000)
+		{
+			expValue = (expValue * 10) + (*e - '0');
+		}
+	}
+	*pexp = expNeg ? -expValue : expValue;
+	return e;
+}
+/**
+ * @brief Parses a hexadecimal float after the "0x" prefix, rounds to nearest, ties
+ * to even
+ * 
+ * @param p Pointer to the first hexadecimal digit or the point
+ * @param pend Pointer to receive the end of the number
+ * @return uint32_t Bit pattern of the positive result
+ */
+static inline uint32_t s_mh_parseHex(const char * restrict p, const char ** restrict pend)
+{
+	// Kuni 15 tüvenumbrit mantissi, ülejäänud jäävad ainult ümardamise jaoks meelde
+	uint64_t m = 0;
+	int64_t exp2 = 0;
+	bool frac = false, sticky = false;
+	for (; ; ++p)
+	{
+		if ((*p == '.') && !frac)
+		{
+			frac = true;
+			continue;
+		}
+		const int d = s_mh_hexDigit(*p);
+		if (d < 0)
+		{
+			break;
+		}
+
+		if (m < (UINT64_C(1) << 56))
+		{
+			m = (m << 4) | (uint64_t)d;
+			exp2 -= frac ? 4 : 0;
+		}
+		else
+		{
+			sticky |= (d != 0);
+			exp2 += frac ? 0 : 4;
+		}
+	}
+	int64_t expPart;
+	*pend = s_mh_parseExp(p, 'p', &expPart);
+	if (m == 0)
+	{
+		return 0;
+	}
+
+	// Mantiss normaliseeritakse 64 bitile, ärajäetud numbrid on madalaimas bitis
+	const unsigned lz = s_mh_clz64(m);
+	m = (m << lz) | (sticky ? 1 : 0);
+	const int64_t power2 = exp2 + expPart - (int64_t)lz + 63;
+	if (power2 > 127)
+	{
+		return MH_FLOAT_INF_BITS;
+	}
+
+	// Normaalse tulemuse korral jääb 24 bitti, subnormaalse korral vähem
+	const int64_t shift = 64 - MH_FLOAT_MANTISSA_BITS - 1 + ((power2 < -126) ? (-126 - power2) : 0);
+	if (shift > 64)
+	{
+		return 0;
+	}
+	uint64_t mantissa = (shift == 64) ? 0 : (m >> shift);
+	const uint64_t rest = (shift == 64) ? m : (m & ((UINT64_C(1) << shift) - 1)), half = UINT64_C(1) << (shift - 1);
+	mantissa += (rest > half) || ((rest == half) && ((mantissa & 1) != 0));
+	if (power2 < -126)
+	{
+		// Ümardamisel võib tulemus saada vähim normaalne arv, mantissi bitt on siis ka astendaja bitt
+		return (uint32_t)mantissa;
+	}
+
+	uint32_t expField = (uint32_t)(power2 + 127);
+	if (mantissa >= (UINT64_C(2) << MH_FLOAT_MANTISSA_BITS))
+	{
+		mantissa >>= 1;
+		++expField;
+	}
+	if (expField >= 0xFF)
+	{
+		return MH_FLOAT_INF_BITS;
+	}
+	return (expField << MH_FLOAT_MANTISSA_BITS) | ((uint32_t)mantissa & ((UINT32_C(1) << MH_FLOAT_MANTISSA_BITS) - 1));
+}
+/**
+ * @brief Matches a lowercase ASCII word case-insensitively
+ * 
+ * @return size_t Length of the word if matched, 0 otherwise
+ */
+static inline size_t s_mh_matchWord(const char * restrict p, const char * restrict word)
+{
+	size_t i = 0;
+	for (; word[i] != '\0'; ++i)
+	{
+		if ((char)(p[i] | 0x20) != word[i])
+		{
+			return 0;
+		}
+	}
+	return i;
+}
+float mh_strtof(const char * restrict str, const char ** restrict pend)
+{
+	assert(str != NULL);
+
+	const char * p = str;
+	while ((*p == ' ') || (*p == '\t') || (*p == '\n') || (*p == '\r') || (*p == '\f') || (*p == '\v'))
+	{
+		++p;
+	}
+	const bool neg = (*p == '-');
+	p += (*p == '-') || (*p == '+');
+	const uint32_t signBit = neg ? (UINT32_C(1) << 31) : 0;
+
+	float result;
+	uint32_t bits;
+	const char * end = str;
+	if ((p[0] == '0') && ((p[1] | 0x20) == 'x') &&
+		((s_mh_hexDigit(p[2]) >= 0) || ((p[2] == '.') && (s_mh_hexDigit(p[3]) >= 0))))
+	{
+		bits = s_mh_parseHex(p + 2, &end) | signBit;
+		if (pend != NULL)
+		{
+			*pend = end;
+		}
+		memcpy(&result, &bits, sizeof(float));
+		return result;
+	}
+
+	// Kuni 19 tüvenumbrit mahuvad 64-bitisesse mantissi, ülejäänud ainult nihutavad astendajat
+	const char * digits = p;
+	uint64_t w = 0;
+	int64_t exp10 = 0;
+	unsigned numDigits = 0;
+	bool truncated = false, anyDigits = false;
+	for (; (*p >= '0') && (*p <= '9'); ++p)
+	{
+		anyDigits = true;
+		if (numDigits < 19)
+		{
+			w = (w * 10) + (uint64_t)(*p - '0');
+			numDigits += (w != 0);
+		}
+		else
+		{
+			++exp10;
+			truncated |= (*p != '0');
+		}
+	}
+	if (*p == '.')
+	{
+		++p;
+		for (; (*p >= '0') && (*p <= '9'); ++p)
+		{
+			anyDigits = true;
+			if (numDigits < 19)
+			{
+				w = (w * 10) + (uint64_t)(*p - '0');
+				numDigits += (w != 0);
+				--exp10;
+			}
+			else
+			{
+				truncated |= (*p != '0');
+			}
+		}
+	}
+	if (!anyDigits)
+	{
+		// Lõpmatus, NaN või üldse mitte arv, NaN-i sulgudes olevat sisu ei kasutata
+		size_t len;
+		if ((len = s_mh_matchWord(p, "inf")) != 0)
+		{
+			bits = MH_FLOAT_INF_BITS | signBit;
+			end = p + len;
+			end += s_mh_matchWord(end, "inity");
+		}
+		else if ((len = s_mh_matchWord(p, "nan")) != 0)
+		{
+			bits = MH_FLOAT_NAN_BITS | signBit;
+			end = p + len;
+			if (*end == '(')
+			{
+				const char * q = end + 1;
+				while (((*q >= '0') && (*q <= '9')) || (((*q | 0x20) >= 'a') && ((*q | 0x20) <= 'z')) || (*q == '_'))
+				{
+					++q;
+				}
+				end = (*q == ')') ? (q + 1) : end;
+			}
+		}
+		else
+		{
+			bits = 0;
+		}
+		if (pend != NULL)
+		{
+			*pend = end;
+		}
+		memcpy(&result, &bits, sizeof(float));
+		return result;
+	}
+	int64_t expPart;
+	p = s_mh_parseExp(p, 'e', &expPart);
+	exp10 += expPart;
+	if (pend != NULL)
+	{
+		*pend = p;
+	}
+
+#if FLT_EVAL_METHOD == 0
+	if (!truncated && (w <= (UINT64_C(1) << (MH_FLOAT_MANTISSA_BITS + 1))) && (exp10 >= -10) && (exp10 <= 10))
+	{
+		// Mõlemad tegurid on täpsed, seega on ka üks korrutis või jagatis õigesti ümardatud
+		result = (exp10 < 0) ? ((float)w / s_mh_pow10f[-exp10]) : ((float)w * s_mh_pow10f[exp10]);
+		return neg ? -result : result;
+	}
+#endif
+	bits = s_mh_eiselLemire(w, exp10);
+	if (truncated && (bits != s_mh_eiselLemire(w + 1, exp10)))
+	{
+		// Ärajäetud numbrid võivad ümardamist mõjutada, otsustab täpne võrdlus
+		bits = s_mh_roundDecimal(digits, expPart, bits);
+	}
+	bits |= signBit;
+	memcpy(&result, &bits, sizeof(float));
+	return result;
+}
@@ -112,4 +112,31 @@ double mh_clampUni(double value, double a, double b);
 long double mh_clampUnil(long double value, long double a, long double b);
 
 
+/**
+ * @brief Calculates the distance of a point along the Hilbert curve filling a
+ * 2^order x 2^order grid, points close on the curve are also close on the grid.
+ * 
+ * @param x X-coordinate of the grid cell, less than 2^order
+ * @param y Y-coordinate of the grid cell, less than 2^order
+ * @param order Order of the curve, at most 32
+ * @return uint64_t Distance along the curve
+ */
+uint64_t mh_hilbertIdx(uint32_t x, uint32_t y, uint8_t order);
+
+/**
+ * @brief Converts decimal string to the nearest float, equivalent to strtof in the
+ * "C" locale regardless of the current locale, strtof itself is never called. Up to 19
+ * significant digits are converted with the Clinger fast path or the Eisel-Lemire
+ * algorithm, longer inputs that these can't round are compared exactly to the midpoint
+ * of the two nearest floats. Hexadecimal floats, infinities and NaNs are parsed too,
+ * contents of NaN's parentheses are ignored.
+ * 
+ * @param str Null-terminated string, leading whitespace is skipped
+ * @param pend Optional pointer to receive the end of the parsed number, str if no
+ * number was parsed
+ * @return float Parsed value, 0 if no number was parsed
+ */
+float mh_strtof(const char * restrict str, const char ** restrict pend);
+
+
 #endif
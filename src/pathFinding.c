@@ -27,109 +27,283 @@ size_t pf_calcIdx(size_t row, size_t col, size_t numCols)
 	return row * numCols + col;
 }
 
-bool pf_createRelationsCosts(
+/**
+ * @brief Data structure for a directed half-edge of the uncompressed road graph
+ * 
+ */
+typedef struct pf_halfEdge_impl
+{
+	size_t u, v;
+	float weight, length;
+
+} pf_halfEdge_implS;
+
+/**
+ * @brief Compares half-edges by source, target and weight, for qsort
+ * 
+ * @param a Pointer to first half-edge
+ * @param b Pointer to second half-edge
+ * @return int Negative, zero or positive like strcmp
+ */
+static int pf_halfEdge_cmp_impl(const void * a, const void * b)
+{
+	const pf_halfEdge_implS * e1 = a, * e2 = b;
+	if (e1->u != e2->u)
+	{
+		return (e1->u > e2->u) - (e1->u < e2->u);
+	}
+	else if (e1->v != e2->v)
+	{
+		return (e1->v > e2->v) - (e1->v < e2->v);
+	}
+	return (e1->weight > e2->weight) - (e1->weight < e2->weight);
+}
+
+void pf_zeroGraph(roadGraph_t * restrict g)
+{
+	assert(g != NULL);
+
+	*g = (roadGraph_t){
+		.numJunctions = 0,
+		.numNodes     = 0,
+		.numEdges     = 0,
+		.nodes        = NULL,
+		.nodeIdx      = NULL,
+		.offsets      = NULL,
+		.targets      = NULL,
+		.chainOffsets = NULL,
+		.chainPoints  = NULL,
+		.segWeights   = NULL,
+		.segLengths   = NULL
+	};
+}
+bool pf_createGraph(
 	line_t * const * restrict teed,
 	size_t numTeed,
-	const point_t *** restrict ppoints,
-	uint8_t ** restrict prelations,
-	float ** restrict pcosts,
-	size_t * restrict pNumJunctions
+	const point_t * const * restrict stops,
+	size_t numStops,
+	roadGraph_t * restrict g
 )
 {
 	assert(teed != NULL);
 	assert(numTeed > 0);
-	assert(ppoints != NULL);
-	assert(prelations != NULL);
-	assert(pcosts != NULL);
-	assert(pNumJunctions != NULL);
+	assert(stops != NULL);
+	assert(g != NULL);
+
+	pf_zeroGraph(g);
 
 	// Leiab ristmike koguarvu
-	*pNumJunctions = 0;
+	size_t numJunctions = 0;
 	for (size_t i = 0; i < numTeed; ++i)
 	{
 		const line_t * tee = teed[i];
 		if (tee != NULL)
 		{
 			size_t newRel = mh_zmax(tee->src->idx, tee->dst->idx) + 1;
-			*pNumJunctions = mh_zmax(*pNumJunctions, newRel);
+			numJunctions = mh_zmax(numJunctions, newRel);
 		}
 	}
-	assert(*pNumJunctions >= 2);
+	for (size_t i = 0; i < numStops; ++i)
+	{
+		numJunctions = mh_zmax(numJunctions, stops[i]->idx + 1);
+	}
+	assert(numJunctions >= 2);
 
-	// Teeb 1D-massiivi, mis hoiab 2D-maatriksit relatsioonidest, täidab nullidega
-	size_t memSize = pf_bArrBytes((*pNumJunctions) * (*pNumJunctions));
-	uint8_t * relmem = calloc(memSize, 1);
-	if (relmem == NULL)
+	// Ajutised massiivid: poolservad mõlemas suunas, ristmike punktid ja servade algused
+	pf_halfEdge_implS * half = malloc(sizeof(pf_halfEdge_implS) * 2 * numTeed);
+	const point_t ** junc    = malloc(sizeof(const point_t *) * numJunctions);
+	size_t * juncOffsets     = calloc(numJunctions + 1, sizeof(size_t));
+	bool * isStop            = calloc(numJunctions, sizeof(bool));
+	if ((half == NULL) || (junc == NULL) || (juncOffsets == NULL) || (isStop == NULL))
 	{
+		free(half);
+		free(junc);
+		free(juncOffsets);
+		free(isStop);
 		return false;
 	}
-	float * costs = malloc(sizeof(float) * (*pNumJunctions) * (*pNumJunctions));
-	if (costs == NULL)
+	for (size_t i = 0; i < numJunctions; ++i)
 	{
-		free(relmem);
-		return false;
+		junc[i] = NULL;
+	}
+	for (size_t i = 0; i < numStops; ++i)
+	{
+		junc[stops[i]->idx]   = stops[i];
+		isStop[stops[i]->idx] = true;
+	}
+
+	size_t numHalf = 0;
+	for (size_t i = 0; i < numTeed; ++i)
+	{
+		const line_t * tee = teed[i];
+		if (tee == NULL)
+		{
+			continue;
+		}
+		const size_t i1 = tee->src->idx, i2 = tee->dst->idx;
+		junc[i1] = tee->src;
+		junc[i2] = tee->dst;
+		// Silmused ei lühenda ühtegi teed
+		if (i1 == i2)
+		{
+			continue;
+		}
+
+		const float dx = tee->src->x - tee->dst->x;
+		const float dy = tee->src->y - tee->dst->y;
+		const float dist = sqrtf((dx * dx) + (dy * dy));
+		half[numHalf]     = (pf_halfEdge_implS){ .u = i1, .v = i2, .weight = dist * tee->cost, .length = dist };
+		half[numHalf + 1] = (pf_halfEdge_implS){ .u = i2, .v = i1, .weight = dist * tee->cost, .length = dist };
+		numHalf += 2;
+	}
+
+	// Sorteerimise järel jäetakse paralleelsetest teedest alles ainult odavaim
+	qsort(half, numHalf, sizeof(pf_halfEdge_implS), &pf_halfEdge_cmp_impl);
+	size_t numUnique = 0;
+	for (size_t i = 0; i < numHalf; ++i)
+	{
+		if ((numUnique == 0) || (half[numUnique - 1].u != half[i].u) || (half[numUnique - 1].v != half[i].v))
+		{
+			half[numUnique] = half[i];
+			++numUnique;
+		}
+	}
+	for (size_t i = 0; i < numUnique; ++i)
+	{
+		++juncOffsets[half[i].u + 1];
+	}
+	for (size_t i = 0; i < numJunctions; ++i)
+	{
+		juncOffsets[i + 1] += juncOffsets[i];
 	}
 
-	// Teeb ristmike pointerite massiivi
-	const point_t ** points = malloc(sizeof(const point_t *) * (*pNumJunctions));
-	if (points == NULL)
+	// Servade, ahelate vahepunktide ja lõikude arv ei ületa poolservade arvu
+	const size_t maxEdges = mh_zmax(numUnique, 1);
+	g->numJunctions = numJunctions;
+	g->nodes        = malloc(sizeof(const point_t *) * numJunctions);
+	g->nodeIdx      = malloc(sizeof(size_t) * numJunctions);
+	g->offsets      = malloc(sizeof(size_t) * (numJunctions + 1));
+	g->targets      = malloc(sizeof(size_t) * maxEdges);
+	g->chainOffsets = malloc(sizeof(size_t) * (maxEdges + 1));
+	g->chainPoints  = malloc(sizeof(const point_t *) * maxEdges);
+	g->segWeights   = malloc(sizeof(float) * maxEdges);
+	g->segLengths   = malloc(sizeof(float) * maxEdges);
+	if ((g->nodes == NULL) || (g->nodeIdx == NULL) || (g->offsets == NULL) || (g->targets == NULL) ||
+		(g->chainOffsets == NULL) || (g->chainPoints == NULL) || (g->segWeights == NULL) || (g->segLengths == NULL))
 	{
-		free(relmem);
-		free(costs);
+		free(half);
+		free(junc);
+		free(juncOffsets);
+		free(isStop);
+		pf_destroyGraph(g);
 		return false;
 	}
 
-	// Täidab "hindade" maatriksi esialgu igaks juhuks 1-dega
-	for (size_t i = 0, n = (*pNumJunctions) * (*pNumJunctions); i < n; ++i)
+	// Päris sõlmedeks jäävad peatused ja ristmikud, millel pole täpselt 2 naabrit
+	for (size_t i = 0; i < numJunctions; ++i)
 	{
-		costs[i] = 1.0f;
+		const size_t degree = juncOffsets[i + 1] - juncOffsets[i];
+		if ((junc[i] != NULL) && (isStop[i] || (degree != 2)))
+		{
+			g->nodes[g->numNodes] = junc[i];
+			g->nodeIdx[i] = g->numNodes;
+			++g->numNodes;
+		}
+		else
+		{
+			g->nodeIdx[i] = SIZE_MAX;
+		}
 	}
 
-	// Täidab maatriksi ja ristmike pointerite massiivi
-	for (size_t i = 0; i < numTeed; ++i)
+	// Igast päris sõlmest käiakse iga naabri kaudu ahel läbi järgmise päris sõlmeni
+	size_t numChain = 0;
+	for (size_t i = 0; i < numJunctions; ++i)
 	{
-		const line_t * tee = teed[i];
-		if (tee != NULL)
+		if (g->nodeIdx[i] == SIZE_MAX)
+		{
+			continue;
+		}
+		g->offsets[g->nodeIdx[i]] = g->numEdges;
+
+		for (size_t k = juncOffsets[i]; k < juncOffsets[i + 1]; ++k)
 		{
-			const size_t i1 = tee->src->idx, i2 = tee->dst->idx;
-			const size_t ci1 = pf_calcIdx(i1, i2, *pNumJunctions);
-			const size_t ci2 = pf_calcIdx(i2, i1, *pNumJunctions);
-			pf_bSet(relmem, ci1, true);
-			pf_bSet(relmem, ci2, true);
-
-			costs[ci1] = tee->cost;
-			costs[ci2] = tee->cost;
-			
-			points[i1] = tee->src;
-			points[i2] = tee->dst;
+			size_t prev = i, cur = half[k].v, numSeg = numChain + g->numEdges;
+			const size_t chainBeg = numChain;
+			g->segWeights[numSeg] = half[k].weight;
+			g->segLengths[numSeg] = half[k].length;
+			++numSeg;
+
+			while (g->nodeIdx[cur] == SIZE_MAX)
+			{
+				g->chainPoints[numChain] = junc[cur];
+				++numChain;
+
+				// Ahela sees oleval ristmikul on täpselt 2 naabrit, valitakse see, kust ei tuldud
+				const size_t first = juncOffsets[cur];
+				const size_t next  = (half[first].v != prev) ? first : (first + 1);
+				g->segWeights[numSeg] = half[next].weight;
+				g->segLengths[numSeg] = half[next].length;
+				++numSeg;
+				prev = cur;
+				cur  = half[next].v;
+			}
+			// Iseendasse tagasi jõudev ahel on kasutu
+			if (cur == i)
+			{
+				numChain = chainBeg;
+				continue;
+			}
+
+			g->targets[g->numEdges]      = g->nodeIdx[cur];
+			g->chainOffsets[g->numEdges] = chainBeg;
+			++g->numEdges;
 		}
 	}
-	
-	*prelations = relmem;
-	*pcosts     = costs;
-	*ppoints    = points;
+	g->offsets[g->numNodes]      = g->numEdges;
+	g->chainOffsets[g->numEdges] = numChain;
+
+	writeLogger("Compressed %zu junctions to %zu nodes, %zu edges", numJunctions, g->numNodes, g->numEdges);
+
+	free(half);
+	free(junc);
+	free(juncOffsets);
+	free(isStop);
+
 	return true;
 }
+void pf_destroyGraph(roadGraph_t * restrict g)
+{
+	assert(g != NULL);
+
+	free(g->nodes);
+	free(g->nodeIdx);
+	free(g->offsets);
+	free(g->targets);
+	free(g->chainOffsets);
+	free(g->chainPoints);
+	free(g->segWeights);
+	free(g->segLengths);
+	pf_zeroGraph(g);
+}
 
 
 bool pf_dijkstraSearch(
-	const point_t * const * restrict points,
-	const uint8_t * restrict relations,
-	const float * restrict costs,
-	size_t numJunctions,
+	const roadGraph_t * restrict g,
 	const point_t * restrict start,
 	prevDist_t ** restrict pprevdist
 )
 {
-	assert(points       != NULL);
-	assert(relations    != NULL);
-	assert(costs        != NULL);
-	assert(numJunctions >= 2);
+	assert(g            != NULL);
+	assert(g->numNodes  >= 2);
 	assert(start        != NULL);
+	assert(start->idx   < g->numJunctions);
 	assert(pprevdist    != NULL);
 
+	const size_t numNodes = g->numNodes, startIdx = g->nodeIdx[start->idx];
+	assert(startIdx != SIZE_MAX);
+
 	// Kui kasutaja ei andnud prevDist massiivi, siis allokeerib selle jaoks mälu
-	prevDist_t * prevdist = (*pprevdist != NULL) ? *pprevdist : malloc(sizeof(prevDist_t) * numJunctions);
+	prevDist_t * prevdist = (*pprevdist != NULL) ? *pprevdist : malloc(sizeof(prevDist_t) * numNodes);
 	if (prevdist == NULL)
 	{
 		return false;
@@ -140,22 +314,24 @@ bool pf_dijkstraSearch(
 	pq_init(&pq);
 
 	// prevdist inistialiseeritakse, kõikidesse punktidesse on alguspunktis teepikkus esialgu lõpmata suur
-	for (size_t i = 0; i < numJunctions; ++i)
+	for (size_t i = 0; i < numNodes; ++i)
 	{
-		if (i != start->idx)
+		if (i != startIdx)
 		{
 			prevdist[i] = (prevDist_t){
-				.dist   = INFINITY,
-				.actual = INFINITY,
-				.prev   = NULL
+				.dist     = INFINITY,
+				.actual   = INFINITY,
+				.prev     = NULL,
+				.prevEdge = SIZE_MAX
 			};
 		}
 		else
 		{
 			prevdist[i] = (prevDist_t){
-				.dist   = 0.0f,
-				.actual = 0.0f,
-				.prev   = NULL
+				.dist     = 0.0f,
+				.actual   = 0.0f,
+				.prev     = NULL,
+				.prevEdge = SIZE_MAX
 			};
 		}
 
@@ -177,29 +353,33 @@ bool pf_dijkstraSearch(
 		// Kontrollib igaks juhuks kas õnnestus, aga ainult DEBUG režiimis
 		assert(uIdx != SIZE_MAX);
 
-		writeLogger("Extracted minimum: %s; %.3f", points[uIdx]->id.str, (double)prevdist[uIdx].dist);
+		writeLogger("Extracted minimum: %s; %.3f", g->nodes[uIdx]->id.str, (double)prevdist[uIdx].dist);
 
-		// Käib läbi kõik punkti naabrid
-		for (size_t vIdx = 0; vIdx < pq.n_lut; ++vIdx)
+		// Käib läbi kõik sõlme servad, ahelad on juba ühe servana koos
+		for (size_t e = g->offsets[uIdx]; e < g->offsets[uIdx + 1]; ++e)
 		{
-			// Kontrollib kas punkt on naaber ning ikka veel eelisjärjekorras
-			if ((pq.lut[vIdx] != NULL) && pf_bGet(relations, pf_calcIdx(uIdx, vIdx, numJunctions)))
+			const size_t vIdx = g->targets[e];
+			// Kontrollib kas naaber on ikka veel eelisjärjekorras
+			if (pq.lut[vIdx] != NULL)
 			{
-				const float dx = points[uIdx]->x - points[vIdx]->x;
-				const float dy = points[uIdx]->y - points[vIdx]->y;
-				const float cost = costs[pf_calcIdx(uIdx, vIdx, numJunctions)];
-				const float dist = sqrtf((dx * dx) + (dy * dy));
-				const float alt = prevdist[uIdx].dist + dist * cost;
+				// Lõigud liidetakse ükshaaval, et tulemus ei sõltuks ahelate kokkupakkimisest
+				float alt = prevdist[uIdx].dist, actual = prevdist[uIdx].actual;
+				for (size_t seg = g->chainOffsets[e] + e, end = g->chainOffsets[e + 1] + e + 1; seg < end; ++seg)
+				{
+					alt    += g->segWeights[seg];
+					actual += g->segLengths[seg];
+				}
 				// Kontrollib kas uus leitud kaugus on lühem praegusest parimast
 				if (alt < prevdist[vIdx].dist)
 				{
-					writeLogger("New minimum for %s is %.3f, old: %.3f", points[vIdx]->id.str, (double)alt, (double)prevdist[vIdx].dist);
+					writeLogger("New minimum for %s is %.3f, old: %.3f", g->nodes[vIdx]->id.str, (double)alt, (double)prevdist[vIdx].dist);
 
 					// Initsialiseeritakse uuesti uue kaugusega
 					prevdist[vIdx] = (prevDist_t){
-						.dist   = alt,
-						.actual = prevdist[uIdx].actual + dist,
-						.prev   = points[uIdx]
+						.dist     = alt,
+						.actual   = actual,
+						.prev     = g->nodes[uIdx],
+						.prevEdge = e
 					};
 					// Vähendab tähtsust Fibonacci kuhjas
 					pq_decPriority(&pq, vIdx, alt);
@@ -218,17 +398,13 @@ bool pf_dijkstraSearch(
 bool pf_makeDistMatrix(
 	const point_t * const * restrict startpoints,
 	size_t numStops,
-	const hashMapCK_t * restrict stopsMap,
-	line_t * const * restrict teed,
-	size_t numTeed,
+	const roadGraph_t * restrict g,
 	distActual_t ** restrict pmatrix
 )
 {
 	assert(startpoints != NULL);
 	assert(numStops >= 2);
-	assert(stopsMap != NULL);
-	assert(teed != NULL);
-	assert(numTeed > 0);
+	assert(g != NULL);
 	assert(pmatrix != NULL);
 
 	// Teeb 1D-allokeeritud 2D-maatriksi 
@@ -238,45 +414,15 @@ bool pf_makeDistMatrix(
 		return false;
 	}
 
-	// Teeb relatsioonide maatriksi Dijkstra algoritmi jaoks
-	size_t numJunctions;
-	uint8_t * relations = NULL;
-	float * costs = NULL;
-	const point_t ** points = NULL;
-	bool result = pf_createRelationsCosts(
-		teed,
-		numTeed,
-		&points,
-		&relations,
-		&costs,
-		&numJunctions
-	);
-	if (!result)
-	{
-		free(matrix);
-		return false;
-	}
-
 	prevDist_t * distances = NULL;
 
 	// Viimast punkti ei pea läbi käima, sest kõikide eelnevate punktidega saab maatriksi täidetud
 	for (size_t i = 0, n_1 = numStops - 1; i < n_1; ++i)
 	{
 		// Leiab lühimad teed kõikidesse punktidesse konkreetsest alguspunktist
-		result = pf_dijkstraSearch(
-			points,
-			relations,
-			costs,
-			numJunctions,
-			startpoints[i],
-			&distances
-		);
-		if (!result)
+		if (!pf_dijkstraSearch(g, startpoints[i], &distances))
 		{
 			free(matrix);
-			free(points);
-			free(costs);
-			free(relations);
 			return false;
 		}
 		
@@ -284,37 +430,28 @@ bool pf_makeDistMatrix(
 
 		// Log the dijkstra's path
 		writeLogger("Starting point: %s", startpoints[i]->id.str);
-		for (size_t j = 0; j < numJunctions; ++j)
+		for (size_t j = 0; j < g->numNodes; ++j)
 		{
-			writeLogger("%s -> %s: %.3f", distances[j].prev == NULL ? startpoints[i]->id.str : distances[j].prev->id.str, points[j]->id.str, (double)distances[j].dist);
+			writeLogger("%s -> %s: %.3f", distances[j].prev == NULL ? startpoints[i]->id.str : distances[j].prev->id.str, g->nodes[j]->id.str, (double)distances[j].dist);
 		}
 
 		#endif
 
-		// Täidab maatriksit lühimate teedega, arvestab ainult soovitud peatuspunkte
-		for (size_t j = 0; j < numJunctions; ++j)
+		// Täidab maatriksit lühimate teedega, peatused on alati graafi sõlmed, seega
+		// loetakse nende kaugused otse sõlmede indeksite järgi
+		for (size_t idx = 0; idx < numStops; ++idx)
 		{
-			// Kontrollib kas punkt on peatuspunkt või mitte
-			hashNodeCK_t * node = hashMapCK_get(stopsMap, points[j]->id.str);
-			const point_t ** ppoint = (node != NULL) ? node->value : NULL;
-			if ((ppoint != NULL) && (points[j] == *ppoint))
-			{
-				// Arvutab punkti indeksi peatuste seas
-				const size_t idx = (size_t)(ppoint - startpoints);
-				const distActual_t distActual = {
-					.dist   = distances[j].dist,
-					.actual = distances[j].actual
-				};
-				matrix[i   * numStops + idx] = distActual;
-				matrix[idx * numStops + i  ] = distActual;
-			}
+			const size_t j = g->nodeIdx[startpoints[idx]->idx];
+			const distActual_t distActual = {
+				.dist   = distances[j].dist,
+				.actual = distances[j].actual
+			};
+			matrix[i   * numStops + idx] = distActual;
+			matrix[idx * numStops + i  ] = distActual;
 		}
 	}
 
-	free(points);
 	free(distances);
-	free(costs);
-	free(relations);
 
 	*pmatrix = matrix;
 	return true;
@@ -562,10 +699,7 @@ bool pf_generateShortestPath(
 	const size_t * restrict bestIndexes,
 	const point_t * const * restrict startpoints,
 	size_t numStops,
-	const point_t * const * restrict points,
-	const uint8_t * restrict relations,
-	const float * restrict costs,
-	size_t numRelations,
+	const roadGraph_t * restrict g,
 	const point_t *** restrict ppath,
 	size_t * restrict ppathLen
 )
@@ -573,10 +707,7 @@ bool pf_generateShortestPath(
 	assert(bestIndexes  != NULL);
 	assert(startpoints  != NULL);
 	assert(numStops    >= 2);
-	assert(points       != NULL);
-	assert(relations    != NULL);
-	assert(costs        != NULL);
-	assert(numRelations > 0);
+	assert(g            != NULL);
 	assert(ppath        != NULL);
 	assert(ppathLen     != NULL);
 
@@ -588,7 +719,8 @@ bool pf_generateShortestPath(
 	}
 	path[0] = startpoints[bestIndexes[0]];
 
-	const point_t ** smallPath = malloc(sizeof(const point_t *) * numRelations);
+	// Lihtne rada läbib iga ristmikku ülimalt ühe korra
+	const point_t ** smallPath = malloc(sizeof(const point_t *) * g->numJunctions);
 	size_t smallPathLen = 0;
 	if (smallPath == NULL)
 	{
@@ -603,34 +735,37 @@ bool pf_generateShortestPath(
 		const point_t * start = startpoints[bestIndexes[i]];
 		const point_t * stop  = startpoints[bestIndexes[i + 1]];
 
-		bool result = pf_dijkstraSearch(
-			points,
-			relations,
-			costs,
-			numRelations,
-			start,
-			&distances
-		);
-		if (!result)
+		if (!pf_dijkstraSearch(g, start, &distances))
 		{
 			free(smallPath);
 			free(path);
 			return false;
 		}
 
-		// Teeb uue raja alates lõpp-punktist kuni alguseni
-		const point_t * node = stop;
+		// Teeb uue raja alates lõpp-punktist kuni alguseni, ahelate vahepunktid pakitakse lahti
+		const size_t startIdx = g->nodeIdx[start->idx];
+		size_t nodeIdx = g->nodeIdx[stop->idx];
 		smallPathLen = 0;
-		for (size_t j = 0; j < numRelations; ++j)
+		while (nodeIdx != startIdx)
 		{
-			if (node == start)
+			const size_t e = distances[nodeIdx].prevEdge;
+			// Lõpp-punkt ei ole alguspunktist kättesaadav
+			if (e == SIZE_MAX)
 			{
-				break;
+				free(smallPath);
+				free(path);
+				free(distances);
+				return false;
 			}
 
-			smallPath[j] = node;
+			smallPath[smallPathLen] = g->nodes[nodeIdx];
 			++smallPathLen;
-			node = distances[node->idx].prev;
+			for (size_t k = g->chainOffsets[e + 1]; k > g->chainOffsets[e]; --k)
+			{
+				smallPath[smallPathLen] = g->chainPoints[k - 1];
+				++smallPathLen;
+			}
+			nodeIdx = g->nodeIdx[distances[nodeIdx].prev->idx];
 		}
 
 		// Vajadusel suurendab raja pikkust
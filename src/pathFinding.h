@@ -40,70 +40,72 @@ size_t pf_bArrBytes(size_t numItems);
 size_t pf_calcIdx(size_t row, size_t col, size_t numCols);
 
 /**
- * @brief Creates relational matrix & unique junctions array from roads
+ * @brief Zeroes the road graph structure, safe to destroy afterwards
+ * 
+ * @param g Pointer to roadGraph structure
+ */
+void pf_zeroGraph(roadGraph_t * restrict g);
+/**
+ * @brief Creates compressed CSR road graph from roads. Junctions with exactly two
+ * distinct neighbours are collapsed into the edges passing through them, unless they
+ * are stops. Parallel roads between the same junctions keep the cheapest one.
  * 
  * @param teed Roads array
  * @param numTeed Number of roads
- * @param ppoints Pointer to receiving the array of unique junction pointers, data
- * in there corresponds directly to the rows/columns of the relational matrix
- * @param prelations Pointer to receiving 1D array for the relational matrix
- * @param pcosts Pointer to receiving 1D array for the costs matrix
- * @param pNumJunctions Pointer to receiving the number of unique junctions
+ * @param stops Array of stop pointers, these always stay as graph nodes
+ * @param numStops Number of stops
+ * @param g Pointer to receiving roadGraph structure
  * @return true Success
  * @return false Failure
  */
-bool pf_createRelationsCosts(
+bool pf_createGraph(
 	line_t * const * restrict teed,
 	size_t numTeed,
-	const point_t *** restrict ppoints,
-	uint8_t ** restrict prelations,
-	float ** restrict pcosts,
-	size_t * restrict pNumJunctions
+	const point_t * const * restrict stops,
+	size_t numStops,
+	roadGraph_t * restrict g
 );
-
 /**
- * @brief Data structure for the Dijkstra algorithm, holds current best distance and
- * pointer to previous point via which the point was reached
+ * @brief Destroys the road graph structure, frees all memory
+ * 
+ * @param g Pointer to roadGraph structure
+ */
+void pf_destroyGraph(roadGraph_t * restrict g);
+/**
+ * @brief Data structure for the Dijkstra algorithm, holds current best distance,
+ * pointer to previous point and the graph edge via which the point was reached
  * 
  */
 typedef struct prevDist
 {
 	float dist, actual;
 	const point_t * prev;
+	size_t prevEdge;
 
 } prevDist_t;
 
 /**
  * @brief Performs the Dijkstra optimal path search algorithm starting from given point.
- * Returns shortest paths to all junctions, uses junction relational matrix.
+ * Returns shortest paths to all graph nodes, uses the compressed road graph.
  * 
- * @param points Array of unique junction pointers
- * @param relations Relational matrix
- * @param costs Costs matrix corresponding to the relational matrix
- * @param numJunctions Number of unique junctions
- * @param start Starting point pointer
- * @param pprevdist Pointer to receiving prevDist structure array
+ * @param g Pointer to road graph
+ * @param start Starting point pointer, has to be a graph node
+ * @param pprevdist Pointer to receiving prevDist structure array, indexed by node
  * @return true Success
  * @return false Failure
  */
 bool pf_dijkstraSearch(
-	const point_t * const * restrict points,
-	const uint8_t * restrict relations,
-	const float * restrict costs,
-	size_t numJunctions,
+	const roadGraph_t * restrict g,
 	const point_t * restrict start,
 	prevDist_t ** restrict pprevdist
 );
-
 /**
  * @brief Creates 1D-allocated 2D matrix of shortest distances between any
  * two desired points.
  * 
  * @param startpoints Array of starting point pointers 
- * @param numStops Number of (stopping) points
- * @param stopsMap Hashmap of starting/stopping points
- * @param teed Roads array
- * @param numTeed Number of roads
+ * @param numStops Number of (stopping) points, all of them must be nodes of the road graph
+ * @param g Pointer to road graph
  * @param pmatrix Pointer to receiving 1D matrix of shortest distances
  * @return true Success
  * @return false Failure
@@ -111,12 +113,9 @@ bool pf_dijkstraSearch(
 bool pf_makeDistMatrix(
 	const point_t * const * restrict startpoints,
 	size_t numStops,
-	const hashMapCK_t * restrict stopsMap,
-	line_t * const * restrict teed,
-	size_t numTeed,
+	const roadGraph_t * restrict g,
 	distActual_t ** restrict pmatrix
 );
-
 /**
  * @brief Finds optimal sequence of stops to take given the shortest distances
  * between any two points and the starting & stopping points. Uses Dijkstra search
@@ -136,17 +135,13 @@ bool pf_findOptimalMatrixOrder(
 
 /**
  * @brief Generates the detailed shortest path according to best order of stopping
- * points, array of starting points, array of all points, relational matrix &
- * cost matrix. The function also requires the total number of stops and the total
- * number of points/junctions.
+ * points, array of starting points and the road graph. Collapsed chains are unpacked,
+ * so the path contains every junction passed.
  * 
  * @param bestIndexes Best stops sequence index array
  * @param startpoints Starting points array
  * @param numStops Number of stops
- * @param points Array of all points
- * @param relations Relational matrix
- * @param costs Road cost matrix
- * @param numJunctions Dimension of relational matrix, the number of all points
+ * @param g Pointer to road graph
  * @param ppath Pointer to receiving path array
  * @param ppathLen Pointer to receiving path array length
  * @return true Success
@@ -156,10 +151,7 @@ bool pf_generateShortestPath(
 	const size_t * restrict bestIndexes,
 	const point_t * const * restrict startpoints,
 	size_t numStops,
-	const point_t * const * restrict points,
-	const uint8_t * restrict relations,
-	const float * restrict costs,
-	size_t numJunctions,
+	const roadGraph_t * restrict g,
 	const point_t *** restrict ppath,
 	size_t * restrict ppathLen
 );
@@ -0,0 +1,592 @@
+#include "roadGrid.h"
+#include "mathHelper.h"
+
+#include <stdlib.h>
+#include <math.h>
+
+/**
+ * @brief Calculates grid column index of x-coordinate, clamps to grid
+ *
+ * @param grid Pointer to roadGrid structure
+ * @param x x-coordinate
+ * @return size_t Column index
+ */
+static inline size_t s_roadGrid_col(const roadGrid_t * restrict grid, float x)
+{
+	const float fx = floorf((x - grid->minx) / grid->cellSize);
+	// Tingimus on kirjutatud nii, et ka NaN satuks esimesse veergu
+	if (!(fx > 0.0f))
+	{
+		return 0;
+	}
+	return (fx >= (float)grid->cols) ? (grid->cols - 1) : (size_t)fx;
+}
+/**
+ * @brief Calculates grid row index of y-coordinate, clamps to grid
+ *
+ * @param grid Pointer to roadGrid structure
+ * @param y y-coordinate
+ * @return size_t Row index
+ */
+static inline size_t s_roadGrid_row(const roadGrid_t * restrict grid, float y)
+{
+	const float fy = floorf((y - grid->miny) / grid->cellSize);
+	if (!(fy > 0.0f))
+	{
+		return 0;
+	}
+	return (fy >= (float)grid->rows) ? (grid->rows - 1) : (size_t)fy;
+}
+/**
+ * @brief Calculates squared distance between point and its intersection point on the road
+ *
+ * @param p Pointer to point structure
+ * @param road Pointer to road structure
+ * @return float Squared distance
+ */
+static inline float s_roadGrid_dist2(const point_t * restrict p, const line_t * restrict road)
+{
+	point_t tempPoint;
+	line_intersect(&tempPoint, p, road);
+
+	const float dx = tempPoint.x - p->x;
+	const float dy = tempPoint.y - p->y;
+	return (dx * dx) + (dy * dy);
+}
+/**
+ * @brief Makes sure that result arrays can hold at least minCap items
+ *
+ * @param grid Pointer to roadGrid structure
+ * @param minCap Minimum capacity
+ * @return true Success
+ * @return false Failure
+ */
+static inline bool s_roadGrid_reserveResult(roadGrid_t * restrict grid, size_t minCap)
+{
+	if (minCap <= grid->maxResult)
+	{
+		return true;
+	}
+
+	const size_t newcap = mh_zmax(minCap, (grid->maxResult + 1) * 2);
+	size_t * newres = realloc(grid->result, sizeof(size_t) * newcap);
+	if (newres == NULL)
+	{
+		return false;
+	}
+	grid->result = newres;
+
+	float * newdist = realloc(grid->resultDist2, sizeof(float) * newcap);
+	if (newdist == NULL)
+	{
+		return false;
+	}
+	grid->resultDist2 = newdist;
+	grid->maxResult   = newcap;
+
+	return true;
+}
+/**
+ * @brief Comparison function for qsort, sorts road indexes in ascending order
+ *
+ * @param a Pointer to first index
+ * @param b Pointer to second index
+ * @return int Comparison result
+ */
+static int s_roadGrid_cmpIdx(const void * a, const void * b)
+{
+	const size_t ia = *(const size_t *)a, ib = *(const size_t *)b;
+	return (ia > ib) - (ia < ib);
+}
+
+bool roadGrid_init(roadGrid_t * restrict grid, line_t * const * restrict roads, size_t numRoads)
+{
+	assert(grid != NULL);
+	assert((roads != NULL) || (numRoads == 0));
+
+	*grid = (roadGrid_t){
+		.cells       = NULL,
+		.marks       = NULL,
+		.numMarks    = 0,
+		.stamp       = 0,
+		.result      = NULL,
+		.resultDist2 = NULL,
+		.numResult   = 0,
+		.maxResult   = 0
+	};
+
+	// Leitakse kõiki teid ümbritsev ristkülik
+	float minx = INFINITY, miny = INFINITY, maxx = -INFINITY, maxy = -INFINITY;
+	for (size_t i = 0; i < numRoads; ++i)
+	{
+		const line_t * road = roads[i];
+		if (road != NULL)
+		{
+			minx = mh_fminf(minx, mh_fminf(road->src->x, road->dst->x));
+			miny = mh_fminf(miny, mh_fminf(road->src->y, road->dst->y));
+			maxx = mh_fmaxf(maxx, mh_fmaxf(road->src->x, road->dst->x));
+			maxy = mh_fmaxf(maxy, mh_fmaxf(road->src->y, road->dst->y));
+		}
+	}
+	if (minx > maxx)
+	{
+		minx = miny = maxx = maxy = 0.0f;
+	}
+
+	// Ruudustiku lahtri suurus valitakse nii, et keskmiselt oleks igas lahtris üks tee
+	const float w = maxx - minx, h = maxy - miny, n = (float)mh_zmax(numRoads, 1);
+	/*
+	 * Peaaegu ühel sirgel olevate teede korral oleks sqrt(w*h/n) kaduvväike ja
+	 * veerge/ridu tekiks astronoomiliselt palju, alampiir max(w,h)/n hoiab
+	 * nii veergude kui ridade arvu <= n + 1 ja lahtrite koguarvu O(n)
+	 */
+	float cellSize = mh_fmaxf(sqrtf((w * h) / n), mh_fmaxf(w, h) / n);
+	if (!(cellSize > 0.0f))
+	{
+		cellSize = 1.0f;
+	}
+
+	grid->minx     = minx;
+	grid->miny     = miny;
+	grid->cellSize = cellSize;
+	grid->cols     = (size_t)(w / cellSize) + 1;
+	grid->rows     = (size_t)(h / cellSize) + 1;
+
+	const size_t numCells = grid->cols * grid->rows;
+	grid->cells = malloc(sizeof(roadCell_t) * numCells);
+	if (grid->cells == NULL)
+	{
+		return false;
+	}
+	for (size_t i = 0; i < numCells; ++i)
+	{
+		grid->cells[i] = (roadCell_t){
+			.roads    = NULL,
+			.numRoads = 0,
+			.maxRoads = 0
+		};
+	}
+
+	for (size_t i = 0; i < numRoads; ++i)
+	{
+		if ((roads[i] != NULL) && !roadGrid_insert(grid, roads[i], i))
+		{
+			roadGrid_destroy(grid);
+			return false;
+		}
+	}
+
+	return true;
+}
+bool roadGrid_insert(roadGrid_t * restrict grid, const line_t * restrict road, size_t roadIdx)
+{
+	assert(grid        != NULL);
+	assert(grid->cells != NULL);
+	assert(road        != NULL);
+
+	// Märgendite massiiv peab hõlmama kõiki teede indekseid
+	if (roadIdx >= grid->numMarks)
+	{
+		const size_t newcap = mh_zmax(roadIdx + 1, grid->numMarks * 2);
+		size_t * newmem = realloc(grid->marks, sizeof(size_t) * newcap);
+		if (newmem == NULL)
+		{
+			return false;
+		}
+		for (size_t i = grid->numMarks; i < newcap; ++i)
+		{
+			newmem[i] = 0;
+		}
+		grid->marks    = newmem;
+		grid->numMarks = newcap;
+	}
+
+	// Tee lisatakse kõikidesse lahtritesse, mida tee ümbritsev ristkülik puudutab
+	const size_t c0 = s_roadGrid_col(grid, mh_fminf(road->src->x, road->dst->x));
+	const size_t c1 = s_roadGrid_col(grid, mh_fmaxf(road->src->x, road->dst->x));
+	const size_t r0 = s_roadGrid_row(grid, mh_fminf(road->src->y, road->dst->y));
+	const size_t r1 = s_roadGrid_row(grid, mh_fmaxf(road->src->y, road->dst->y));
+
+	for (size_t r = r0; r <= r1; ++r)
+	{
+		for (size_t c = c0; c <= c1; ++c)
+		{
+			roadCell_t * cell = &grid->cells[r * grid->cols + c];
+			if (cell->numRoads >= cell->maxRoads)
+			{
+				const size_t newcap = (cell->numRoads + 1) * 2;
+				size_t * newmem = realloc(cell->roads, sizeof(size_t) * newcap);
+				if (newmem == NULL)
+				{
+					return false;
+				}
+				cell->roads    = newmem;
+				cell->maxRoads = newcap;
+			}
+			cell->roads[cell->numRoads] = roadIdx;
+			++cell->numRoads;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief Visits all cells of a square ring around the starting cell, calls
+ * the visitor for each road not seen during this query yet
+ *
+ * @param grid Pointer to roadGrid structure
+ * @param roads Roads array
+ * @param p Pointer to query point
+ * @param cx Column of the starting cell
+ * @param cy Row of the starting cell
+ * @param ring Ring "radius" in cells
+ * @param visit Visitor function, receives road index and its squared distance
+ * @param arg Visitor argument
+ * @return true Success
+ * @return false Failure from visitor
+ */
+static inline bool s_roadGrid_visitRing(
+	roadGrid_t * restrict grid,
+	line_t * const * restrict roads,
+	const point_t * restrict p,
+	size_t cx, size_t cy, size_t ring,
+	bool (*visit)(roadGrid_t * restrict grid, size_t roadIdx, float dist2, void * arg),
+	void * arg
+)
+{
+	const size_t x0 = (cx >= ring) ? (cx - ring) : 0;
+	const size_t y0 = (cy >= ring) ? (cy - ring) : 0;
+	const size_t x1 = mh_zmin(cx + ring, grid->cols - 1);
+	const size_t y1 = mh_zmin(cy + ring, grid->rows - 1);
+
+	for (size_t y = y0; y <= y1; ++y)
+	{
+		// Rõnga äärmistes ridades käiakse läbi kõik lahtrid, vahepealsetes ainult servad
+		const bool edgeRow = ((y + ring) == cy) || (y == (cy + ring));
+		for (size_t x = x0; x <= x1; ++x)
+		{
+			if (!edgeRow && ((x + ring) != cx) && (x != (cx + ring)))
+			{
+				// Hüpatakse otse parempoolsesse serva
+				if ((cx + ring) > x1)
+				{
+					break;
+				}
+				x = cx + ring;
+			}
+
+			const roadCell_t * cell = &grid->cells[y * grid->cols + x];
+			for (size_t i = 0; i < cell->numRoads; ++i)
+			{
+				const size_t idx = cell->roads[i];
+				if (grid->marks[idx] == grid->stamp)
+				{
+					continue;
+				}
+				grid->marks[idx] = grid->stamp;
+
+				if (!visit(grid, idx, s_roadGrid_dist2(p, roads[idx]), arg))
+				{
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+/**
+ * @brief Calculates lower bound of distance from the query point to any road not yet
+ * visited after visiting all rings up to given ring
+ *
+ * @param grid Pointer to roadGrid structure
+ * @param p Pointer to query point
+ * @param cx Column of the starting cell
+ * @param cy Row of the starting cell
+ * @param ring Last visited ring
+ * @return float Distance lower bound, INFINITY if the whole grid has been visited
+ */
+static inline float s_roadGrid_bound(
+	const roadGrid_t * restrict grid,
+	const point_t * restrict p,
+	size_t cx, size_t cy, size_t ring
+)
+{
+	const float cs = grid->cellSize;
+	float bound = INFINITY;
+
+	// Külastamata lahtrid võivad olla ainult läbitud ruudust väljaspool
+	if (cx > ring)
+	{
+		bound = mh_fminf(bound, p->x - (grid->minx + (float)(cx - ring) * cs));
+	}
+	if ((cx + ring + 1) < grid->cols)
+	{
+		bound = mh_fminf(bound, (grid->minx + (float)(cx + ring + 1) * cs) - p->x);
+	}
+	if (cy > ring)
+	{
+		bound = mh_fminf(bound, p->y - (grid->miny + (float)(cy - ring) * cs));
+	}
+	if ((cy + ring + 1) < grid->rows)
+	{
+		bound = mh_fminf(bound, (grid->miny + (float)(cy + ring + 1) * cs) - p->y);
+	}
+
+	// Väike varu ujukoma ümardusvigade jaoks
+	return mh_fmaxf(bound - cs * 1e-3f, 0.0f);
+}
+
+/**
+ * @brief Data structure for k-nearest search visitor
+ *
+ */
+typedef struct
+{
+	size_t k;
+
+} roadGrid_knn_implS;
+
+/**
+ * @brief Visitor for k-nearest search, keeps result array sorted by distance & index
+ *
+ * @param grid Pointer to roadGrid structure
+ * @param roadIdx Road index
+ * @param dist2 Squared distance to road
+ * @param arg Pointer to roadGrid_knn_implS structure
+ * @return true Always succeeds
+ */
+static bool s_roadGrid_visitKnn(roadGrid_t * restrict grid, size_t roadIdx, float dist2, void * arg)
+{
+	const size_t k = ((const roadGrid_knn_implS *)arg)->k;
+
+	// Otsitakse koht, kuhu uus tee sorteeritud massiivis käiks
+	size_t pos = grid->numResult;
+	while ((pos > 0) &&
+		((dist2 < grid->resultDist2[pos - 1]) ||
+		((dist2 == grid->resultDist2[pos - 1]) && (roadIdx < grid->result[pos - 1]))))
+	{
+		--pos;
+	}
+	if (pos >= k)
+	{
+		return true;
+	}
+
+	// Viimane element kukub vajadusel massiivist välja
+	size_t last = (grid->numResult < k) ? grid->numResult : (k - 1);
+	for (size_t i = last; i > pos; --i)
+	{
+		grid->result[i]      = grid->result[i - 1];
+		grid->resultDist2[i] = grid->resultDist2[i - 1];
+	}
+	grid->result[pos]      = roadIdx;
+	grid->resultDist2[pos] = dist2;
+	grid->numResult        = mh_zmin(grid->numResult + 1, k);
+
+	return true;
+}
+/**
+ * @brief Visitor for radius search, appends all roads within radius to the result array
+ *
+ * @param grid Pointer to roadGrid structure
+ * @param roadIdx Road index
+ * @param dist2 Squared distance to road
+ * @param arg Pointer to squared radius
+ * @return true Success
+ * @return false Failure allocating memory
+ */
+static bool s_roadGrid_visitRadius(roadGrid_t * restrict grid, size_t roadIdx, float dist2, void * arg)
+{
+	if (!(dist2 <= *(const float *)arg))
+	{
+		return true;
+	}
+	if (!s_roadGrid_reserveResult(grid, grid->numResult + 1))
+	{
+		return false;
+	}
+
+	grid->result[grid->numResult]      = roadIdx;
+	grid->resultDist2[grid->numResult] = dist2;
+	++grid->numResult;
+
+	return true;
+}
+
+bool roadGrid_kNearest(
+	roadGrid_t * restrict grid,
+	line_t * const * restrict roads,
+	const point_t * restrict p,
+	size_t k,
+	const size_t ** restrict presult,
+	size_t * restrict pnumResult
+)
+{
+	assert(grid       != NULL);
+	assert(roads      != NULL);
+	assert(p          != NULL);
+	assert(presult    != NULL);
+	assert(pnumResult != NULL);
+
+	grid->numResult = 0;
+	if ((k > 0) && !s_roadGrid_reserveResult(grid, k))
+	{
+		return false;
+	}
+	++grid->stamp;
+
+	roadGrid_knn_implS arg = { .k = k };
+	const size_t cx = s_roadGrid_col(grid, p->x), cy = s_roadGrid_row(grid, p->y);
+
+	// Rõngaid laiendatakse seni, kuni k-s leitud tee on lähemal kui ükskõik milline külastamata tee
+	for (size_t ring = 0; k > 0; ++ring)
+	{
+		s_roadGrid_visitRing(grid, roads, p, cx, cy, ring, &s_roadGrid_visitKnn, &arg);
+
+		const float bound = s_roadGrid_bound(grid, p, cx, cy, ring);
+		if ((bound == INFINITY) ||
+			((grid->numResult == k) && (grid->resultDist2[k - 1] < (bound * bound))))
+		{
+			break;
+		}
+	}
+
+	*presult    = grid->result;
+	*pnumResult = grid->numResult;
+	return true;
+}
+bool roadGrid_radius(
+	roadGrid_t * restrict grid,
+	line_t * const * restrict roads,
+	const point_t * restrict p,
+	float radius,
+	const size_t ** restrict presult,
+	size_t * restrict pnumResult
+)
+{
+	assert(grid       != NULL);
+	assert(roads      != NULL);
+	assert(p          != NULL);
+	assert(presult    != NULL);
+	assert(pnumResult != NULL);
+
+	grid->numResult = 0;
+	++grid->stamp;
+
+	float radius2 = radius * radius;
+	const size_t cx = s_roadGrid_col(grid, p->x), cy = s_roadGrid_row(grid, p->y);
+
+	for (size_t ring = 0; ; ++ring)
+	{
+		if (!s_roadGrid_visitRing(grid, roads, p, cx, cy, ring, &s_roadGrid_visitRadius, &radius2))
+		{
+			return false;
+		}
+
+		const float bound = s_roadGrid_bound(grid, p, cx, cy, ring);
+		if ((bound == INFINITY) || (radius < bound))
+		{
+			break;
+		}
+	}
+
+	// Tulemused sorteeritakse indeksite järgi, et järjekord oleks sama nagu kõikide teede läbikäimisel
+	qsort(grid->result, grid->numResult, sizeof(size_t), &s_roadGrid_cmpIdx);
+
+	*presult    = grid->result;
+	*pnumResult = grid->numResult;
+	return true;
+}
+bool roadGrid_snap(
+	roadGrid_t * restrict grid,
+	line_t * const * restrict roads,
+	const point_t * restrict p,
+	float minCost,
+	size_t * restrict proadIdx,
+	point_t * restrict pbest
+)
+{
+	assert(grid     != NULL);
+	assert(roads    != NULL);
+	assert(p        != NULL);
+	assert(proadIdx != NULL);
+	assert(pbest    != NULL);
+
+	const size_t * res;
+	size_t numRes;
+	if (!roadGrid_kNearest(grid, roads, p, 1, &res, &numRes) || (numRes == 0))
+	{
+		return false;
+	}
+
+	// Lähima tee kaalutud kaugus on parima tee kaalutud kauguse ülempiir, seega saab parim
+	// tee olla ainult raadiuses, mis on leitud väikseima võimaliku "hinna" järgi
+	const float upper2 = grid->resultDist2[0] * roads[res[0]]->cost;
+	const float radius = (minCost > 0.0f) ? sqrtf((upper2 / minCost) * (1.0f + 1e-4f)) : INFINITY;
+	if (!roadGrid_radius(grid, roads, p, radius, &res, &numRes))
+	{
+		return false;
+	}
+
+	float shortestLen2 = 0.0f;
+	bool pointSet = false;
+	for (size_t i = 0; i < numRes; ++i)
+	{
+		const line_t * road = roads[res[i]];
+
+		point_t tempPoint;
+		line_intersect(&tempPoint, p, road);
+
+		const float dx = tempPoint.x - p->x;
+		const float dy = tempPoint.y - p->y;
+		float len2 = (dx * dx) + (dy * dy);
+		// Tee "hinda" võetakse ka arvesse, eelistatakse "kiiremaid" teid
+		len2 *= road->cost;
+
+		if (!pointSet || (len2 < shortestLen2))
+		{
+			pointSet = true;
+
+			shortestLen2 = len2;
+			*pbest       = tempPoint;
+			*proadIdx    = res[i];
+		}
+	}
+
+	return pointSet;
+}
+
+void roadGrid_destroy(roadGrid_t * restrict grid)
+{
+	assert(grid != NULL);
+
+	if (grid->cells != NULL)
+	{
+		for (size_t i = 0, n = grid->cols * grid->rows; i < n; ++i)
+		{
+			if (grid->cells[i].roads != NULL)
+			{
+				free(grid->cells[i].roads);
+			}
+		}
+		free(grid->cells);
+		grid->cells = NULL;
+	}
+	if (grid->marks != NULL)
+	{
+		free(grid->marks);
+		grid->marks = NULL;
+	}
+	if (grid->result != NULL)
+	{
+		free(grid->result);
+		grid->result = NULL;
+	}
+	if (grid->resultDist2 != NULL)
+	{
+		free(grid->resultDist2);
+		grid->resultDist2 = NULL;
+	}
+}
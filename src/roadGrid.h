@@ -0,0 +1,140 @@
+#ifndef ROAD_GRID_H
+#define ROAD_GRID_H
+
+#include "dataModel.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Data structure for a single grid cell, holds indexes of all roads whose
+ * bounding box overlaps the cell
+ *
+ */
+typedef struct roadCell
+{
+	size_t * roads;
+	size_t numRoads, maxRoads;
+
+} roadCell_t;
+
+/**
+ * @brief Uniform spatial grid over roads/lines, used to find nearest roads without
+ * scanning every single road. Road indexes correspond to the roads array given to queries.
+ *
+ */
+typedef struct roadGrid
+{
+	float minx, miny, cellSize;
+	size_t cols, rows;
+	roadCell_t * cells;
+
+	size_t * marks;
+	size_t numMarks, stamp;
+
+	size_t * result;
+	float * resultDist2;
+	size_t numResult, maxResult;
+
+} roadGrid_t;
+
+
+/**
+ * @brief Initialises road grid structure, inserts all given roads to the grid.
+ * Grid dimensions are chosen so that there is roughly one cell per road.
+ * Complexity: O(n).
+ *
+ * @param grid Pointer to roadGrid structure
+ * @param roads Roads array
+ * @param numRoads Number of roads
+ * @return true Success
+ * @return false Failure
+ */
+bool roadGrid_init(roadGrid_t * restrict grid, line_t * const * restrict roads, size_t numRoads);
+/**
+ * @brief Inserts a road to the grid. Road has to be within the original
+ * grid bounds, roads outside are clamped to the border cells.
+ *
+ * @param grid Pointer to roadGrid structure
+ * @param road Pointer to road to insert
+ * @param roadIdx Index of the road in roads array
+ * @return true Success
+ * @return false Failure
+ */
+bool roadGrid_insert(roadGrid_t * restrict grid, const line_t * restrict road, size_t roadIdx);
+
+/**
+ * @brief Finds k geometrically nearest roads to a point. Distance to a road is measured
+ * to the intersection point given by line_intersect.
+ *
+ * @param grid Pointer to roadGrid structure
+ * @param roads Roads array, indexes correspond to the ones inserted to the grid
+ * @param p Pointer to point structure
+ * @param k Maximum number of roads to find
+ * @param presult Pointer to receiving array of road indexes sorted by distance (ties
+ * by index), array is owned by the grid and valid until next query
+ * @param pnumResult Pointer to receiving number of found roads, at most k
+ * @return true Success
+ * @return false Failure
+ */
+bool roadGrid_kNearest(
+	roadGrid_t * restrict grid,
+	line_t * const * restrict roads,
+	const point_t * restrict p,
+	size_t k,
+	const size_t ** restrict presult,
+	size_t * restrict pnumResult
+);
+/**
+ * @brief Finds all roads within given radius of a point.
+ *
+ * @param grid Pointer to roadGrid structure
+ * @param roads Roads array, indexes correspond to the ones inserted to the grid
+ * @param p Pointer to point structure
+ * @param radius Search radius, inclusive
+ * @param presult Pointer to receiving array of road indexes in ascending order,
+ * array is owned by the grid and valid until next query
+ * @param pnumResult Pointer to receiving number of found roads
+ * @return true Success
+ * @return false Failure
+ */
+bool roadGrid_radius(
+	roadGrid_t * restrict grid,
+	line_t * const * restrict roads,
+	const point_t * restrict p,
+	float radius,
+	const size_t ** restrict presult,
+	size_t * restrict pnumResult
+);
+/**
+ * @brief Finds the road with the smallest squared distance multiplied by the
+ * road's cost, same as scanning all roads. Nearest road gives the upper bound for
+ * the weighted distance, which in turn with the smallest road cost gives the search radius.
+ *
+ * @param grid Pointer to roadGrid structure
+ * @param roads Roads array, indexes correspond to the ones inserted to the grid
+ * @param p Pointer to point structure
+ * @param minCost The smallest cost of all roads, has to be positive
+ * @param proadIdx Pointer to receiving index of the best road
+ * @param pbest Pointer to receiving intersection point on the best road
+ * @return true Success
+ * @return false Failure, also if grid is empty
+ */
+bool roadGrid_snap(
+	roadGrid_t * restrict grid,
+	line_t * const * restrict roads,
+	const point_t * restrict p,
+	float minCost,
+	size_t * restrict proadIdx,
+	point_t * restrict pbest
+);
+
+/**
+ * @brief Destroys road grid structure, frees all memory
+ *
+ * @param grid Pointer to roadGrid structure
+ */
+void roadGrid_destroy(roadGrid_t * restrict grid);
+
+
+#endif
@@ -0,0 +1,180 @@
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+	// sysconf(_SC_NPROCESSORS_ONLN) POSIX-süsteemides
+	#define _DEFAULT_SOURCE
+#endif
+
+#include "threadHelper.h"
+
+#include <stdlib.h>
+#include <assert.h>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <pthread.h>
+	#include <sched.h>
+	#include <unistd.h>
+#endif
+
+/**
+ * @brief Start parameters and handle of a single worker thread
+ * 
+ */
+typedef struct thelperThread
+{
+	thelperFunc_t func;
+	void * task;
+	bool started;
+#ifdef _WIN32
+	HANDLE handle;
+#else
+	pthread_t handle;
+#endif
+
+} thelperThread_t;
+
+#ifdef _WIN32
+static DWORD WINAPI s_thelper_start(LPVOID arg)
+{
+	thelperThread_t * th = arg;
+	th->func(th->task);
+	return 0;
+}
+#else
+static void * s_thelper_start(void * arg)
+{
+	thelperThread_t * th = arg;
+	th->func(th->task);
+	return NULL;
+}
+#endif
+
+size_t thelper_numCores(void)
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (info.dwNumberOfProcessors > 0) ? (size_t)info.dwNumberOfProcessors : 1;
+#else
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	return (cores > 0) ? (size_t)cores : 1;
+#endif
+}
+void thelper_run(thelperFunc_t func, void * tasks, size_t numTasks, size_t taskSize)
+{
+	assert(func != NULL);
+	assert((tasks != NULL) || (numTasks == 0));
+
+	if (numTasks == 0)
+	{
+		return;
+	}
+
+	// Lõimede andmed peavad püsima kuni lõimede lõpuni, mälu puudumisel tehakse kõik
+	// ülesanded järjest
+	thelperThread_t * threads = (numTasks > 1) ? malloc(sizeof(thelperThread_t) * (numTasks - 1)) : NULL;
+	for (size_t i = 1; (threads != NULL) && (i < numTasks); ++i)
+	{
+		thelperThread_t * th = &threads[i - 1];
+		th->func = func;
+		th->task = (char *)tasks + i * taskSize;
+#ifdef _WIN32
+		th->handle  = CreateThread(NULL, 0, &s_thelper_start, th, 0, NULL);
+		th->started = (th->handle != NULL);
+#else
+		th->started = (pthread_create(&th->handle, NULL, &s_thelper_start, th) == 0);
+#endif
+	}
+
+	func(tasks);
+
+	for (size_t i = 1; i < numTasks; ++i)
+	{
+		if ((threads != NULL) && threads[i - 1].started)
+		{
+#ifdef _WIN32
+			WaitForSingleObject(threads[i - 1].handle, INFINITE);
+			CloseHandle(threads[i - 1].handle);
+#else
+			pthread_join(threads[i - 1].handle, NULL);
+#endif
+		}
+		else
+		{
+			// Lõime loomine ebaõnnestus, ülesanne tehakse kutsuvas lõimes
+			func((char *)tasks + i * taskSize);
+		}
+	}
+	free(threads);
+}
+void thelper_yield(void)
+{
+#ifdef _WIN32
+	SwitchToThread();
+#else
+	sched_yield();
+#endif
+}
+
+bool thelper_mutexInit(thelperMutex_t * restrict mutex)
+{
+	assert(mutex != NULL);
+
+#ifdef _WIN32
+	CRITICAL_SECTION * cs = malloc(sizeof(CRITICAL_SECTION));
+	if (cs == NULL)
+	{
+		mutex->handle = NULL;
+		return false;
+	}
+	InitializeCriticalSection(cs);
+	mutex->handle = cs;
+#else
+	pthread_mutex_t * m = malloc(sizeof(pthread_mutex_t));
+	if ((m != NULL) && (pthread_mutex_init(m, NULL) != 0))
+	{
+		free(m);
+		m = NULL;
+	}
+	mutex->handle = m;
+#endif
+	return mutex->handle != NULL;
+}
+void thelper_mutexLock(thelperMutex_t * restrict mutex)
+{
+	assert(mutex != NULL);
+	assert(mutex->handle != NULL);
+
+#ifdef _WIN32
+	EnterCriticalSection(mutex->handle);
+#else
+	pthread_mutex_lock(mutex->handle);
+#endif
+}
+void thelper_mutexUnlock(thelperMutex_t * restrict mutex)
+{
+	assert(mutex != NULL);
+	assert(mutex->handle != NULL);
+
+#ifdef _WIN32
+	LeaveCriticalSection(mutex->handle);
+#else
+	pthread_mutex_unlock(mutex->handle);
+#endif
+}
+void thelper_mutexDestroy(thelperMutex_t * restrict mutex)
+{
+	assert(mutex != NULL);
+
+	if (mutex->handle == NULL)
+	{
+		return;
+	}
+#ifdef _WIN32
+	DeleteCriticalSection(mutex->handle);
+#else
+	pthread_mutex_destroy(mutex->handle);
+#endif
+	free(mutex->handle);
+	mutex->handle = NULL;
+}
@@ -0,0 +1,78 @@
+#ifndef THREAD_HELPER_H
+#define THREAD_HELPER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Function run by a worker thread
+ * 
+ * @param task Pointer to the task structure of that thread
+ */
+typedef void (*thelperFunc_t)(void * task);
+
+/**
+ * @brief Queries the number of logical processors available to the process
+ * 
+ * @return size_t Number of processors, at least 1
+ */
+size_t thelper_numCores(void);
+/**
+ * @brief Runs function on every task of an array concurrently and waits until all of
+ * them have finished. The first task is run on the calling thread, every other task
+ * on a thread of its own. Tasks, whose threads can't be created, are run afterwards
+ * on the calling thread, so every task is always run exactly once.
+ * 
+ * @param func Function to run
+ * @param tasks Pointer to the first task structure
+ * @param numTasks Number of task structures
+ * @param taskSize Size of a single task structure in bytes
+ */
+void thelper_run(thelperFunc_t func, void * tasks, size_t numTasks, size_t taskSize);
+/**
+ * @brief Gives the rest of the calling thread's time slice to other threads, used
+ * while waiting for other threads without a lock
+ * 
+ */
+void thelper_yield(void);
+
+/**
+ * @brief Mutual exclusion lock, platform's lock object is allocated separately, so
+ * that the header doesn't depend on platform headers
+ * 
+ */
+typedef struct thelperMutex
+{
+	void * handle;
+
+} thelperMutex_t;
+
+/**
+ * @brief Initialises mutex in unlocked state
+ * 
+ * @param mutex Pointer to the mutex structure
+ * @return true Success
+ * @return false Failure, out of memory
+ */
+bool thelper_mutexInit(thelperMutex_t * restrict mutex);
+/**
+ * @brief Locks the mutex, blocks until the mutex is available. Mutex isn't recursive.
+ * 
+ * @param mutex Pointer to initialised mutex structure
+ */
+void thelper_mutexLock(thelperMutex_t * restrict mutex);
+/**
+ * @brief Unlocks mutex locked by the calling thread
+ * 
+ * @param mutex Pointer to locked mutex structure
+ */
+void thelper_mutexUnlock(thelperMutex_t * restrict mutex);
+/**
+ * @brief Destroys unlocked mutex, destroying a zeroed or destroyed mutex does nothing
+ * 
+ * @param mutex Pointer to the mutex structure
+ */
+void thelper_mutexDestroy(thelperMutex_t * restrict mutex);
+
+
+#endif
@@ -0,0 +1,77 @@
+#include "unionFind.h"
+
+#include <stdlib.h>
+#include <assert.h>
+
+bool uf_init(unionFind_t * restrict uf, size_t n)
+{
+	assert(uf != NULL);
+
+	uf->n      = n;
+	uf->parent = malloc(sizeof(size_t) * ((n > 0) ? n : 1));
+	uf->size   = malloc(sizeof(size_t) * ((n > 0) ? n : 1));
+	if ((uf->parent == NULL) || (uf->size == NULL))
+	{
+		uf_destroy(uf);
+		return false;
+	}
+
+	// Iga element on alguses omaette hulk
+	for (size_t i = 0; i < n; ++i)
+	{
+		uf->parent[i] = i;
+		uf->size[i]   = 1;
+	}
+
+	return true;
+}
+size_t uf_find(unionFind_t * restrict uf, size_t x)
+{
+	assert(uf != NULL);
+	assert(x < uf->n);
+
+	// Tee poolitamine, iga läbitud element viidatakse oma vanavanemale
+	while (uf->parent[x] != x)
+	{
+		uf->parent[x] = uf->parent[uf->parent[x]];
+		x = uf->parent[x];
+	}
+	return x;
+}
+bool uf_union(unionFind_t * restrict uf, size_t a, size_t b)
+{
+	assert(uf != NULL);
+
+	a = uf_find(uf, a);
+	b = uf_find(uf, b);
+	if (a == b)
+	{
+		return false;
+	}
+
+	// Väiksem hulk liidetakse suuremale, et puud jääksid madalaks
+	if (uf->size[a] < uf->size[b])
+	{
+		const size_t temp = a;
+		a = b;
+		b = temp;
+	}
+	uf->parent[b] = a;
+	uf->size[a]  += uf->size[b];
+
+	return true;
+}
+bool uf_connected(unionFind_t * restrict uf, size_t a, size_t b)
+{
+	return uf_find(uf, a) == uf_find(uf, b);
+}
+void uf_destroy(unionFind_t * restrict uf)
+{
+	assert(uf != NULL);
+
+	free(uf->parent);
+	free(uf->size);
+	uf->parent = NULL;
+	uf->size   = NULL;
+	uf->n      = 0;
+}
@@ -0,0 +1,68 @@
+#ifndef UNION_FIND_H
+#define UNION_FIND_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Disjoint-set forest data structure, used to find connected components
+ * of the road graph
+ * 
+ */
+typedef struct unionFind
+{
+	size_t * parent;
+	size_t * size;
+	size_t n;
+
+} unionFind_t;
+
+
+/**
+ * @brief Initialises union-find structure, every element is a separate set
+ * 
+ * @param uf Pointer to unionFind structure
+ * @param n Number of elements
+ * @return true Success
+ * @return false Failure
+ */
+bool uf_init(unionFind_t * restrict uf, size_t n);
+/**
+ * @brief Finds the representative element of the set containing given element,
+ * halves the path on the way. Complexity: amortised O(α(n)).
+ * 
+ * @param uf Pointer to unionFind structure
+ * @param x Element index
+ * @return size_t Index of the representative element
+ */
+size_t uf_find(unionFind_t * restrict uf, size_t x);
+/**
+ * @brief Merges the sets containing given elements, smaller set is attached to
+ * the larger one
+ * 
+ * @param uf Pointer to unionFind structure
+ * @param a First element index
+ * @param b Second element index
+ * @return true Sets were merged
+ * @return false Elements were already in the same set
+ */
+bool uf_union(unionFind_t * restrict uf, size_t a, size_t b);
+/**
+ * @brief Checks whether two elements belong to the same set
+ * 
+ * @param uf Pointer to unionFind structure
+ * @param a First element index
+ * @param b Second element index
+ * @return true Elements are in the same set
+ * @return false Elements are in different sets
+ */
+bool uf_connected(unionFind_t * restrict uf, size_t a, size_t b);
+/**
+ * @brief Destroys union-find structure, frees all memory
+ * 
+ * @param uf Pointer to unionFind structure
+ */
+void uf_destroy(unionFind_t * restrict uf);
+
+
+#endif
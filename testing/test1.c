@@ -22,5 +22,17 @@ int main(void)
 	test(txtBin != NULL && strncmp(TEST_STRING, txtBin, txtBinSuurus) == 0, "Binaarse faili kirjutamise viga!");
 	free(txtBin);
 
+	fhelperMap_t map;
+	test(fhelper_map(&map, "test.bin.txt"), "Faili kuvandamise viga!");
+	test(map.length == strlen(TEST_STRING) && strncmp(TEST_STRING, map.data, map.length) == 0, "Kuvandi sisu ei klapi!");
+	fhelper_unmap(&map);
+
+	fhelper_write("test.empty.txt", "", 0);
+	test(fhelper_map(&map, "test.empty.txt") && map.length == 0, "Tühja faili kuvandamise viga!");
+	fhelper_unmap(&map);
+	remove("test.empty.txt");
+
+	test(!fhelper_map(&map, "olematu fail.txt"), "Olematu faili kuvandamine õnnestus!");
+
 	return 0;
 }
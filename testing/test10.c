@@ -0,0 +1,95 @@
+#include "test.h"
+#include "../src/mathHelper.h"
+
+#include <stdint.h>
+#include <locale.h>
+
+#define NUM_RANDOM 200000
+
+static bool sameAsStrtof(const char * str)
+{
+	const char * end1 = NULL;
+	char * end2 = NULL;
+	const float a = mh_strtof(str, &end1), b = strtof(str, &end2);
+	return (memcmp(&a, &b, sizeof(float)) == 0) && (end1 == end2);
+}
+
+int main(void)
+{
+	setlib("mathHelper");
+	srand(1234);
+
+	// Tavalised koordinaadid ja hinnad
+	const char * end = NULL;
+	test(mh_strtof("123.5", &end) == 123.5f && *end == '\0', "Simple number parsed wrong!");
+	test(mh_strtof("-0.25,17", &end) == -0.25f && *end == ',', "Number before comma parsed wrong!");
+	test(mh_strtof("  1e3", NULL) == 1000.0f, "Exponent parsed wrong!");
+	test(mh_strtof("abc", &end) == 0.0f && strcmp(end, "abc") == 0, "Non-number wasn't rejected!");
+
+	// Piirjuhud: ümardamine, subnormaalsed, ületäitumine, pikad sisendid, erikujud
+	const char * cases[] = {
+		"0", "-0", "3.4028235e38", "3.4028236e38", "1e39", "1.17549435e-38", "1.4e-45", "7e-46", "1e-50",
+		"16777217", "16777219", "0.1", "2.7182818284590452353602874713527", "1.00000005960464477539062500001",
+		"1.000000059604644775390625", "0.00000000000000000000000000000000000001", "1e", "1e+", ".5", "5.",
+		"inf", "-nan", "0x1p-3", "1,5",
+		"1.2345678901234567890123", "340282356779733661637539395458142568447.99999999999999999999999999",
+		"7.006492321624085354618647916449580656401309709382578858785341419448955413429303e-46",
+		"7.006492321624085354618647916449580656401309709382578858785341419448955413429304e-46",
+		"0x1.fffffep127", "0x1.ffffffp127", "0x1.000001p0", "0x1.000003p0", "0X.8P+2", "0x", "0x.g",
+		"-Infinity", "infinit", "nan(abc_1)", "nan(", "NAN"
+	};
+	bool same = true;
+	for (size_t i = 0; i < (sizeof(cases) / sizeof(cases[0])); ++i)
+	{
+		same = sameAsStrtof(cases[i]);
+		test(same, "Result differs from strtof for \"%s\"!", cases[i]);
+	}
+
+	// Juhuslike float väärtuste tekstikujud annavad strtof-iga sama tulemuse
+	for (size_t i = 0; (i < NUM_RANDOM) && same; ++i)
+	{
+		const uint32_t bits = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+		float f;
+		memcpy(&f, &bits, sizeof(float));
+		if (f != f)
+		{
+			continue;
+		}
+		char str[64];
+		snprintf(str, sizeof(str), "%.9g", (double)f);
+		same = sameAsStrtof(str);
+		snprintf(str, sizeof(str), "%.20e", (double)f);
+		same &= sameAsStrtof(str);
+	}
+	test(same, "Random values differ from strtof!");
+
+	// Koma-kümnenderaldajaga lokaadis on tulemused samad, kui mõni selline lokaat on olemas
+	const char * commaLocales[] = { "et_EE.UTF-8", "de_DE.UTF-8", "fr_FR.UTF-8", "et_EE", "de_DE" };
+	const char * localeCases[] = {
+		"123.5", "1.2345678901234567890123", "2.7182818284590452353602874713527", "0x1.8p1", "-inf"
+	};
+	float expected[sizeof(localeCases) / sizeof(localeCases[0])];
+	for (size_t i = 0; i < (sizeof(localeCases) / sizeof(localeCases[0])); ++i)
+	{
+		expected[i] = mh_strtof(localeCases[i], NULL);
+	}
+	for (size_t i = 0; i < (sizeof(commaLocales) / sizeof(commaLocales[0])); ++i)
+	{
+		if (setlocale(LC_NUMERIC, commaLocales[i]) == NULL)
+		{
+			continue;
+		}
+		for (size_t j = 0; j < (sizeof(localeCases) / sizeof(localeCases[0])); ++j)
+		{
+			const float value = mh_strtof(localeCases[j], &end);
+			test(
+				(memcmp(&value, &expected[j], sizeof(float)) == 0) && (*end == '\0'),
+				"\"%s\" parsed differently in locale %s!", localeCases[j], commaLocales[i]
+			);
+		}
+		setlocale(LC_NUMERIC, "C");
+		break;
+	}
+
+	return 0;
+}
@@ -0,0 +1,307 @@
+#include "test.h"
+#include "../src/hashmap.h"
+#include "../src/threadHelper.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define NUM_KEYS 20000
+#define NUM_STABLE_KEYS 5000
+#define NUM_WRITERS 2
+#define NUM_READERS 3
+#define NUM_ROUNDS 4
+
+typedef struct concurrentTask
+{
+	hashMapCK_t * map;
+	char (*keys)[16];
+	size_t first, last;
+	bool writer;
+	bool ok;
+} concurrentTask_t;
+
+static void concurrentWork(void * arg)
+{
+	concurrentTask_t * task = arg;
+	task->ok = true;
+	for (size_t round = 0; round < NUM_ROUNDS; ++round)
+	{
+		if (task->writer)
+		{
+			// Kirjutaja lisab ja eemaldab oma võtmed, see suurendab tabelit ja vabastab sõlmi
+			for (size_t i = task->first; i < task->last; ++i)
+			{
+				task->ok &= hashMapCK_insert(task->map, task->keys[i], task->keys[i]);
+			}
+			for (size_t i = task->first; i < task->last; ++i)
+			{
+				const hashNodeCK_t * node = hashMapCK_get(task->map, task->keys[i]);
+				task->ok &= (node != NULL) && (node->value == task->keys[i]);
+			}
+			for (size_t i = task->first; i < task->last; ++i)
+			{
+				task->ok &= hashMapCK_remove(task->map, task->keys[i]) == task->keys[i];
+			}
+		}
+		else
+		{
+			// Püsivad võtmed peavad lugejale alati leitavad olema
+			for (size_t i = task->first; i < task->last; ++i)
+			{
+				const hashNodeCK_t * node = hashMapCK_getLen(task->map, task->keys[i], strlen(task->keys[i]));
+				task->ok &= (node != NULL) && (node->value == task->keys[i]);
+			}
+		}
+	}
+}
+
+int main(void)
+{
+	setlib("hashmap");
+
+	static char keys[NUM_KEYS][16];
+	for (size_t i = 0; i < NUM_KEYS; ++i)
+	{
+		snprintf(keys[i], sizeof(keys[i]), "J%06zu", i);
+	}
+
+	hashMapOA_t map;
+	test(hashMapOA_init(&map, 1), "Map init failed!");
+	test((map.numSlots & (map.numSlots - 1)) == 0, "Slot count %zu is not a power of two!", map.numSlots);
+
+	// Tabel kasvab lisamise käigus, duplikaate ei lisata
+	bool inserted = true;
+	for (size_t i = 0; i < NUM_KEYS; ++i)
+	{
+		inserted &= hashMapOA_insert(&map, keys[i], keys[i]);
+	}
+	test(inserted, "Inserting failed!");
+	test(map.numItems == NUM_KEYS, "%zu items instead of %d!", map.numItems, NUM_KEYS);
+	test(!hashMapOA_insert(&map, "J000042", NULL), "Duplicate key was inserted!");
+	test((map.numSlots & (map.numSlots - 1)) == 0, "Slot count %zu is not a power of two!", map.numSlots);
+
+	bool found = true;
+	for (size_t i = 0; i < NUM_KEYS; ++i)
+	{
+		const hashEntryOA_t * entry = hashMapOA_get(&map, keys[i]);
+		found &= (entry != NULL) && (entry->value == keys[i]);
+	}
+	test(found, "Inserted keys weren't found!");
+	test(hashMapOA_get(&map, "J") == NULL, "Nonexistent key was found!");
+	test(hashMapOA_getLen(&map, "J000007xyz", 7) == hashMapOA_get(&map, "J000007"), "Length-delimited lookup failed!");
+	test(hashMapOA_getLen(&map, "J00000", 6) == NULL, "Prefix of a key was found!");
+
+	// Eemaldamine nihutab järgnevaid kirjeid tagasi, ülejäänud võtmed jäävad leitavaks
+	bool removed = true;
+	for (size_t i = 0; i < NUM_KEYS; i += 2)
+	{
+		removed &= hashMapOA_remove(&map, keys[i]) == keys[i];
+	}
+	test(removed, "Removing failed!");
+	test(hashMapOA_remove(&map, keys[0]) == NULL, "Key was removed twice!");
+	test(map.numItems == (NUM_KEYS / 2), "%zu items left instead of %d!", map.numItems, NUM_KEYS / 2);
+	found = true;
+	for (size_t i = 0; i < NUM_KEYS; ++i)
+	{
+		found &= (hashMapOA_get(&map, keys[i]) != NULL) == ((i % 2) == 1);
+	}
+	test(found, "Lookups after removing gave wrong results!");
+
+	// Koopia ja suuruse muutmine säilitavad sisu
+	hashMapOA_t copy;
+	test(hashMapOA_initCopy(&copy, 1, &map), "Copying failed!");
+	test(copy.numItems == map.numItems, "Copy has %zu items instead of %zu!", copy.numItems, map.numItems);
+	test(hashMapOA_resize(&copy, 4 * NUM_KEYS), "Resizing failed!");
+	found = true;
+	for (size_t i = 1; i < NUM_KEYS; i += 2)
+	{
+		const hashEntryOA_t * entry = hashMapOA_get(&copy, keys[i]);
+		found &= (entry != NULL) && (entry->value == keys[i]);
+	}
+	test(found, "Copied keys weren't found!");
+
+	hashMapOA_destroy(&copy);
+	hashMapOA_destroy(&map);
+
+	// Räsi sõltub ainult võtme baitidest, kirjetesse salvestatud räsi on sama
+	test(hashMap_hashFull("J000123", 7) == hashMap_hashFull("J000123xyz", 7), "Hash depends on bytes after the key!");
+	test(hashMap_hashFull("J000123", 7) != hashMap_hashFull("J000124", 7), "Sequential ids collide!");
+	test(hashMap_hashFull("", 0) != hashMap_hashFull("J", 1), "Empty key collides!");
+	test(hashMap_hash(keys[123], 1009) == hashMap_hashLen(keys[123], strlen(keys[123]), 1009), "Slot indexes differ!");
+
+	hashMapCK_t chained;
+	test(hashMapCK_init(&chained, 1), "Chained map init failed!");
+	inserted = true;
+	for (size_t i = 0; i < NUM_KEYS; ++i)
+	{
+		inserted &= hashMapCK_insert(&chained, keys[i], keys[i]);
+	}
+	test(inserted, "Inserting to chained map failed!");
+	found = true;
+	for (size_t i = 0; i < NUM_KEYS; ++i)
+	{
+		const hashNodeCK_t * node = hashMapCK_get(&chained, keys[i]);
+		found &= (node != NULL) && (node->value == keys[i]) && (node->hash == hashMap_hashFull(keys[i], strlen(keys[i])));
+	}
+	test(found, "Chained map lost keys while resizing!");
+	hashMapCK_destroy(&chained);
+
+	// Inkrementaalses režiimis on migratsiooni ajal võtmed leitavad mõlemast massiivist
+	test(hashMapCK_init(&chained, 1), "Chained map init failed!");
+	hashMapCK_setIncremental(&chained, true);
+	inserted = true;
+	found    = true;
+	bool migrating = false;
+	for (size_t i = 0; i < NUM_KEYS; ++i)
+	{
+		inserted &= hashMapCK_insert(&chained, keys[i], keys[i]);
+		migrating |= (chained.oldNodes != NULL);
+		found &= (hashMapCK_get(&chained, keys[i / 2]) != NULL) && (hashMapCK_getLen(&chained, keys[i], 7) != NULL);
+	}
+	test(inserted, "Inserting to incremental map failed!");
+	test(migrating, "Incremental map was never migrating!");
+	test(found, "Incremental map lost keys while migrating!");
+	test(!hashMapCK_insert(&chained, keys[0], NULL), "Duplicate key was inserted while migrating!");
+
+	hashMapCK_t copy2;
+	test(hashMapCK_initCopy(&copy2, 1, &chained), "Copying incremental map failed!");
+	test(copy2.numItems == NUM_KEYS, "Copy has %zu items instead of %d!", copy2.numItems, NUM_KEYS);
+	hashMapCK_destroy(&copy2);
+
+	removed = true;
+	for (size_t i = 0; i < NUM_KEYS; i += 2)
+	{
+		removed &= hashMapCK_remove(&chained, keys[i]) == keys[i];
+	}
+	test(removed, "Removing from incremental map failed!");
+	hashMapCK_setIncremental(&chained, false);
+	test(chained.oldNodes == NULL, "Migration wasn't finished!");
+	found = true;
+	for (size_t i = 0; i < NUM_KEYS; ++i)
+	{
+		found &= (hashMapCK_get(&chained, keys[i]) != NULL) == ((i % 2) == 1);
+	}
+	test(found, "Lookups after migrating gave wrong results!");
+
+	// Eemaldatud sõlmed võetakse uuesti kasutusse, mälupuhver vabastatakse plokkide kaupa
+	const arenaBlock_t * chainedBlock = chained.pool.head;
+	inserted = true;
+	for (size_t i = 0; i < NUM_KEYS; i += 2)
+	{
+		inserted &= hashMapCK_insert(&chained, keys[i], keys[i]);
+	}
+	test(inserted, "Reinserting to chained map failed!");
+	test(chained.pool.head == chainedBlock, "Removed chained nodes weren't reused!");
+	hashMapCK_destroy(&chained);
+	test(chained.pool.head == NULL, "Chained node pool wasn't freed!");
+
+	// Samaaegne režiim, lugejad otsivad kirjutajate lisamise, eemaldamise ja suuruse muutmise ajal
+	hashMapCK_t shared;
+	test(hashMapCK_initConcurrent(&shared, 1), "Concurrent map init failed!");
+	inserted = true;
+	for (size_t i = 0; i < NUM_STABLE_KEYS; ++i)
+	{
+		inserted &= hashMapCK_insert(&shared, keys[i], keys[i]);
+	}
+	test(inserted, "Inserting to concurrent map failed!");
+	test(!hashMapCK_insert(&shared, keys[0], NULL), "Duplicate key was inserted to concurrent map!");
+
+	concurrentTask_t tasks[NUM_WRITERS + NUM_READERS];
+	const size_t perWriter = (NUM_KEYS - NUM_STABLE_KEYS) / NUM_WRITERS;
+	for (size_t i = 0; i < (NUM_WRITERS + NUM_READERS); ++i)
+	{
+		tasks[i] = (concurrentTask_t){
+			.map    = &shared,
+			.keys   = keys,
+			.first  = (i < NUM_WRITERS) ? (NUM_STABLE_KEYS + i * perWriter) : 0,
+			.last   = (i < NUM_WRITERS) ? (NUM_STABLE_KEYS + (i + 1) * perWriter) : NUM_STABLE_KEYS,
+			.writer = (i < NUM_WRITERS),
+			.ok     = false
+		};
+	}
+	thelper_run(&concurrentWork, tasks, NUM_WRITERS + NUM_READERS, sizeof(concurrentTask_t));
+	for (size_t i = 0; i < (NUM_WRITERS + NUM_READERS); ++i)
+	{
+		test(tasks[i].ok, "Concurrent %s %zu got wrong results!", tasks[i].writer ? "writer" : "reader", i);
+	}
+	found = true;
+	for (size_t i = 0; i < NUM_KEYS; ++i)
+	{
+		found &= (hashMapCK_get(&shared, keys[i]) != NULL) == (i < NUM_STABLE_KEYS);
+	}
+	test(found, "Concurrent map has wrong contents after the threads finished!");
+
+	hashMapCK_t sharedCopy;
+	test(hashMapCK_initCopy(&sharedCopy, 1, &shared), "Copying concurrent map failed!");
+	test(sharedCopy.numItems == NUM_STABLE_KEYS, "Copy of concurrent map has %zu items!", sharedCopy.numItems);
+	test(hashMapCK_get(&sharedCopy, keys[17])->value == keys[17], "Copy of concurrent map has a wrong value!");
+	hashMapCK_destroy(&sharedCopy);
+	hashMapCK_destroy(&shared);
+	test(shared.concurrent == NULL, "Concurrent map wasn't destroyed!");
+
+	// Võtmete koopiad on räsitabeli mälupuhvris, eemaldatud sõlmi kasutatakse uuesti
+	hashMap_t owning;
+	test(hashMap_init(&owning, 1), "Map init failed!");
+	char keyBuf[16];
+	inserted = true;
+	for (size_t i = 0; i < NUM_KEYS; ++i)
+	{
+		strcpy(keyBuf, keys[i]);
+		inserted &= hashMap_insert(&owning, keyBuf, keys[i]);
+	}
+	memset(keyBuf, 0, sizeof(keyBuf));
+	test(inserted, "Inserting to owning map failed!");
+	found = true;
+	for (size_t i = 0; i < NUM_KEYS; ++i)
+	{
+		const hashNode_t * node = hashMap_get(&owning, keys[i]);
+		found &= (node != NULL) && (node->value == keys[i]) && (node->key != keys[i]);
+	}
+	test(found, "Owning map lost keys while resizing!");
+	const arenaBlock_t * block = owning.pool.head;
+	removed = true;
+	for (size_t i = 0; i < NUM_KEYS; i += 2)
+	{
+		removed &= hashMap_remove(&owning, keys[i]) == keys[i];
+		removed &= hashMap_insert(&owning, keys[i], NULL);
+	}
+	test(removed, "Removing and reinserting failed!");
+	test(owning.pool.head == block, "Removed nodes weren't reused!");
+	test(hashMap_get(&owning, keys[2])->value == NULL, "Reinserted node has old value!");
+	hashMap_destroy(&owning);
+	test(owning.pool.head == NULL, "Node pool wasn't freed!");
+
+	// Täiuslik räsi annab igale võtmele tema enda indeksi, pesasid on vähe rohkem kui võtmeid
+	hashMapPH_t perfect;
+	const char * perfectKeys[NUM_KEYS];
+	for (size_t i = 0; i < NUM_KEYS; ++i)
+	{
+		perfectKeys[i] = keys[i];
+	}
+	test(hashMapPH_build(&perfect, perfectKeys, NUM_KEYS), "Perfect hash building failed!");
+	test(perfect.numSlots < (NUM_KEYS * 17 / 16 + 2), "Perfect hash has %zu slots!", perfect.numSlots);
+	found = true;
+	for (size_t i = 0; i < NUM_KEYS; ++i)
+	{
+		found &= hashMapPH_get(&perfect, keys[i], strlen(keys[i])) == i;
+	}
+	test(found, "Perfect hash gave wrong indexes!");
+	const uint32_t other = hashMapPH_get(&perfect, "X000001", 7);
+	test((other == HASHMAPPH_EMPTY) || (other < NUM_KEYS), "Unknown key gave index %u!", other);
+	test(hashMapPH_get(&perfect, "J000007xyz", 7) == 7, "Length-delimited lookup failed!");
+
+	hashMapPH_t view;
+	hashMapPH_initView(&view, perfect.pilots, perfect.numBuckets, perfect.slots, perfect.numSlots);
+	test(hashMapPH_get(&view, keys[123], strlen(keys[123])) == 123, "Perfect hash view gave a wrong index!");
+	hashMapPH_destroy(&view);
+	hashMapPH_destroy(&perfect);
+	test(perfect.slots == NULL, "Perfect hash wasn't destroyed!");
+
+	perfectKeys[1] = keys[0];
+	test(!hashMapPH_build(&perfect, perfectKeys, NUM_KEYS), "Perfect hash of duplicate keys was built!");
+	test(hashMapPH_build(&perfect, perfectKeys, 0), "Perfect hash of no keys wasn't built!");
+	test(hashMapPH_get(&perfect, "J", 1) == HASHMAPPH_EMPTY, "Empty perfect hash found a key!");
+	hashMapPH_destroy(&perfect);
+
+	return 0;
+}
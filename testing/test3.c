@@ -2,6 +2,8 @@
 #include "../src/iniFile.h"
 
 #include <string.h>
+#include <stdio.h>
+#include <stdint.h>
 
 #define FILE_DATA \
 	"; last modified 1 April 2001 by John Doe\n" \
@@ -15,6 +17,8 @@
 	"Port = 143\n" \
 	"fIle = \"payroll.dat\""
 
+#define COMMENT_DATA "[s]\na = 1;comment\nb = 2\nc = 3#x\nd = 4;"
+
 
 void testkv(iniSection_t * sect, const char * key, const char * value, bool outcome)
 {
@@ -53,6 +57,22 @@ void testData(const char * lib_, const char * data, bool pass, void (*testfunc)(
 	endphase();
 }
 
+void testErr(const char * lib_, const char * data, iniErr_t expected)
+{
+	setlib(lib_);
+
+	test(ini_checkData(data, -1) == expected, "Input: %s, check didn't return %d!", data, expected);
+	ini_t ini;
+	iniErr_t code = ini_initData(&ini, data, -1);
+	test(code == expected, "Input: %s, parser returned %d instead of %d!", data, code, expected);
+	if (code == inieOK)
+	{
+		ini_destroy(&ini);
+	}
+
+	endphase();
+}
+
 void t1(ini_t * ptr)
 {
 	iniSection_t * sect = ini_getSection(ptr, "");
@@ -129,8 +149,178 @@ void t6(ini_t * ptr)
 	testkv(sect, "server", "192.0.2.62", true);
 	testkv(sect, "port", "143", true);
 	testkv(sect, "file", "payroll.dat", true);
+
+	// Parsitud sõned kuuluvad lugejale, teisendatud koopiad asuvad selle areenis
+	iniValue_t * v = iniSection_getValue(ini_getSection(ptr, "owner"), "organization");
+	test(v != NULL && !v->key.owned && !v->value.owned, "Key & value should be views to source data!");
+	v = iniSection_getValue(ini_getSection(ptr, "owner"), "name");
+	test(v != NULL && !v->key.owned && (strcmp(v->key.str, "name") == 0), "Lowercased key should be a view to reader's copy!");
 }
+void t7(ini_t * ptr)
+{
+	iniSection_t * sect = ini_getSection(ptr, "");
+	test(sect != NULL, "No global section found!");
+
+	testkv(sect, "key", "a;b", true);
+	testkv(sect, "last", "end", true);
+	iniValue_t * v = iniSection_getValue(sect, "key");
+	test(v != NULL && !v->value.owned && (strcmp(v->value.str, "a;b") == 0), "Unescaped value should be a view to reader's copy!");
+}
+void t8(ini_t * ptr)
+{
+	iniSection_t * sect = ini_getSection(ptr, "s");
+	test(sect != NULL, "No section [s] found!");
 
+	// Kommentaar vahetult väärtuse järel ei lõpeta andmeid
+	testkv(sect, "a", "1", true);
+	testkv(sect, "b", "2", true);
+	testkv(sect, "c", "3", true);
+	testkv(sect, "d", "4", true);
+	test(sect->numValues == 4, "%zu values instead of 4!", sect->numValues);
+}
+
+typedef struct events
+{
+	char buf[256];
+	size_t len, num, limit;
+
+} events_t;
+
+bool collect(void * userData, const iniString_t * section, const iniString_t * key, const iniString_t * value)
+{
+	events_t * ev = userData;
+	ev->len += (size_t)snprintf(
+		ev->buf + ev->len, sizeof(ev->buf) - ev->len, "%s|%s|%s;",
+		section->str, (key != NULL) ? key->str : "-", (value != NULL) ? value->str : "-"
+	);
+	++ev->num;
+	return ev->num < ev->limit;
+}
+void testReader(void)
+{
+	setlib("iniFile reader");
+
+	// Sündmused tulevad failis oleku järjekorras, sektsiooni algus ilma võtmeta
+	events_t ev = { .len = 0, .num = 0, .limit = SIZE_MAX };
+	iniReader_t reader;
+	iniErr_t code = iniReader_initData(&reader, "g = 1\n[Sec]\nKey = \"v\"\n[other]\na = b", -1, &collect, &ev);
+	test(code == inieOK, "Reading failed, return code: %d", code);
+	test(strcmp(ev.buf, "|g|1;sec|-|-;sec|key|v;other|-|-;other|a|b;") == 0, "Wrong events: %s", ev.buf);
+	iniReader_destroy(&reader);
+
+	// Tagasikutse saab lugemise katkestada
+	ev = (events_t){ .len = 0, .num = 0, .limit = 2 };
+	code = iniReader_initData(&reader, "a = 1\nb = 2\nc = 3", -1, &collect, &ev);
+	test(code == inieABORT, "Reading wasn't aborted, return code: %d", code);
+	test(ev.num == 2, "Callback called %zu times after abort!", ev.num);
+	iniReader_destroy(&reader);
+}
+void testRanges(void)
+{
+	setlib("iniFile ranges");
+
+	// Kommentaar lõpeb reavahetusel ka kaldkriipsu järel, sektsioon algab järgmisel real
+	const char * data = "g = 1\n[a]\nx = 1\n; c\\\n[b]\n  [c]\nz = 3";
+	const size_t len = strlen(data);
+	test(fhelper_writeBin("ranges.ini", data, len) == (intptr_t)len, "Writing test file failed!");
+
+	iniReader_t reader;
+	iniErr_t code = iniReader_openFile(&reader, "ranges.ini");
+	test(code == inieOK, "Opening failed, return code: %d", code);
+	test(iniReader_nextLine(&reader, 1) == 6, "Wrong line start: %zu", iniReader_nextLine(&reader, 1));
+	test(iniReader_nextLine(&reader, 17) == 21, "Wrong line start: %zu", iniReader_nextLine(&reader, 17));
+	test(iniReader_nextSection(&reader, 0) == 6, "Wrong section start: %zu", iniReader_nextSection(&reader, 0));
+	test(iniReader_nextSection(&reader, 7) == 21, "Wrong section start: %zu", iniReader_nextSection(&reader, 7));
+	test(iniReader_nextSection(&reader, 22) == 25, "Wrong section start: %zu", iniReader_nextSection(&reader, 22));
+	test(iniReader_nextSection(&reader, 26) == len, "Section found after the last one!");
+	size_t bodyLen = 0;
+	test(iniReader_findSection(&reader, "a", &bodyLen) == 10, "Wrong body start of section a!");
+	test(bodyLen == 11, "Wrong body length of section a: %zu", bodyLen);
+	test(iniReader_countLines(&reader, 10, bodyLen) == 3, "Wrong line count: %zu", iniReader_countLines(&reader, 10, bodyLen));
+	test(iniReader_findSection(&reader, "c", &bodyLen) == 31, "Wrong body start of section c!");
+	test(iniReader_countLines(&reader, 31, bodyLen) == 1, "Wrong line count: %zu", iniReader_countLines(&reader, 31, bodyLen));
+	test(iniReader_findSection(&reader, "d", &bodyLen) == len, "Nonexistent section was found!");
+
+	// Vahemikud loetakse eraldi, viimase vahemiku väärtus kopeeritakse areeni
+	events_t ev = { .len = 0, .num = 0, .limit = SIZE_MAX };
+	code = iniReader_parse(&reader, 25, len - 25, NULL, &collect, &ev);
+	test(code == inieOK, "Reading range failed, return code: %d", code);
+	test(strcmp(ev.buf, "c|-|-;c|z|3;") == 0, "Wrong events: %s", ev.buf);
+	ev = (events_t){ .len = 0, .num = 0, .limit = SIZE_MAX };
+	arena_t arena;
+	arena_init(&arena, 0);
+	code = iniReader_parse(&reader, 6, 25 - 6, &arena, &collect, &ev);
+	test(code == inieOK, "Reading range failed, return code: %d", code);
+	test(strcmp(ev.buf, "a|-|-;a|x|1;b|-|-;") == 0, "Wrong events: %s", ev.buf);
+	code = iniReader_parse(&reader, 0, 6, &arena, &collect, &ev);
+	test((code == inieOK) && (ev.num == 4), "Reading first range failed, return code: %d", code);
+	arena_destroy(&arena);
+	iniReader_destroy(&reader);
+	remove("ranges.ini");
+}
+
+void testCommentFile(void)
+{
+	setlib("iniFile comments");
+
+	// Failist lugedes kirjutatakse väärtuse terminaator lugeja puhvrisse
+	FILE * file = fopen("comments.ini", "w");
+	test(file != NULL, "Can't create comments file!");
+	fputs(COMMENT_DATA, file);
+	fclose(file);
+	ini_t ini;
+	iniErr_t code = ini_initFile(&ini, "comments.ini");
+	test(code == inieOK, "Reading comments file failed, return code: %d", code);
+	t8(&ini);
+	ini_destroy(&ini);
+	remove("comments.ini");
+}
+
+void testSections(void)
+{
+	setlib("iniFile sections");
+
+	// Väikeses sektsioonis otsitakse massiivist, suurele ehitatakse räsitabel
+	iniSection_t * sect = iniSection_make("s", -1);
+	test(sect != NULL, "Section creation failed!");
+	if (sect == NULL)
+	{
+		return;
+	}
+	char key[16];
+	bool added = true;
+	for (int i = 0; i < (2 * INI_SECTION_INDEX_MIN); ++i)
+	{
+		snprintf(key, sizeof(key), "k%d", i);
+		added &= iniSection_addValue(sect, key, -1, "v", -1);
+		if (i == 0)
+		{
+			test(!iniSection_addValue(sect, "k0", -1, "w", -1), "Duplicate key was added to small section!");
+			testkv(sect, "k0", "v", true);
+			testkv(sect, "k", "", false);
+		}
+		if (i == (INI_SECTION_INDEX_MIN - 2))
+		{
+			test(sect->valueMap.entries == NULL, "Small section has a hash index!");
+		}
+	}
+	test(added, "Adding values failed!");
+	test(sect->valueMap.entries != NULL, "Large section has no hash index!");
+	test(!iniSection_addValue(sect, "k3", -1, "w", -1), "Duplicate key was added to large section!");
+	test(iniSection_removeValue(sect, "k3"), "Removing value failed!");
+	testkv(sect, "k3", "", false);
+	testkv(sect, "k15", "v", true);
+	iniSection_free(sect);
+
+	// Korduv võti väikeses sektsioonis lükkab faili tagasi nagu suures
+	ini_t ini;
+	iniErr_t code = ini_initData(&ini, "[section]\nkey = a\nkey = b\n", -1);
+	test(code != inieOK, "Duplicate key was accepted!");
+	if (code == inieOK)
+	{
+		ini_destroy(&ini);
+	}
+}
 
 
 int main(void)
@@ -145,6 +335,19 @@ int main(void)
 	testData("iniFile t5", "[section]key = domain", true, &t5);
 	testData("iniFile tx", "[section key = domain", false, NULL);
 	testData("iniFile t6", FILE_DATA, true, &t6);
+	testData("iniFile t7", "key = a\\;b\nlast=end", true, &t7);
+	testData("iniFile t8", COMMENT_DATA, true, &t8);
+	testCommentFile();
+
+	testErr("iniFile e1", "[section]\nkey value\n", inieVALUE);
+	testErr("iniFile e2", "[section]\nkey = \"value\n", inieQUOTE);
+	testErr("iniFile e3", "key = value\n[section", inieSECTION);
+	testErr("iniFile e4", "key = value\\", inieESCAPE);
+	testErr("iniFile e5", "key = value\nkey2 = b\n", inieOK);
+
+	testReader();
+	testRanges();
+	testSections();
 
 	return 0;
 }
@@ -2,15 +2,363 @@
 #include "../src/dataModel.h"
 #include "../src/logger.h"
 
+#include <string.h>
+#include <math.h>
+
+#define GRID_SIZE 120
+#define RENUMBER_SIZE 12
+
+/**
+ * @brief Writes a test data file
+ * 
+ * @param name File name
+ * @param data Null-terminated contents of the file
+ */
+static void writeFile(const char * name, const char * data)
+{
+	FILE * file = fopen(name, "w");
+	test(file != NULL, "Can't create file %s!", name);
+	fputs(data, file);
+	fclose(file);
+}
+
+/**
+ * @brief Copies a binary file, replacing one value of the first occurrence of a
+ * byte pattern
+ * 
+ * @param src Source file name
+ * @param dst Destination file name
+ * @param pattern Byte pattern to find
+ * @param patternSize Size of the pattern in bytes
+ * @param offset Offset of the replaced value from the start of the pattern
+ * @param value Replacement value
+ * @param valueSize Size of the replacement value in bytes
+ */
+static void corruptFile(
+	const char * src, const char * dst,
+	const void * pattern, size_t patternSize,
+	size_t offset, const void * value, size_t valueSize
+)
+{
+	FILE * file = fopen(src, "rb");
+	test(file != NULL, "Can't open file %s!", src);
+	static char data[4096];
+	const size_t size = fread(data, 1, sizeof data, file);
+	fclose(file);
+
+	bool found = false;
+	for (size_t i = 0; !found && ((i + patternSize) <= size); ++i)
+	{
+		if (memcmp(&data[i], pattern, patternSize) == 0)
+		{
+			memcpy(&data[i + offset], value, valueSize);
+			found = true;
+		}
+	}
+	test(found, "Pattern wasn't found in %s!", src);
+
+	file = fopen(dst, "wb");
+	test(file != NULL, "Can't create file %s!", dst);
+	fwrite(data, 1, size, file);
+	fclose(file);
+}
+
+/**
+ * @brief Checks that the intern ids of a loaded data model are dense and unique:
+ * every id in [0, numInternIds) belongs to exactly one junction, stops share the id
+ * with their projection
+ * 
+ * @param dm Pointer to loaded dataModel structure
+ */
+static void testInternIds(const dataModel_t * dm)
+{
+	test(dm->numInternIds == dm->numJunctions, "%u intern ids for %zu junctions!", dm->numInternIds, dm->numJunctions);
+	bool * seen = calloc(dm->numInternIds, sizeof(bool));
+	bool dense = seen != NULL;
+	for (size_t i = 0; dense && (i < dm->numJunctions); ++i)
+	{
+		const uint32_t id = dm->junctions[i]->internId;
+		dense = (id < dm->numInternIds) && !seen[id];
+		seen[id] = dense;
+	}
+	free(seen);
+	test(dense, "Junction intern ids aren't unique!");
+	for (size_t i = 0; i < (dm->numMidPoints + 2); ++i)
+	{
+		test(dm->pointsp[i]->internId == dm->points[i].internId, "Stop %s projection has a different intern id!", dm->points[i].id.str);
+	}
+}
+
+/**
+ * @brief Loads a generated grid network serially and in parallel chunks, the data
+ * models have to be identical
+ * 
+ */
+static void testParallelLoad(void)
+{
+	// Suured sektsioonid loetakse tükkidena mitmes lõimes, tulemus on sama mis järjest lugedes
+	FILE * grid = fopen("grid.ini", "w");
+	test(grid != NULL, "Can't create grid file!");
+	if (grid != NULL)
+	{
+		fprintf(grid, "[ristmikud]\n");
+		for (int y = 0; y < GRID_SIZE; ++y)
+		{
+			for (int x = 0; x < GRID_SIZE; ++x)
+			{
+				fprintf(grid, "j%d_%d = %d.5, %d\n", y, x, x, y);
+			}
+		}
+		fprintf(grid, "[teed]\n");
+		for (int y = 0; y < GRID_SIZE; ++y)
+		{
+			for (int x = 0; x < GRID_SIZE; ++x)
+			{
+				if ((x + 1) < GRID_SIZE)
+				{
+					fprintf(grid, "h%d_%d = j%d_%d,j%d_%d\n", y, x, y, x, y, x + 1);
+				}
+				if ((y + 1) < GRID_SIZE)
+				{
+					fprintf(grid, "v%d_%d = j%d_%d, j%d_%d, %d.25\n", y, x, y, x, y + 1, x, 1 + (x % 3));
+				}
+			}
+		}
+		fprintf(grid, "[peatused]\np0 = 0.2, 0.3\np1 = 50.1, 60.2\np2 = 70, 20\n");
+		fclose(grid);
+
+		dataModel_t sdm, pdm;
+		const dmLoadOptions_t serial = { .numThreads = 1 }, parallel = { .numThreads = 4 };
+		dmErr_t code = dm_initDataFile(&sdm, "grid.ini", &serial);
+		test(code == dmeOK, "Serial grid reading failed with code %d!", code);
+		dmErr_t pcode = dm_initDataFile(&pdm, "grid.ini", &parallel);
+		test(pcode == dmeOK, "Parallel grid reading failed with code %d!", pcode);
+		if ((code == dmeOK) && (pcode == dmeOK))
+		{
+			test(pdm.numJunctions == sdm.numJunctions, "%zu junctions instead of %zu!", pdm.numJunctions, sdm.numJunctions);
+			test(pdm.numRoads == sdm.numRoads, "%zu roads instead of %zu!", pdm.numRoads, sdm.numRoads);
+			bool same = (pdm.numJunctions == sdm.numJunctions) && (pdm.numRoads == sdm.numRoads);
+			for (size_t i = 0; same && (i < sdm.numJunctions); ++i)
+			{
+				same = (strcmp(pdm.junctions[i]->id.str, sdm.junctions[i]->id.str) == 0) &&
+					(pdm.junctions[i]->x == sdm.junctions[i]->x) && (pdm.junctions[i]->y == sdm.junctions[i]->y) &&
+					(pdm.junctions[i]->internId == sdm.junctions[i]->internId);
+			}
+			for (size_t i = 0; same && (i < sdm.numRoads); ++i)
+			{
+				same = (strcmp(pdm.roads[i]->id.str, sdm.roads[i]->id.str) == 0) &&
+					(strcmp(pdm.roads[i]->src->id.str, sdm.roads[i]->src->id.str) == 0) &&
+					(strcmp(pdm.roads[i]->dst->id.str, sdm.roads[i]->dst->id.str) == 0) &&
+					(pdm.roads[i]->cost == sdm.roads[i]->cost);
+			}
+			test(same, "Parallel loading gave a different data model!");
+			testInternIds(&sdm);
+			testInternIds(&pdm);
+		}
+		if (code == dmeOK)
+		{
+			dm_destroy(&sdm);
+		}
+		if (pcode == dmeOK)
+		{
+			dm_destroy(&pdm);
+		}
+		remove("grid.ini");
+	}
+
+}
+
+/**
+ * @brief Numbers junctions in the reverse order of the junctions array
+ * 
+ * @param dm Pointer to loaded dataModel structure
+ */
+static void reverseJunctions(dataModel_t * dm)
+{
+	for (size_t i = 0, j = dm->numJunctions - 1; i < j; ++i, --j)
+	{
+		point_t * p = dm->junctions[i];
+		dm->junctions[i] = dm->junctions[j];
+		dm->junctions[j] = p;
+	}
+	for (size_t i = 0; i < dm->numJunctions; ++i)
+	{
+		dm->junctions[i]->idx = i;
+	}
+}
+
+/**
+ * @brief Renumbers junctions along the Hilbert curve, no junction may be lost and
+ * the path results have to be the same as with another numbering
+ * 
+ */
+static void testRenumbering(void)
+{
+	// Ruudustik erinevate teede hindadega, et lühimad teed oleksid üheselt määratud
+	FILE * file = fopen("renumber.ini", "w");
+	test(file != NULL, "Can't create renumbering file!");
+	fprintf(file, "[ristmikud]\n");
+	for (int y = 0; y < RENUMBER_SIZE; ++y)
+	{
+		for (int x = 0; x < RENUMBER_SIZE; ++x)
+		{
+			fprintf(file, "j%d_%d = %d, %d\n", y, x, 10 * x, 10 * y);
+		}
+	}
+	fprintf(file, "[teed]\n");
+	for (int y = 0; y < RENUMBER_SIZE; ++y)
+	{
+		for (int x = 0; x < RENUMBER_SIZE; ++x)
+		{
+			if ((x + 1) < RENUMBER_SIZE)
+			{
+				fprintf(file, "h%d_%d = j%d_%d, j%d_%d, %d.%d\n", y, x, y, x, y, x + 1, 1 + ((7 * x + 3 * y) % 5), (x * y) % 10);
+			}
+			if ((y + 1) < RENUMBER_SIZE)
+			{
+				fprintf(file, "v%d_%d = j%d_%d, j%d_%d, %d.%d\n", y, x, y, x, y + 1, x, 1 + ((5 * x + 11 * y) % 4), (x + y) % 10);
+			}
+		}
+	}
+	fprintf(file, "[peatused]\np0 = 3, 2\np1 = 87, 14\np2 = 55, 101\np3 = 12, 66\np4 = 104, 78\n");
+	fclose(file);
+
+	dataModel_t hdm, rdm;
+	dmErr_t code = dm_initDataFile(&hdm, "renumber.ini", NULL);
+	test(code == dmeOK, "Renumbering data reading failed with code %d!", code);
+	dmErr_t rcode = dm_initDataFile(&rdm, "renumber.ini", NULL);
+	test(rcode == dmeOK, "Renumbering data reading failed with code %d!", rcode);
+	remove("renumber.ini");
+
+	// Teistsugusest järjestusest nummerdatakse uuesti, iga ristmik saab täpselt ühe indeksi
+	reverseJunctions(&hdm);
+	point_t ** before = malloc(sizeof(point_t *) * hdm.numJunctions);
+	test(before != NULL, "Allocating junctions failed!");
+	memcpy(before, hdm.junctions, sizeof(point_t *) * hdm.numJunctions);
+	const size_t numJunctions = hdm.numJunctions;
+	test(dm_updateJunctionIndexes(&hdm), "Renumbering junctions failed!");
+	test(hdm.numJunctions == numJunctions, "%zu junctions after renumbering instead of %zu!", hdm.numJunctions, numJunctions);
+	bool kept = true, indexed = true;
+	for (size_t i = 0; i < numJunctions; ++i)
+	{
+		indexed &= hdm.junctions[i]->idx == i;
+		kept &= (before[i]->idx < numJunctions) && (hdm.junctions[before[i]->idx] == before[i]);
+	}
+	free(before);
+	test(indexed, "Junction indexes don't match the array order!");
+	test(kept, "Junctions were lost while renumbering!");
+
+	// Hilberti järjestus ei muuda kaugusi ega peatuste järjekorda
+	reverseJunctions(&rdm);
+	test(dm_createMatrices(&hdm) && dm_findShortestPath(&hdm), "Path search failed!");
+	test(dm_createMatrices(&rdm) && dm_findShortestPath(&rdm), "Path search failed!");
+	const size_t numStops = hdm.numMidPoints + 2;
+	bool sameDist = true, sameOrder = true;
+	for (size_t i = 0; i < (numStops * numStops); ++i)
+	{
+		sameDist &= fabsf(hdm.stopsDistMatrix[i].dist - rdm.stopsDistMatrix[i].dist) <= (1e-5f * hdm.stopsDistMatrix[i].dist);
+	}
+	for (size_t i = 0; i < numStops; ++i)
+	{
+		sameOrder &= hdm.bestStopsIndices[i] == rdm.bestStopsIndices[i];
+	}
+	test(sameDist, "Renumbering changed the stop distances!");
+	test(sameOrder, "Renumbering changed the order of stops!");
+	test(hdm.shortestPathLen == rdm.shortestPathLen, "Path has %zu points instead of %zu!", hdm.shortestPathLen, rdm.shortestPathLen);
+	bool samePath = hdm.shortestPathLen == rdm.shortestPathLen;
+	for (size_t i = 0; samePath && (i < hdm.shortestPathLen); ++i)
+	{
+		samePath = strcmp(hdm.shortestPath[i]->id.str, rdm.shortestPath[i]->id.str) == 0;
+	}
+	test(samePath, "Renumbering changed the path!");
+
+	dm_destroy(&hdm);
+	dm_destroy(&rdm);
+}
+
+/**
+ * @brief Compiles a map with a road from a junction to itself, the road is left out
+ * like a road collapsed by merging. Images with such a road or a zero cost are rejected.
+ * 
+ */
+static void testCompiledLoops(void)
+{
+	writeFile(
+		"loops.ini",
+		"[ristmikud]\na = 0, 0\nb = 100, 0\nc = 100, 100\n"
+		"[teed]\nab = a, b\nbb = b, b\nbc = b, c, 3.5\nca = c, a, 2\n"
+		"[peatused]\np0 = 10, 1\np1 = 90, 50\np2 = 40, 45\n"
+	);
+
+	dataModel_t dm;
+	dmErr_t code = dm_initDataFile(&dm, "loops.ini", NULL);
+	test(code == dmeOK, "Data reading failed with code %d!", code);
+	if (code == dmeOK)
+	{
+		test(dm.numOrigRoads == 3, "%zu roads instead of 3!", dm.numOrigRoads);
+		dm_destroy(&dm);
+	}
+
+	code = dm_compileDataFile("loops.ini", "loops.bin", NULL);
+	test(code == dmeOK, "Map compiling failed with code %d!", code);
+	code = dm_initCompiled(&dm, "loops.bin", "loops.ini");
+	test(code == dmeOK, "Compiled map reading failed with code %d!", code);
+	if (code == dmeOK)
+	{
+		test(dm.numOrigRoads == 3, "%zu roads instead of 3!", dm.numOrigRoads);
+		for (size_t i = 0; i < dm.numRoads; ++i)
+		{
+			test(dm.roads[i]->src != dm.roads[i]->dst, "Road %s is a loop!", dm.roads[i]->id.str);
+		}
+		dm_destroy(&dm);
+	}
+
+	// Teede otspunktid on kuvandis järjest: ab = (0, 1), bc = (1, 2), ca = (2, 0)
+	const uint32_t ends[] = { 0, 1, 1, 2, 2, 0 }, loopEnd = 1;
+	corruptFile("loops.bin", "loops2.bin", ends, sizeof ends, 3 * sizeof(uint32_t), &loopEnd, sizeof loopEnd);
+	code = dm_initCompiled(&dm, "loops2.bin", "loops.ini");
+	test(code == dmeFORMAT, "Image with a loop road wasn't rejected, code %d!", code);
+
+	const float costs[] = { 1.0f, 3.5f, 2.0f }, zeroCost = 0.0f;
+	corruptFile("loops.bin", "loops2.bin", costs, sizeof costs, sizeof(float), &zeroCost, sizeof zeroCost);
+	code = dm_initCompiled(&dm, "loops2.bin", "loops.ini");
+	test(code == dmeFORMAT, "Image with a zero cost road wasn't rejected, code %d!", code);
+
+	// Negatiivse hinnaga teed ei kompileerita
+	writeFile(
+		"loops.ini",
+		"[ristmikud]\na = 0, 0\nb = 100, 0\nc = 100, 100\n"
+		"[teed]\nab = a, b\nbc = b, c, -3\nca = c, a, 2\n"
+	);
+	code = dm_compileDataFile("loops.ini", "loops.bin", NULL);
+	test(code == dmeFORMAT, "Negative cost road was compiled, code %d!", code);
+
+	remove("loops.ini");
+	remove("loops.bin");
+	remove("loops2.bin");
+}
+
 int main(void)
 {
 	initLogger();
 
 	setlib("dataModel");
 
+	testParallelLoad();
+	testRenumbering();
+	testCompiledLoops();
+
+	// Kolmnurkne teedevõrk, iga peatus on eri teel
+	writeFile(
+		"test4.ini",
+		"[ristmikud]\na = 0, 0\nb = 100, 0\nc = 100, 100\n"
+		"[teed]\nab = a, b\nbc = b, c\nca = c, a, 2\n"
+		"[peatused]\np0 = 10, 1\np1 = 90, 50\np2 = 40, 45\n"
+	);
+
 	dataModel_t dm;
 
-	dmErr_t code = dm_initDataFile(&dm, "test.ini");
+	dmErr_t code = dm_initDataFile(&dm, "test4.ini", NULL);
 	test(code == dmeOK, "Data reading failed with code %d!", code);
 
 	teststr(dm.beg.id.str, "p0");
@@ -32,7 +380,174 @@ int main(void)
 		}
 	}
 
+	testInternIds(&dm);
+
+	// Kompileeritud kaardilt laetud andmemudel on sama teedevõrguga
+	code = dm_compileDataFile("test4.ini", "test4.bin", NULL);
+	test(code == dmeOK, "Map compiling failed with code %d!", code);
+
+	dataModel_t cdm;
+	code = dm_initCompiled(&cdm, "test4.bin", "test4.ini");
+	test(code == dmeOK, "Compiled map reading failed with code %d!", code);
+	if (code == dmeOK)
+	{
+		teststr(cdm.beg.id.str, "p0");
+		teststr(cdm.end.id.str, "p2");
+		test(cdm.numJunctions == dm.numJunctions, "%zu junctions instead of %zu!", cdm.numJunctions, dm.numJunctions);
+		test(cdm.numRoads == dm.numRoads, "%zu roads instead of %zu!", cdm.numRoads, dm.numRoads);
+		for (size_t i = 0; (i < dm.numRoads) && (i < cdm.numRoads); ++i)
+		{
+			teststr(cdm.roads[i]->id.str, dm.roads[i]->id.str);
+			test(cdm.roads[i]->cost == dm.roads[i]->cost, "Road %s cost differs!", dm.roads[i]->id.str);
+		}
+
+		testInternIds(&cdm);
+
+		// Ristmikud leitakse kaardi täiusliku räsiga, peatuste projektsioonid räsitabelist
+		test(cdm.junctionHash.numSlots > 0, "Compiled map has no junction hash!");
+		for (size_t i = 0; i < dm.numJunctions; ++i)
+		{
+			const point_t * p = dm_findJunction(&cdm, dm.junctions[i]->id.str);
+			test((p != NULL) && (strcmp(p->id.str, dm.junctions[i]->id.str) == 0), "Junction %s wasn't found!", dm.junctions[i]->id.str);
+			test(dm_findJunction(&dm, dm.junctions[i]->id.str) == dm.junctions[i], "Junction %s wasn't found!", dm.junctions[i]->id.str);
+		}
+		test(dm_findJunction(&cdm, "p0") == cdm.pointsp[0], "Stop projection wasn't found!");
+		test(dm_findJunction(&cdm, "tundmatu") == NULL, "Unknown junction was found!");
+		dm_destroy(&cdm);
+	}
+
+	// Kaardi ristmikuga sama id-ga peatus lükatakse tagasi nagu andmefailist laadides
+	writeFile("clash.ini", "[peatused]\na = 10, 1\np1 = 90, 50\np2 = 40, 45\n");
+	code = dm_initCompiled(&cdm, "test4.bin", "clash.ini");
+	test(code != dmeOK, "Stop with a junction's id was accepted!");
+	remove("clash.ini");
+
+	// Teise versiooni või vigane kuvand lükatakse tagasi
+	code = dm_initCompiled(&cdm, "test4.ini", "test4.ini");
+	test(code == dmeFORMAT, "Invalid map wasn't rejected, code %d!", code);
+
 	dm_destroy(&dm);
+	remove("test4.ini");
+	remove("test4.bin");
+
+	// Tolerantsist lähemal olev ristmik a2 ühendatakse a-ga, e jääb alles. Tee a2 -> b
+	// algab nüüd a-st, üheks punktiks kokku kukkunud tee aa2 jäetakse välja
+	writeFile(
+		"merge.ini",
+		"[ristmikud]\na = 0, 0\na2 = 0.3, 0.1\nb = 10, 0\nc = 10, 10\ne = 0, 2\n"
+		"[teed]\na2b = a2, b\nbc = b, c\nce = c, e\nea2 = e, a2\naa2 = a, a2\n"
+		"[peatused]\np0 = 5, 0.5\np1 = 9, 5\np2 = 5, 6\n"
+	);
+	const dmLoadOptions_t mergeOpts = { .mergeTolerance = 0.5f };
+	code = dm_initDataFile(&dm, "merge.ini", &mergeOpts);
+	test(code == dmeOK, "Merging data reading failed with code %d!", code);
+	if (code == dmeOK)
+	{
+		test(dm.numOrigRoads == 4, "%zu roads left after merging instead of 4!", dm.numOrigRoads);
+		test(dm.numJunctions == (4 + dm.numMidPoints + 2), "%zu junctions after merging!", dm.numJunctions);
+		bool rewired = true;
+		for (size_t i = 0; i < dm.numOrigRoads; ++i)
+		{
+			const line_t * road = dm.origRoads[i];
+			rewired &= (strcmp(road->src->id.str, "a2") != 0) && (strcmp(road->dst->id.str, "a2") != 0);
+			rewired &= (strcmp(road->id.str, "a2b") != 0) || (strcmp(road->src->id.str, "a") == 0);
+			rewired &= (strcmp(road->id.str, "ea2") != 0) || (strcmp(road->src->id.str, "e") == 0);
+		}
+		test(rewired, "Roads weren't rewired to the merged junction!");
+		test(dm_findJunction(&dm, "a2") == NULL, "Merged junction a2 exists!");
+		test(dm_findJunction(&dm, "e") != NULL, "Junction e outside tolerance was merged!");
+		// Ühendatud duplikaat ei saa oma internId-d
+		testInternIds(&dm);
+		dm_destroy(&dm);
+	}
+	// Valikud kehtivad ainult ühe laadimise jooksul
+	code = dm_initDataFile(&dm, "merge.ini", NULL);
+	test(code == dmeOK, "Data reading failed with code %d!", code);
+	if (code == dmeOK)
+	{
+		test(dm.numOrigRoads == 5, "%zu roads without merging instead of 5!", dm.numOrigRoads);
+		test(dm_findJunction(&dm, "a2") != NULL, "Junction a2 was merged without tolerance!");
+		dm_destroy(&dm);
+	}
+	remove("merge.ini");
+
+	// Saar x, y, z ei ole kolmnurgaga ühendatud: peatusteta saar jäetakse välja, saarel
+	// olev peatus on kättesaamatu
+	const char * network =
+		"[ristmikud]\na = 0, 0\nb = 100, 0\nc = 100, 100\nx = 500, 500\ny = 600, 500\nz = 550, 600\n"
+		"[teed]\nab = a, b\nbc = b, c\nca = c, a\nxy = x, y\nyz = y, z\n";
+	char data[512];
+	snprintf(data, sizeof(data), "%s[peatused]\np0 = 10, 1\np1 = 90, 50\np2 = 40, 45\n", network);
+	writeFile("island.ini", data);
+	code = dm_initDataFile(&dm, "island.ini", NULL);
+	test(code == dmeOK, "Island data reading failed with code %d!", code);
+	if (code == dmeOK)
+	{
+		const size_t numJunctions = dm.numJunctions;
+		code = dm_checkConnectivity(&dm);
+		test(code == dmeOK, "Connectivity check failed with code %d!", code);
+		test(dm.reachable[0] && dm.reachable[1] && dm.reachable[2], "Stops on the triangle are unreachable!");
+		test(dm.numJunctions == (numJunctions - 3), "%zu junctions kept of %zu!", dm.numJunctions, numJunctions);
+		bool compact = true;
+		for (size_t i = 0; i < dm.numJunctions; ++i)
+		{
+			compact &= (dm.junctions[i]->idx == i) && (dm.junctions[i]->id.str[0] != 'x') &&
+				(dm.junctions[i]->id.str[0] != 'y') && (dm.junctions[i]->id.str[0] != 'z');
+		}
+		test(compact, "Junctions weren't compacted!");
+		test(dm_findJunction(&dm, "x")->idx == SIZE_MAX, "Island junction has an index!");
+		bool pruned = true;
+		for (size_t i = 0; i < dm.numRoads; ++i)
+		{
+			pruned &= (dm.roads[i]->src->idx < dm.numJunctions) && (dm.roads[i]->dst->idx < dm.numJunctions);
+		}
+		test(pruned, "Island roads weren't removed!");
+		test(dm_createMatrices(&dm) && dm_findShortestPath(&dm), "Path search failed after pruning!");
+		dm_destroy(&dm);
+	}
+
+	snprintf(data, sizeof(data), "%s[peatused]\np0 = 10, 1\np1 = 90, 50\np2 = 550, 505\n", network);
+	writeFile("island.ini", data);
+	code = dm_initDataFile(&dm, "island.ini", NULL);
+	test(code == dmeOK, "Island data reading failed with code %d!", code);
+	if (code == dmeOK)
+	{
+		code = dm_checkConnectivity(&dm);
+		test(code == dmeUNREACHABLE, "Stop on the island was reachable, code %d!", code);
+		bool marked = true;
+		for (size_t i = 0; i < (dm.numMidPoints + 2); ++i)
+		{
+			marked &= dm.reachable[i] == (strcmp(dm.points[i].id.str, "p2") != 0);
+		}
+		test(marked, "Unreachable stops are marked wrong!");
+		dm_destroy(&dm);
+	}
+	remove("island.ini");
+
+	// Tee väljad loetakse kohapeal, identifikaatorite pikkus pole piiratud
+	char longId[300];
+	memset(longId, 'q', sizeof(longId) - 1);
+	longId[sizeof(longId) - 1] = '\0';
+	point_t pa = { .x = 0.0f, .y = 0.0f }, pb = { .x = 3.0f, .y = 4.0f };
+	hashMapOA_t pmap;
+	test(hashMapOA_init(&pmap, 4), "Point map init failed!");
+	test(hashMapOA_insert(&pmap, "a", &pa), "Point insert failed!");
+	test(hashMapOA_insert(&pmap, longId, &pb), "Point insert failed!");
+	test(hashMapOA_getLen(&pmap, "ab", 1) == hashMapOA_get(&pmap, "a"), "Length-delimited lookup failed!");
+	test(hashMapOA_getLen(&pmap, "a", 0) == NULL, "Empty key was found!");
+
+	iniString_t lid = { .str = "t", .len = 1, .owned = false };
+	line_t l;
+	char value[sizeof(longId) + 16];
+	snprintf(value, sizeof(value), "a,\t %s, 2.5", longId);
+	test(line_initStr(&l, &pmap, &lid, value), "Road with long id wasn't parsed!");
+	test((l.src == &pa) && (l.dst == &pb), "Road endpoints are wrong!");
+	test(l.cost == 2.5f, "Road cost is %f!", (double)l.cost);
+	test(line_initStr(&l, &pmap, &lid, "a,a"), "Road without cost wasn't parsed!");
+	test(l.cost == 1.0f, "Default road cost is %f!", (double)l.cost);
+	test(!line_initStr(&l, &pmap, &lid, "a,b,1"), "Road with unknown endpoint was parsed!");
+	test(!line_initStr(&l, &pmap, &lid, "a"), "Road without comma was parsed!");
+	hashMapOA_destroy(&pmap);
 
 	return 0;
 }
@@ -0,0 +1,177 @@
+#include "test.h"
+#include "../src/roadGrid.h"
+
+#include <math.h>
+
+#define NUM_POINTS  300
+#define NUM_ROADS   400
+#define NUM_QUERIES 200
+
+static float frand(float max)
+{
+	return ((float)rand() / (float)RAND_MAX) * max;
+}
+static float dist2(const point_t * p, const line_t * l)
+{
+	point_t ci;
+	line_intersect(&ci, p, l);
+	const float dx = ci.x - p->x, dy = ci.y - p->y;
+	return (dx * dx) + (dy * dy);
+}
+
+/**
+ * @brief Tests grid dimensions on nearly collinear roads, height of the bounding box
+ * is only a few ulps, so a cell size derived from the area alone would be tiny
+ *
+ */
+static void testCollinear(void)
+{
+	static point_t points[NUM_POINTS];
+	static line_t lines[NUM_ROADS];
+	line_t * roads[NUM_ROADS];
+
+	float y = 500.0f;
+	for (size_t i = 0; i < NUM_POINTS; ++i)
+	{
+		points[i] = (point_t){ .x = frand(1000.0f), .y = y };
+		if ((i % 100) == 99)
+		{
+			y = nextafterf(y, INFINITY);
+		}
+	}
+	for (size_t i = 0; i < NUM_ROADS; ++i)
+	{
+		size_t a = (size_t)rand() % NUM_POINTS, b = (size_t)rand() % NUM_POINTS;
+		if (a == b)
+		{
+			b = (b + 1) % NUM_POINTS;
+		}
+		lines[i] = (line_t){ .src = &points[a], .dst = &points[b], .cost = 0.5f + frand(4.0f) };
+		line_calc(&lines[i]);
+		roads[i] = &lines[i];
+	}
+
+	roadGrid_t grid;
+	test(roadGrid_init(&grid, roads, NUM_ROADS), "Collinear grid initialization failed!");
+	test(
+		(grid.cols <= (NUM_ROADS + 1)) && (grid.rows <= (NUM_ROADS + 1)) &&
+		((grid.cols * grid.rows) <= (4 * (NUM_ROADS + 1))),
+		"Collinear grid has too many cells: %zu x %zu!", grid.cols, grid.rows
+	);
+
+	bool knnOK = true;
+	for (size_t q = 0; q < NUM_QUERIES; ++q)
+	{
+		const point_t p = { .x = frand(1200.0f) - 100.0f, .y = frand(200.0f) + 400.0f };
+
+		float nearestLen2 = INFINITY;
+		for (size_t i = 0; i < NUM_ROADS; ++i)
+		{
+			nearestLen2 = fminf(nearestLen2, dist2(&p, roads[i]));
+		}
+
+		const size_t * res;
+		size_t numRes;
+		roadGrid_kNearest(&grid, roads, &p, 1, &res, &numRes);
+		knnOK &= (numRes == 1) && (dist2(&p, roads[res[0]]) == nearestLen2);
+	}
+	test(knnOK, "k-nearest query on collinear roads differs from brute force!");
+
+	roadGrid_destroy(&grid);
+}
+
+int main(void)
+{
+	setlib("roadGrid");
+	srand(1234);
+
+	static point_t points[NUM_POINTS];
+	static line_t lines[NUM_ROADS];
+	line_t * roads[NUM_ROADS];
+
+	for (size_t i = 0; i < NUM_POINTS; ++i)
+	{
+		points[i] = (point_t){ .x = frand(1000.0f), .y = frand(600.0f) };
+	}
+	for (size_t i = 0; i < NUM_ROADS; ++i)
+	{
+		size_t a = (size_t)rand() % NUM_POINTS, b = (size_t)rand() % NUM_POINTS;
+		if (a == b)
+		{
+			b = (b + 1) % NUM_POINTS;
+		}
+		lines[i] = (line_t){ .src = &points[a], .dst = &points[b], .cost = 0.5f + frand(4.0f) };
+		line_calc(&lines[i]);
+		roads[i] = &lines[i];
+	}
+
+	roadGrid_t grid;
+	test(roadGrid_init(&grid, roads, NUM_ROADS), "Grid initialization failed!");
+
+	float minCost = INFINITY;
+	for (size_t i = 0; i < NUM_ROADS; ++i)
+	{
+		minCost = fminf(minCost, roads[i]->cost);
+	}
+
+	bool knnOK = true, radiusOK = true, snapOK = true;
+	for (size_t q = 0; q < NUM_QUERIES; ++q)
+	{
+		// Some of the queries are outside the grid
+		const point_t p = { .x = frand(1400.0f) - 200.0f, .y = frand(1000.0f) - 200.0f };
+
+		// Brute-force nearest & weighted nearest
+		size_t nearest = 0, best = 0;
+		float nearestLen2 = INFINITY, bestLen2 = INFINITY;
+		for (size_t i = 0; i < NUM_ROADS; ++i)
+		{
+			const float d2 = dist2(&p, roads[i]);
+			if (d2 < nearestLen2)
+			{
+				nearestLen2 = d2;
+				nearest = i;
+			}
+			if ((d2 * roads[i]->cost) < bestLen2)
+			{
+				bestLen2 = d2 * roads[i]->cost;
+				best = i;
+			}
+		}
+
+		const size_t * res;
+		size_t numRes;
+		roadGrid_kNearest(&grid, roads, &p, 5, &res, &numRes);
+		knnOK &= (numRes == 5) && (res[0] == nearest);
+		for (size_t i = 1; i < numRes; ++i)
+		{
+			knnOK &= dist2(&p, roads[res[i - 1]]) <= dist2(&p, roads[res[i]]);
+		}
+
+		const float radius = 80.0f;
+		size_t expected = 0;
+		for (size_t i = 0; i < NUM_ROADS; ++i)
+		{
+			expected += dist2(&p, roads[i]) <= (radius * radius);
+		}
+		roadGrid_radius(&grid, roads, &p, radius, &res, &numRes);
+		radiusOK &= numRes == expected;
+		for (size_t i = 0; i < numRes; ++i)
+		{
+			radiusOK &= dist2(&p, roads[res[i]]) <= (radius * radius);
+		}
+
+		size_t snapIdx;
+		point_t snapPoint;
+		snapOK &= roadGrid_snap(&grid, roads, &p, minCost, &snapIdx, &snapPoint) && (snapIdx == best);
+	}
+
+	test(knnOK, "k-nearest query differs from brute force!");
+	test(radiusOK, "Radius query differs from brute force!");
+	test(snapOK, "Cost-weighted snapping differs from brute force!");
+
+	roadGrid_destroy(&grid);
+
+	testCollinear();
+
+	return 0;
+}
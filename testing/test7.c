@@ -0,0 +1,60 @@
+#include "test.h"
+#include "../src/unionFind.h"
+
+#define NUM_ELEMS 1000
+#define NUM_EDGES 600
+
+int main(void)
+{
+	setlib("unionFind");
+	srand(4321);
+
+	unionFind_t uf;
+	test(uf_init(&uf, 10), "Initialisation failed!");
+
+	test(!uf_connected(&uf, 0, 1), "Separate elements are connected!");
+	test(uf_union(&uf, 0, 1), "Union of separate sets failed!");
+	test(uf_union(&uf, 2, 3), "Union of separate sets failed!");
+	test(uf_union(&uf, 1, 3), "Union of separate sets failed!");
+	test(!uf_union(&uf, 0, 2), "Union of the same set succeeded!");
+	test(uf_connected(&uf, 0, 3), "Merged elements are not connected!");
+	test(!uf_connected(&uf, 0, 4), "Separate elements are connected!");
+	test(uf.size[uf_find(&uf, 2)] == 4, "Expected set size 4, got %zu", uf.size[uf_find(&uf, 2)]);
+
+	uf_destroy(&uf);
+
+	// Võrdlus naiivse komponentide sildistamisega
+	static size_t label[NUM_ELEMS];
+	for (size_t i = 0; i < NUM_ELEMS; ++i)
+	{
+		label[i] = i;
+	}
+	test(uf_init(&uf, NUM_ELEMS), "Initialisation failed!");
+	for (size_t i = 0; i < NUM_EDGES; ++i)
+	{
+		const size_t a = (size_t)rand() % NUM_ELEMS, b = (size_t)rand() % NUM_ELEMS;
+		uf_union(&uf, a, b);
+
+		const size_t from = label[b], to = label[a];
+		for (size_t j = 0; j < NUM_ELEMS; ++j)
+		{
+			if (label[j] == from)
+			{
+				label[j] = to;
+			}
+		}
+	}
+	bool same = true;
+	for (size_t i = 0; i < NUM_ELEMS && same; ++i)
+	{
+		for (size_t j = i + 1; j < NUM_ELEMS && same; ++j)
+		{
+			same = (label[i] == label[j]) == uf_connected(&uf, i, j);
+		}
+	}
+	test(same, "Components differ from naive labelling!");
+
+	uf_destroy(&uf);
+
+	return 0;
+}
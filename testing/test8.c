@@ -0,0 +1,149 @@
+#include "test.h"
+#include "../src/pathFinding.h"
+
+#include <math.h>
+
+#define NUM_HUBS   40
+#define NUM_CHAINS 70
+#define MAX_CHAIN  6
+#define MAX_POINTS (NUM_HUBS + NUM_CHAINS * MAX_CHAIN)
+#define MAX_ROADS  (NUM_CHAINS * (MAX_CHAIN + 1))
+#define NUM_STOPS  6
+
+static float frand(float max)
+{
+	return ((float)rand() / (float)RAND_MAX) * max;
+}
+
+int main(void)
+{
+	setlib("pathFinding");
+	srand(2024);
+
+	static point_t points[MAX_POINTS];
+	static line_t lines[MAX_ROADS];
+	static line_t * roads[MAX_ROADS];
+	size_t numPoints = 0, numRoads = 0;
+
+	for (size_t i = 0; i < NUM_HUBS; ++i)
+	{
+		points[numPoints] = (point_t){ .x = frand(1000.0f), .y = frand(1000.0f), .idx = numPoints };
+		++numPoints;
+	}
+	// Sõlmpunktide vahel on erineva pikkusega ahelad, mille vahepunktidel on 2 naabrit
+	for (size_t i = 0; i < NUM_CHAINS; ++i)
+	{
+		size_t prev = (size_t)rand() % NUM_HUBS, last = (size_t)rand() % NUM_HUBS;
+		const float cost = 0.5f + frand(2.0f);
+		for (size_t j = 0, n = (size_t)rand() % MAX_CHAIN; j <= n; ++j)
+		{
+			size_t next = last;
+			if (j < n)
+			{
+				points[numPoints] = (point_t){ .x = frand(1000.0f), .y = frand(1000.0f), .idx = numPoints };
+				next = numPoints;
+				++numPoints;
+			}
+			lines[numRoads] = (line_t){ .src = &points[prev], .dst = &points[next], .cost = cost };
+			line_calc(&lines[numRoads]);
+			roads[numRoads] = &lines[numRoads];
+			++numRoads;
+			prev = next;
+		}
+	}
+
+	// Osad peatused on ahelate sees
+	const point_t * stops[NUM_STOPS];
+	for (size_t i = 0; i < NUM_STOPS; ++i)
+	{
+		stops[i] = &points[(i % 2) ? (NUM_HUBS + (size_t)rand() % (numPoints - NUM_HUBS)) : ((size_t)rand() % NUM_HUBS)];
+	}
+
+	roadGraph_t g;
+	test(pf_createGraph(roads, numRoads, stops, NUM_STOPS, &g), "Graph creation failed!");
+	test(g.numNodes < numPoints, "Graph was not compressed, %zu nodes of %zu points", g.numNodes, numPoints);
+	bool stopsOK = true;
+	for (size_t i = 0; i < NUM_STOPS; ++i)
+	{
+		stopsOK &= (g.nodeIdx[stops[i]->idx] != SIZE_MAX) && (g.nodes[g.nodeIdx[stops[i]->idx]] == stops[i]);
+	}
+	test(stopsOK, "Stops are not graph nodes!");
+
+	// Võrdlus naiivse Dijkstraga pakkimata graafil
+	static float weight[MAX_POINTS][MAX_POINTS], ref[MAX_POINTS];
+	static bool done[MAX_POINTS];
+	for (size_t i = 0; i < numPoints; ++i)
+	{
+		for (size_t j = 0; j < numPoints; ++j)
+		{
+			weight[i][j] = INFINITY;
+		}
+	}
+	for (size_t i = 0; i < numRoads; ++i)
+	{
+		const size_t a = roads[i]->src->idx, b = roads[i]->dst->idx;
+		const float w = roads[i]->length * roads[i]->cost;
+		weight[a][b] = fminf(weight[a][b], w);
+		weight[b][a] = fminf(weight[b][a], w);
+	}
+
+	bool distOK = true;
+	prevDist_t * distances = NULL;
+	for (size_t s = 0; s < NUM_STOPS; ++s)
+	{
+		for (size_t i = 0; i < numPoints; ++i)
+		{
+			ref[i]  = INFINITY;
+			done[i] = false;
+		}
+		ref[stops[s]->idx] = 0.0f;
+		for (size_t k = 0; k < numPoints; ++k)
+		{
+			size_t u = SIZE_MAX;
+			for (size_t i = 0; i < numPoints; ++i)
+			{
+				if (!done[i] && ((u == SIZE_MAX) || (ref[i] < ref[u])))
+				{
+					u = i;
+				}
+			}
+			done[u] = true;
+			for (size_t v = 0; v < numPoints; ++v)
+			{
+				ref[v] = fminf(ref[v], ref[u] + weight[u][v]);
+			}
+		}
+
+		test(pf_dijkstraSearch(&g, stops[s], &distances), "Dijkstra search failed!");
+		for (size_t i = 0; i < g.numNodes; ++i)
+		{
+			const float expected = ref[g.nodes[i]->idx], got = distances[i].dist;
+			distOK &= (isinf(expected) && isinf(got)) || (fabsf(expected - got) <= (1e-3f * fmaxf(1.0f, expected)));
+		}
+	}
+	free(distances);
+	test(distOK, "Distances differ from uncompressed graph!");
+
+	// Lahtipakitud rajal on iga järjestikune punktipaar teega ühendatud
+	const size_t order[NUM_STOPS] = { 0, 1, 2, 3, 4, 5 };
+	const point_t ** path = NULL;
+	size_t pathLen = 0;
+	if (pf_generateShortestPath(order, stops, NUM_STOPS, &g, &path, &pathLen))
+	{
+		bool pathOK = (path[0] == stops[0]) && (path[pathLen - 1] == stops[NUM_STOPS - 1]);
+		for (size_t i = 0; (i + 1) < pathLen; ++i)
+		{
+			pathOK &= !isinf(weight[path[i]->idx][path[i + 1]->idx]);
+		}
+		test(pathOK, "Unpacked path is not continuous!");
+		free(path);
+	}
+	else
+	{
+		test(false, "Path generation failed, stops may be disconnected!");
+	}
+
+	pf_destroyGraph(&g);
+
+	return 0;
+}
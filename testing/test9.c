@@ -0,0 +1,85 @@
+#include "test.h"
+#include "../src/arena.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define NUM_ALLOCS 10000
+
+int main(void)
+{
+	setlib("arena");
+
+	arena_t arena;
+	arena_init(&arena, 0);
+	test(arena.head == NULL, "Memory was allocated before first allocation!");
+	test(arena.blockSize == ARENA_MIN_BLOCK, "Block size wasn't rounded up, got %zu", arena.blockSize);
+
+	// Eraldused on joondatud ning ei kattu
+	static unsigned char * ptrs[NUM_ALLOCS];
+	bool aligned = true, intact = true;
+	for (size_t i = 0; i < NUM_ALLOCS; ++i)
+	{
+		const size_t size = 1 + (i % 37);
+		ptrs[i] = arena_alloc(&arena, size);
+		if (ptrs[i] == NULL)
+		{
+			break;
+		}
+		aligned &= ((uintptr_t)ptrs[i] % _Alignof(max_align_t)) == 0;
+		memset(ptrs[i], (int)(i & 0xFF), size);
+	}
+	for (size_t i = 0; i < NUM_ALLOCS && intact; ++i)
+	{
+		const size_t size = 1 + (i % 37);
+		for (size_t j = 0; j < size && intact; ++j)
+		{
+			intact = (ptrs[i] != NULL) && (ptrs[i][j] == (unsigned char)(i & 0xFF));
+		}
+	}
+	test(aligned, "Allocation is not aligned!");
+	test(intact, "Allocations overlap!");
+
+	// Plokkide arv kasvab logaritmiliselt
+	size_t numBlocks = 0;
+	for (const arenaBlock_t * block = arena.head; block != NULL; block = block->next)
+	{
+		++numBlocks;
+	}
+	test(numBlocks > 1 && numBlocks < 16, "Unexpected number of blocks: %zu", numBlocks);
+
+	// Plokist suurem eraldus saab oma ploki
+	void * big = arena_alloc(&arena, ARENA_MIN_BLOCK * 64);
+	test(big != NULL, "Large allocation failed!");
+	test(arena.head->size >= ARENA_MIN_BLOCK * 64, "Large allocation's block too small!");
+
+	arena_destroy(&arena);
+	test(arena.head == NULL, "Arena wasn't emptied!");
+
+	// Pärast vabastamist on areen taas kasutatav
+	test(arena_alloc(&arena, 16) != NULL, "Allocation after destroy failed!");
+
+	// Teise areeni mälu liidetakse, uusim plokk jääb samaks
+	arena_t other;
+	arena_init(&other, 0);
+	char * kept = arena_alloc(&other, 32);
+	test((kept != NULL) && (arena_alloc(&other, ARENA_MIN_BLOCK * 4) != NULL), "Other arena allocation failed!");
+	if (kept != NULL)
+	{
+		strcpy(kept, "merged");
+	}
+	const arenaBlock_t * head = arena.head;
+	arena_merge(&arena, &other);
+	test(other.head == NULL, "Other arena wasn't emptied!");
+	test(arena.head == head, "Newest block changed after merging!");
+	numBlocks = 0;
+	for (const arenaBlock_t * block = arena.head; block != NULL; block = block->next)
+	{
+		++numBlocks;
+	}
+	test(numBlocks == 3, "Merged arena has %zu blocks!", numBlocks);
+	teststr(kept, "merged");
+	arena_destroy(&arena);
+
+	return 0;
+}